@@ -2,6 +2,7 @@
 
 #include <string>
 #include <cstdint>
+#include <optional>
 #include "core/context.h"
 #include "tensor.h"
 
@@ -11,6 +12,13 @@ struct ModelInfo {
     uint32_t context_length = 0;
     uint32_t embedding_dim = 0;
     uint32_t vocab_size = 0;
+    MemoryReport memory;  // logo após o load
+};
+
+// Fase da geração (o backend pode ajustar recursos por fase)
+enum class ExecutionPhase {
+    PREFILL,
+    DECODE
 };
 
 class Backend {
@@ -21,6 +29,33 @@ public:
     virtual ModelInfo load_model(const std::string& model_path) = 0;
     virtual void forward(const TensorView&, TensorView&) = 0;
     virtual BackendStats stats() const = 0;
+
+    // false = o último forward abortou (token inválido, NaN/Inf); a saída
+    // dele não foi escrita e o buffer ainda tem os logits anteriores
+    virtual bool last_forward_ok() const { return true; }
+
+    // Forward com a projeção de saída fundida à seleção: devolve só os k
+    // maiores logits (valor decrescente, empate pelo menor índice) em
+    // values/indices, sem materializar o vetor [n_vocab].
+    // false = não suportado; o chamador usa forward(). true = o forward
+    // rodou: se abortou, last_forward_ok() é false e values/indices não
+    // foram escritos (a posição do KV já avançou, não dá para refazer).
+    virtual bool forward_top_k(const TensorView&, int /*k*/, float* /*values*/, int32_t* /*indices*/) {
+        return false;
+    }
+
+    // Energia acumulada (J) quando o backend tem medidor (leitura do contador).
+    virtual std::optional<double> energy_joules() const { return std::nullopt; }
+
+    // Energia (J) já atribuída ao request corrente, sem ler o medidor:
+    // avança a cada amostra do backend. Para o orçamento por token.
+    virtual std::optional<double> request_energy_joules() const { return std::nullopt; }
+
+    // Limite de batch imposto pelo backend (ex.: governador de potência). 0 = sem limite.
+    virtual int batch_limit() const { return 0; }
+
+    // Chamado pelo generator na transição prefill → decode.
+    virtual void set_phase(ExecutionPhase) {}
 };
 
 } // namespace engine
\ No newline at end of file
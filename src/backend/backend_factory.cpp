@@ -11,7 +11,7 @@ namespace engine {
 
 std::unique_ptr<Backend> BackendFactory::create(const core::ExecutionPlan& plan) {
     if (plan.backend == "cpu") {
-        return std::make_unique<CpuBackend>();
+        return std::make_unique<CpuBackend>(plan);
     }
 
     throw std::runtime_error("Unknown backend: " + plan.backend);
@@ -0,0 +1,129 @@
+#include "backend/cpu/autotuner.h"
+#include "backend/cpu/cpu_backend.h"
+#include "backend/cpu/ops_simd.h"
+#include "core/logger.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace engine {
+
+Autotuner::Autotuner(CpuBackend& backend) : backend_(backend) {
+}
+
+Autotuner::Trial Autotuner::measure(int threads, MatmulKernel kernel, const Options& options) {
+    backend_.set_threads(threads);
+    backend_.set_matmul_kernel(kernel);
+
+    const uint32_t n_vocab = backend_.model_config().n_vocab;
+    std::vector<float> logits(n_vocab);
+
+    // Carga sintética: tokens determinísticos espalhados pelo vocabulário
+    auto run_tokens = [&](int count, int salt) {
+        for (int i = 0; i < count; ++i) {
+            int32_t token = static_cast<int32_t>(
+                (static_cast<uint64_t>(i + salt) * 7919u) % n_vocab
+            );
+
+            TensorView in;
+            in.data = &token;
+            in.shape = {1};
+
+            TensorView out;
+            out.data = logits.data();
+            out.shape = {n_vocab};
+
+            backend_.forward(in, out);
+        }
+    };
+
+    run_tokens(options.warmup_tokens, 0);
+
+    const auto e0 = backend_.energy_joules();
+    const auto t0 = std::chrono::steady_clock::now();
+
+    run_tokens(options.tokens_per_trial, options.warmup_tokens);
+
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto e1 = backend_.energy_joules();
+
+    Trial trial;
+    trial.threads = threads;
+    trial.kernel = kernel;
+
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    if (secs > 0.0) {
+        trial.tokens_per_sec = options.tokens_per_trial / secs;
+    }
+
+    if (e0.has_value() && e1.has_value() && *e1 > *e0) {
+        trial.tokens_per_joule = options.tokens_per_trial / (*e1 - *e0);
+    }
+
+    return trial;
+}
+
+TuningProfile Autotuner::run(const std::string& model_path, const Options& options) {
+    const int max_threads = backend_.max_threads();
+
+    std::vector<int> thread_counts;
+    for (int t : options.thread_counts) {
+        if (t >= 1 && t <= max_threads) thread_counts.push_back(t);
+    }
+    if (thread_counts.empty()) {
+        for (int t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+        thread_counts.push_back(max_threads);
+    }
+
+    std::vector<MatmulKernel> kernels = options.kernels;
+    if (kernels.empty()) {
+        kernels.push_back(MatmulKernel::SCALAR);
+        if (ops::simd::is_avx2_available()) {
+            kernels.push_back(MatmulKernel::SIMD);
+        }
+    }
+
+    trials_.clear();
+
+    for (MatmulKernel kernel : kernels) {
+        for (int threads : thread_counts) {
+            const Trial t = measure(threads, kernel, options);
+            trials_.push_back(t);
+
+            ENGINE_LOG_INFO("tune", "threads=" << t.threads
+                            << " kernel=" << matmul_kernel_name(t.kernel)
+                            << " tokens/s=" << t.tokens_per_sec
+                            << (t.tokens_per_joule > 0.0
+                                    ? " tokens/J=" + std::to_string(t.tokens_per_joule)
+                                    : std::string()));
+        }
+    }
+
+    const bool have_energy = std::any_of(
+        trials_.begin(), trials_.end(),
+        [](const Trial& t) { return t.tokens_per_joule > 0.0; }
+    );
+
+    const auto best = std::max_element(
+        trials_.begin(), trials_.end(),
+        [have_energy](const Trial& a, const Trial& b) {
+            return have_energy ? a.tokens_per_joule < b.tokens_per_joule
+                               : a.tokens_per_sec < b.tokens_per_sec;
+        }
+    );
+
+    TuningProfile profile;
+    profile.host = TuningProfile::current_host();
+    profile.model = TuningProfile::model_id(model_path);
+
+    if (best != trials_.end()) {
+        profile.threads = best->threads;
+        profile.kernel = best->kernel;
+        profile.tokens_per_sec = best->tokens_per_sec;
+        profile.tokens_per_joule = best->tokens_per_joule;
+    }
+
+    return profile;
+}
+
+} // namespace engine
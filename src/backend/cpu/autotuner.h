@@ -0,0 +1,51 @@
+#pragma once
+
+#include "backend/cpu/tuning_profile.h"
+
+#include <string>
+#include <vector>
+
+namespace engine {
+
+class CpuBackend;
+
+/**
+ * Autotuner de tokens/joule para o backend CPU (`engine tune`).
+ *
+ * Varre contagem de threads × variante de kernel com uma carga sintética
+ * de decode (GEMV token a token, o caso memory-bound), mede tokens/s e
+ * tokens/J via PowerLinux e escolhe o melhor ponto:
+ *   - com RAPL: maior tokens/joule
+ *   - sem RAPL: maior tokens/s
+ */
+class Autotuner {
+public:
+    struct Options {
+        std::vector<int> thread_counts;      // vazio = 1, 2, 4, ... até o pool
+        std::vector<MatmulKernel> kernels;   // vazio = todas disponíveis
+        int warmup_tokens = 4;
+        int tokens_per_trial = 32;
+    };
+
+    struct Trial {
+        int threads = 0;
+        MatmulKernel kernel = MatmulKernel::SCALAR;
+        double tokens_per_sec = 0.0;
+        double tokens_per_joule = 0.0;  // 0 = sem medidor de energia
+    };
+
+    explicit Autotuner(CpuBackend& backend);
+
+    // Backend já inicializado e com o modelo carregado.
+    TuningProfile run(const std::string& model_path, const Options& options);
+
+    const std::vector<Trial>& trials() const { return trials_; }
+
+private:
+    CpuBackend& backend_;
+    std::vector<Trial> trials_;
+
+    Trial measure(int threads, MatmulKernel kernel, const Options& options);
+};
+
+} // namespace engine
@@ -1,12 +1,18 @@
 #include "backend/cpu/cpu_backend.h"
 #include "backend/cpu/ops.h"
+#include "backend/cpu/ops_simd.h"
 #include "backend/cpu/quants.h"
 #include "model/gguf_loader.h"
+#include "core/logger.h"
+#include "metrics/profiler.h"
+#include "metrics/metrics_registry.h"
+#include "metrics/memory_usage.h"
 
-#include <iostream>
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstring>
+#include <stdexcept>
 
 namespace engine {
 
@@ -15,16 +21,192 @@ namespace ops {
     void dequantize_auto(float* dst, const void* src, int n, GgmlType type);
 }
 
+namespace {
+
+struct BackendMetrics {
+    Counter& forwards;
+    Histogram& token_interval;
+    Gauge& active_threads;
+    Counter& numerics_checks;
+};
+
+BackendMetrics& backend_metrics() {
+    auto& r = MetricsRegistry::global();
+    static BackendMetrics m{
+        r.counter("engine_backend_forwards", "Forward passes (one token each)", {{"backend", "cpu"}}),
+        r.histogram("engine_backend_token_interval_seconds", "Time between consecutive forward passes",
+                    MetricsRegistry::latency_buckets(), {{"backend", "cpu"}}),
+        r.gauge("engine_backend_active_threads", "Pool threads receiving work", {{"backend", "cpu"}}),
+        r.counter("engine_numerics_checks", "Forward passes with the NaN/Inf check on", {{"backend", "cpu"}}),
+    };
+    return m;
+}
+
+} // namespace
+
 /* ================================================= */
 
 CpuBackend::CpuBackend() = default;
 
+CpuBackend::CpuBackend(const core::ExecutionPlan& plan)
+    : n_threads_(plan.n_threads),
+      power_limits_(plan.power),
+      prefill_threads_(static_cast<int>(plan.prefill_threads)),
+      decode_threads_(static_cast<int>(plan.decode_threads)),
+      numerics_(plan.numerics) {
+}
+
+CpuBackend::~CpuBackend() {
+    if (governor_) governor_->stop();
+    if (energy_) energy_->stop();
+}
 
 /* ================================================= */
 
 void CpuBackend::init() {
-    std::cout << "[cpu] init()\n";
+    ENGINE_LOG_DEBUG("cpu", "init()");
     last_stats_ = BackendStats{};
+
+    pool_ = std::make_unique<ThreadPool>(static_cast<int>(n_threads_));
+
+    // Prefill (compute-bound) usa o pool inteiro; decode (GEMV, memory-bound)
+    // satura a banda com uma fração dos cores. Perfil de tuning pode refinar.
+    decode_explicit_ = decode_threads_ > 0 || n_threads_ > 0;
+    if (prefill_threads_ <= 0) prefill_threads_ = pool_->size();
+    if (decode_threads_ <= 0) {
+        decode_threads_ = n_threads_ > 0 ? pool_->size() : std::max(1, pool_->size() / 2);
+    }
+    prefill_threads_ = std::min(prefill_threads_, pool_->size());
+    decode_threads_ = std::min(decode_threads_, pool_->size());
+    apply_threads();
+
+    ENGINE_LOG_INFO("cpu", "threads: " << pool_->size()
+                    << " (prefill=" << prefill_threads_
+                    << " decode=" << decode_threads_ << ")");
+
+    power_ok_ = power_.init();
+
+    if (power_ok_) {
+        std::string zones;
+        for (const auto& d : power_.domains()) {
+            zones += " " + d.zone + "=" + d.name;
+        }
+        ENGINE_LOG_INFO("cpu", "energy domains:" << zones
+                        << " (total: " << power_.energy_path() << ")");
+
+        energy_ = std::make_unique<EnergySampler>(
+            power_, static_cast<int>(power_limits_.sample_interval_ms)
+        );
+        energy_->start();
+    }
+}
+
+void CpuBackend::set_phase(ExecutionPhase phase) {
+    if (energy_) energy_->set_phase(phase);
+    phase_.store(phase, std::memory_order_relaxed);
+    apply_threads();
+}
+
+void CpuBackend::apply_threads() {
+    if (!pool_) return;
+
+    const int phase_threads = (phase_.load(std::memory_order_relaxed) == ExecutionPhase::DECODE)
+        ? decode_threads_
+        : prefill_threads_;
+    applied_governor_threads_ = governor_threads_.load(std::memory_order_relaxed);
+
+    // Threads fora do alvo ficam estacionadas no pool
+    pool_->set_active_threads(std::min(phase_threads, applied_governor_threads_));
+    backend_metrics().active_threads.set(pool_->active_threads());
+}
+
+void CpuBackend::start_governor() {
+    if (power_limits_.max_watts <= 0.0 || governor_ || !pool_) return;
+
+    if (!power_ok_) {
+        ENGINE_LOG_WARN("cpu", "--max-watts ignored (no powercap/RAPL energy counter)");
+        return;
+    }
+
+    PowerGovernor::Config gc;
+    gc.max_watts = power_limits_.max_watts;
+    gc.min_threads = 1;
+    gc.max_threads = std::max(prefill_threads_, decode_threads_);
+
+    // O governador impõe um teto; cada fase usa min(fase, teto). O callback
+    // roda na thread do governador e só publica: o próximo token aplica.
+    governor_ = std::make_unique<PowerGovernor>(
+        power_, gc,
+        [this](int threads, int batch) {
+            governor_threads_.store(threads, std::memory_order_relaxed);
+            batch_limit_.store(batch, std::memory_order_relaxed);
+        }
+    );
+    governor_->start();
+
+    ENGINE_LOG_INFO("cpu", "power governor: cap=" << gc.max_watts
+                    << " W (" << power_.energy_path() << ")");
+}
+
+void CpuBackend::set_threads(int n) {
+    if (!pool_) return;
+
+    prefill_threads_ = std::clamp(n, 1, pool_->size());
+    decode_threads_ = prefill_threads_;
+    apply_threads();
+}
+
+void CpuBackend::apply_tuning_profile(const std::string& model_path) {
+    const std::string path = TuningProfile::path_for(model_path);
+    const auto profile = TuningProfile::load(path);
+    if (!profile.has_value()) return;
+
+    // Kernel SIMD só se o binário tiver sido compilado com AVX2
+    if (profile->kernel != MatmulKernel::SIMD || ops::simd::is_avx2_available()) {
+        kernel_ = profile->kernel;
+    }
+
+    // O tuner mede decode: o perfil define as threads de decode,
+    // salvo se --threads/--decode-threads foram passados explicitamente
+    if (!decode_explicit_ && pool_) {
+        decode_threads_ = std::clamp(profile->threads, 1, pool_->size());
+        apply_threads();
+    }
+
+    ENGINE_LOG_INFO("cpu", "tuning profile: " << path
+                    << " (decode_threads=" << decode_threads_
+                    << " kernel=" << matmul_kernel_name(kernel_) << ")");
+}
+
+std::optional<double> CpuBackend::energy_joules() const {
+    if (!power_ok_) return std::nullopt;
+    return power_.read_joules();
+}
+
+std::optional<double> CpuBackend::request_energy_joules() const {
+    if (!energy_) return std::nullopt;
+    return energy_->attributed_joules(request_id_);
+}
+
+int CpuBackend::batch_limit() const {
+    return batch_limit_.load(std::memory_order_relaxed);
+}
+
+void CpuBackend::matmul(const float* A, const float* B, float* C, int M, int N, int K) {
+    const auto kernel = (kernel_ == MatmulKernel::SIMD)
+        ? &ops::simd::matmul_f32_range_simd
+        : &ops::matmul_f32_range;
+
+    if (!pool_) {
+        kernel(A, B, C, M, N, K, 0, N);
+        return;
+    }
+
+    pool_->parallel_for(N, [&](int begin, int end, int) {
+        ENGINE_PROFILE_SCOPE(MATMUL_CHUNK, -1);
+        PerfCounters::attach_current_thread();
+        kernel(A, B, C, M, N, K, begin, end);
+    }, 64);
 }
 
 
@@ -35,11 +217,11 @@ void CpuBackend::init() {
 
 ModelInfo CpuBackend::load_model(const std::string& path) {
 
-    std::cout << "[cpu] loading model: " << path << "\n";
+    ENGINE_LOG_INFO("cpu", "loading model: " << path);
 
     model_ = GgufLoader::load(path);
 
-    std::cout << "[cpu] " << model_.summary() << "\n";
+    ENGINE_LOG_INFO("cpu", model_.summary());
 
     /* ---- Config ---- */
 
@@ -51,13 +233,13 @@ ModelInfo CpuBackend::load_model(const std::string& path) {
     config_.n_heads     = model_.n_heads();
     config_.n_kv_heads  = model_.n_kv_heads();
 
-    std::cout << "[cpu] config: "
-          << "vocab=" << config_.n_vocab
-          << " ctx=" << config_.n_ctx
-          << " emb=" << config_.n_embd
-          << " layers=" << config_.n_layers
-          << " heads=" << config_.n_heads
-          << " kv_heads=" << config_.n_kv_heads << "\n";
+    ENGINE_LOG_INFO("cpu", "config: "
+                    << "vocab=" << config_.n_vocab
+                    << " ctx=" << config_.n_ctx
+                    << " emb=" << config_.n_embd
+                    << " layers=" << config_.n_layers
+                    << " heads=" << config_.n_heads
+                    << " kv_heads=" << config_.n_kv_heads);
 
     /* ---- Extract raw weights ---- */
 
@@ -66,6 +248,7 @@ ModelInfo CpuBackend::load_model(const std::string& path) {
     /* ---- Dequant ---- */
 
     dequantize_weights();
+    compute_region_bytes();
 
     /* ---- Buffers ---- */
 
@@ -83,30 +266,100 @@ ModelInfo CpuBackend::load_model(const std::string& path) {
 
     /* ---- Tokenizer e Sampler ---- */
 
-    std::cout << "[cpu] initializing tokenizer...\n";
+    ENGINE_LOG_DEBUG("cpu", "initializing tokenizer...");
     tokenizer_ = std::make_unique<SimpleTokenizer>();
     if (!tokenizer_->load_from_gguf(path)) {
-        std::cerr << "[cpu] WARNING: tokenizer failed to load\n";
+        ENGINE_LOG_WARN("cpu", "tokenizer failed to load");
     }
 
-    std::cout << "[cpu] initializing sampler...\n";
+    ENGINE_LOG_DEBUG("cpu", "initializing sampler...");
     sampler_ = std::make_unique<Sampler>();
 
-    std::cout << "[cpu] model loaded successfully\n";
+    /* ---- Perfil de tuning + power cap ---- */
+
+    apply_tuning_profile(path);
+    start_governor();
+
+    reset_run_stats();
+
+    ENGINE_LOG_INFO("cpu", "model loaded successfully");
+
+    const MemoryReport mem = memory_report();
+    publish_memory(mem);
+
+    constexpr double MiB = 1024.0 * 1024.0;
+    ENGINE_LOG_INFO("cpu", "memory (MiB): weights mapped=" << mem.weights_mapped / MiB
+                    << " resident=" << mem.weights_resident / MiB
+                    << " dequant=" << mem.dequant / MiB
+                    << " kv_cache=" << mem.kv_cache / MiB
+                    << " scratch=" << mem.scratch / MiB
+                    << " | rss=" << mem.rss / MiB);
 
     return ModelInfo{
         .context_length = config_.n_ctx,
         .embedding_dim  = config_.n_embd,
-        .vocab_size     = config_.n_vocab
+        .vocab_size     = config_.n_vocab,
+        .memory         = mem
     };
 }
 
+/* ================================================= */
+/* MEMORY */
+/* ================================================= */
+
+MemoryReport CpuBackend::memory_report() const {
+    MemoryReport m;
+
+    auto bytes = [](const std::vector<float>& v) {
+        return static_cast<uint64_t>(v.capacity() * sizeof(float));
+    };
+
+    m.weights_mapped = model_.file_size();
+    m.weights_resident = resident_bytes(model_.file_base(), model_.file_size());
+
+    m.dequant = bytes(token_embd_dequant_) + bytes(output_norm_dequant_) + bytes(output_dequant_);
+    for (const auto& L : layers_) {
+        m.dequant += bytes(L.attn_norm_dequant) + bytes(L.ffn_norm_dequant)
+                   + bytes(L.wq_dequant) + bytes(L.wk_dequant) + bytes(L.wv_dequant)
+                   + bytes(L.wo_dequant) + bytes(L.w1_dequant) + bytes(L.w2_dequant)
+                   + bytes(L.w3_dequant);
+    }
+
+    m.kv_cache = bytes(k_cache_) + bytes(v_cache_);
+
+    // Buffers fixos + temporários de um layer (residual, Q/K/V, saída da
+    // atenção e gate/up da FFN com 4·n_embd), alocados a cada chamada
+    const uint64_t per_layer = uint64_t(config_.n_embd) * (1 + 4 + 2 * 4) * sizeof(float);
+    m.scratch = bytes(embed_buf_) + bytes(hidden_buf_) + bytes(logits_buf_) + bytes(head_chunk_) + per_layer;
+
+    const ProcessMemory p = read_process_memory();
+    m.rss = p.rss_bytes;
+    m.peak_rss = p.peak_rss_bytes;
+    return m;
+}
+
+void CpuBackend::publish_memory(const MemoryReport& m) const {
+    auto& r = MetricsRegistry::global();
+    auto set = [&r](const char* component, uint64_t v) {
+        r.gauge("engine_memory_bytes", "Backend memory by component",
+                {{"backend", "cpu"}, {"component", component}}).set(static_cast<double>(v));
+    };
+
+    set("weights_mapped", m.weights_mapped);
+    set("weights_resident", m.weights_resident);
+    set("dequant", m.dequant);
+    set("kv_cache", m.kv_cache);
+    set("scratch", m.scratch);
+    set("rss", m.rss);
+    set("peak_rss", m.peak_rss);
+}
+
 /* ================================================= */
 /* DEQUANT */
 /* ================================================= */
 
 void CpuBackend::dequantize_weights() {
-    std::cout << "[cpu] dequantizing weights...\n";
+    ENGINE_LOG_DEBUG("cpu", "dequantizing weights...");
 
     auto dq = [&](const std::string& name,
                   const float*& w,
@@ -115,7 +368,7 @@ void CpuBackend::dequantize_weights() {
 
         const auto* info = model_.tensor_info(name);
         if (!info) {
-            std::cerr << "[cpu] WARNING: tensor not found: " << name << "\n";
+            ENGINE_LOG_WARN("cpu", "tensor not found: " << name);
             return;
         }
 
@@ -139,13 +392,13 @@ void CpuBackend::dequantize_weights() {
     // token embd
     dq("token_embd.weight", token_embd_weight_, token_embd_dequant_);
     if (token_embd_weight_) {
-        std::cout << "[cpu] token_embd ok\n";
+        ENGINE_LOG_DEBUG("cpu", "token_embd ok");
     }
 
     // output norm
     dq("output_norm.weight", output_norm_weight_, output_norm_dequant_);
     if (output_norm_weight_) {
-        std::cout << "[cpu] output_norm ok\n";
+        ENGINE_LOG_DEBUG("cpu", "output_norm ok");
     }
 
     // output weight (output.weight ou lm_head.weight)
@@ -153,7 +406,7 @@ void CpuBackend::dequantize_weights() {
         model_.tensor_ptr("output.weight") ? "output.weight" : "lm_head.weight";
 
     dq(out_name, output_weight_, output_dequant_);
-    std::cout << "[cpu] output weight ok (" << out_name << ")\n";
+    ENGINE_LOG_DEBUG("cpu", "output weight ok (" << out_name << ")");
 
     // layers
     for (uint32_t i = 0; i < config_.n_layers; ++i) {
@@ -172,8 +425,34 @@ void CpuBackend::dequantize_weights() {
         dq(p + "ffn_up.weight",      L.w3,              L.w3_dequant);
     }
 
-    std::cout << "[cpu] dequant done\n";
+    ENGINE_LOG_DEBUG("cpu", "dequant done");
+}
+// Bytes que um token de decode lê de pesos, por região (roofline).
+// Os kernels leem a cópia F32 (dequant no load), não o GGUF quantizado.
+void CpuBackend::compute_region_bytes() {
+    region_bytes_.assign(config_.n_layers + 1, RegionBytes{});
+
+    auto add = [this](size_t region, const std::string& name) {
+        const auto* info = model_.tensor_info(name);
+        if (!info) return;
+        region_bytes_[region].gguf += info->nbytes();
+        region_bytes_[region].streamed += info->numel() * sizeof(float);
+    };
+
+    static const char* layer_tensors[] = {
+        "attn_norm.weight", "attn_q.weight", "attn_k.weight", "attn_v.weight",
+        "attn_output.weight", "ffn_norm.weight", "ffn_gate.weight",
+        "ffn_down.weight", "ffn_up.weight",
+    };
+
+    for (uint32_t i = 0; i < config_.n_layers; ++i) {
+        const std::string p = "blk." + std::to_string(i) + ".";
+        for (const char* t : layer_tensors) add(i, p + t);
+    }
+
+    add(config_.n_layers, model_.tensor_ptr("output.weight") ? "output.weight" : "lm_head.weight");
 }
+
 /* ================================================= */
 /* EXTRACT */
 /* ================================================= */
@@ -218,7 +497,7 @@ void CpuBackend::extract_weights() {
         L.w3 = (const float*)model_.tensor_ptr(p + "ffn_up.weight");
     }
 
-    std::cout << "[cpu] weights extracted\n";
+    ENGINE_LOG_DEBUG("cpu", "weights extracted");
 }
 
 /* ================================================= */
@@ -227,112 +506,296 @@ void CpuBackend::extract_weights() {
 // Adicione no forward() do cpu_backend.cpp:
 
 void CpuBackend::forward(const TensorView& in, TensorView& out) {
-    int32_t token_id = *static_cast<const int32_t*>(in.data);
+    ENGINE_PROFILE_SCOPE(FORWARD, -1);
+
     float* logits = static_cast<float*>(out.data);
 
-    std::cout << "[forward] START token_id=" << token_id << "\n";
+    last_forward_ok_ = false;
+    if (!forward_hidden(in)) return;
 
-    if (token_id < 0 || static_cast<uint32_t>(token_id) >= config_.n_vocab) {
-        std::cerr << "[forward] ERROR: token_id out of range!\n";
+    // 4. Output projection
+    if (output_weight_) {
+        ENGINE_LOG_TRACE("forward", "applying output projection...");
+
+        const bool perf = region_timing_ || PerfCounters::enabled();
+        PerfSample perf_before;
+        uint64_t perf_t0 = 0;
+
+        if (perf) {
+            perf_before = PerfCounters::read_all();
+            perf_t0 = Profiler::now_ns();
+        }
+
+        {
+            ENGINE_PROFILE_SCOPE(OUTPUT_PROJ, -1);
+            matmul(
+                hidden_buf_.data(),
+                output_weight_,
+                logits,
+                1, config_.n_vocab, config_.n_embd
+            );
+        }
+
+        if (perf) record_perf(config_.n_layers, perf_before, perf_t0);
+
+        ENGINE_LOG_TRACE("forward", "after matmul: logits[0]=" << logits[0]
+                         << " logits[n-1]=" << logits[config_.n_vocab - 1]);
+
+        if (!check_finite(logits, config_.n_vocab, ProfOp::OUTPUT_PROJ, -1)) return;
+    } else {
+        ENGINE_LOG_ERROR("forward", "output_weight_ is NULL");
         return;
     }
 
+    last_forward_ok_ = true;
+    account_token();
+
+    ENGINE_LOG_TRACE("forward", "DONE");
+}
+
+bool CpuBackend::forward_top_k(const TensorView& in, int k, float* values, int32_t* indices) {
+    if (!output_weight_ || k <= 0 || static_cast<uint32_t>(k) > config_.n_vocab) {
+        return false;
+    }
+
+    ENGINE_PROFILE_SCOPE(FORWARD, -1);
+
+    last_forward_ok_ = false;
+    if (forward_hidden(in) && output_top_k(k)) {
+        for (int i = 0; i < k; ++i) {
+            values[i] = head_best_[i].val;
+            indices[i] = head_best_[i].idx;
+        }
+        last_forward_ok_ = true;
+        account_token();
+    }
+
+    return true;
+}
+
+bool CpuBackend::forward_hidden(const TensorView& in) {
+    int32_t token_id = *static_cast<const int32_t*>(in.data);
+
+    ENGINE_LOG_TRACE("forward", "START token_id=" << token_id);
+
+    if (token_id < 0 || static_cast<uint32_t>(token_id) >= config_.n_vocab) {
+        ENGINE_LOG_ERROR("forward", "token_id out of range: " << token_id);
+        return false;
+    }
+
+    switch (numerics_.mode) {
+        case core::NumericsCheckMode::OFF:     check_numerics_ = false; break;
+        case core::NumericsCheckMode::ALWAYS:  check_numerics_ = true; break;
+        case core::NumericsCheckMode::EVERY_N:
+            check_numerics_ = forward_count_ % std::max<uint32_t>(1, numerics_.interval) == 0;
+            break;
+    }
+    ++forward_count_;
+    if (check_numerics_) backend_metrics().numerics_checks.inc();
+
     // 1. Embedding
     if (token_embd_weight_) {
         const float* emb = token_embd_weight_ + (token_id * config_.n_embd);
-        ops::copy_f32(hidden_buf_.data(), emb, config_.n_embd);
+        {
+            ENGINE_PROFILE_SCOPE(EMBEDDING, -1);
+            ops::copy_f32(hidden_buf_.data(), emb, config_.n_embd);
+        }
 
-        std::cout << "[forward] after embedding: hidden[0]=" << hidden_buf_[0]
-                  << " hidden[100]=" << hidden_buf_[100] << "\n";
+        ENGINE_LOG_TRACE("forward", "after embedding: hidden[0]=" << hidden_buf_[0]
+                         << " hidden[n-1]=" << hidden_buf_.back());
 
-        if (std::isnan(hidden_buf_[0]) || std::isinf(hidden_buf_[0])) {
-            std::cerr << "[ERROR] NaN/Inf AFTER EMBEDDING!\n";
-            std::cerr << "[DEBUG] token_embd_weight_[0]=" << token_embd_weight_[0] << "\n";
-            std::cerr << "[DEBUG] emb[0]=" << emb[0] << "\n";
-            return;
-        }
+        if (!check_finite(hidden_buf_.data(), config_.n_embd, ProfOp::EMBEDDING, -1)) return false;
     } else {
-        std::cerr << "[ERROR] token_embd_weight_ is NULL!\n";
-        return;
+        ENGINE_LOG_ERROR("forward", "token_embd_weight_ is NULL");
+        return false;
     }
 
     // 2. Layers
-    std::cout << "[forward] processing " << config_.n_layers << " layers...\n";
+    ENGINE_LOG_TRACE("forward", "processing " << config_.n_layers << " layers...");
 
-    for (uint32_t i = 0; i < config_.n_layers; ++i) {
-        forward_layer(i, hidden_buf_.data(), 1);
+    const bool perf = region_timing_ || PerfCounters::enabled();
+    PerfSample perf_before;
+    uint64_t perf_t0 = 0;
 
-        // Check após cada layer
-        if (std::isnan(hidden_buf_[0]) || std::isinf(hidden_buf_[0])) {
-            std::cerr << "[ERROR] NaN/Inf AFTER LAYER " << i << "!\n";
-            std::cerr << "[DEBUG] hidden[0]=" << hidden_buf_[0] << "\n";
-            std::cerr << "[DEBUG] hidden[10]=" << hidden_buf_[10] << "\n";
-            return;
+    for (uint32_t i = 0; i < config_.n_layers; ++i) {
+        if (perf) {
+            perf_before = PerfCounters::read_all();
+            perf_t0 = Profiler::now_ns();
         }
 
+        const bool ok = forward_layer(i, hidden_buf_.data(), 1);
+
+        if (perf) record_perf(i, perf_before, perf_t0);
+        if (!ok) return false;
+
         if (i == 0 || i == config_.n_layers - 1) {
-            std::cout << "[forward] after layer " << i << ": hidden[0]="
-                      << hidden_buf_[0] << "\n";
+            ENGINE_LOG_TRACE("forward", "after layer " << i << ": hidden[0]=" << hidden_buf_[0]);
         }
     }
 
-    std::cout << "[forward] layers done\n";
+    ENGINE_LOG_TRACE("forward", "layers done");
 
     // 3. Output norm
     if (output_norm_weight_) {
-        std::cout << "[forward] applying output_norm...\n";
-
-        ops::rms_norm_f32(
-            hidden_buf_.data(),
-            hidden_buf_.data(),
-            output_norm_weight_,
-            config_.n_embd,
-            1e-5f
-        );
+        ENGINE_LOG_TRACE("forward", "applying output_norm...");
+
+        {
+            ENGINE_PROFILE_SCOPE(OUTPUT_NORM, -1);
+            ops::rms_norm_f32(
+                hidden_buf_.data(),
+                hidden_buf_.data(),
+                output_norm_weight_,
+                config_.n_embd,
+                1e-5f
+            );
+        }
 
-        std::cout << "[forward] after output_norm: hidden[0]=" << hidden_buf_[0] << "\n";
+        ENGINE_LOG_TRACE("forward", "after output_norm: hidden[0]=" << hidden_buf_[0]);
 
-        if (std::isnan(hidden_buf_[0]) || std::isinf(hidden_buf_[0])) {
-            std::cerr << "[ERROR] NaN/Inf AFTER OUTPUT_NORM!\n";
-            std::cerr << "[DEBUG] output_norm_weight_[0]=" << output_norm_weight_[0] << "\n";
-            return;
-        }
+        if (!check_finite(hidden_buf_.data(), config_.n_embd, ProfOp::OUTPUT_NORM, -1)) return false;
     } else {
-        std::cout << "[forward] WARNING: output_norm_weight_ is NULL, skipping\n";
+        ENGINE_LOG_TRACE("forward", "output_norm_weight_ is NULL, skipping");
     }
 
-    // 4. Output projection
-    if (output_weight_) {
-        std::cout << "[forward] applying output projection...\n";
+    return true;
+}
 
-        ops::matmul_f32(
-            hidden_buf_.data(),
-            output_weight_,
-            logits,
-            1, config_.n_vocab, config_.n_embd
-        );
+/* ================================================= */
+/* LM HEAD FUNDIDO */
+/* ================================================= */
 
-        std::cout << "[forward] after matmul: logits[0]=" << logits[0]
-                  << " logits[100]=" << logits[100] << "\n";
+// Cada thread projeta um intervalo do vocabulário em blocos de HEAD_CHUNK
+// (o bloco fica no L1) e mantém o seu top-k; o vetor inteiro de logits nunca
+// é escrito. Os logits saem do mesmo kernel do matmul, então o resultado é
+// idêntico a forward() + top_k_f32.
+bool CpuBackend::output_top_k(int k) {
+    using ops::simd::ScoredToken;
+
+    const int n_vocab = static_cast<int>(config_.n_vocab);
+    const int n_embd = static_cast<int>(config_.n_embd);
+    const int threads = max_threads();
+
+    head_chunk_.resize(static_cast<size_t>(threads) * HEAD_CHUNK);
+    head_best_.resize(static_cast<size_t>(threads) * k);
+    head_tmp_.resize(static_cast<size_t>(threads) * 3 * k);
+    head_count_.assign(threads, 0);
+    head_bad_.assign(threads, -1);
+
+    const auto kernel = (kernel_ == MatmulKernel::SIMD)
+        ? &ops::simd::matmul_f32_range_simd
+        : &ops::matmul_f32_range;
+
+    auto before = [](const ScoredToken& a, const ScoredToken& b) {
+        return a.val > b.val || (a.val == b.val && a.idx < b.idx);
+    };
 
-        if (std::isnan(logits[0]) || std::isinf(logits[0])) {
-            std::cerr << "[ERROR] NaN/Inf AFTER OUTPUT PROJECTION!\n";
-            std::cerr << "[DEBUG] hidden[0]=" << hidden_buf_[0] << "\n";
-            std::cerr << "[DEBUG] output_weight_[0]=" << output_weight_[0] << "\n";
-            return;
+    const bool perf = region_timing_ || PerfCounters::enabled();
+    PerfSample perf_before;
+    uint64_t perf_t0 = 0;
+
+    if (perf) {
+        perf_before = PerfCounters::read_all();
+        perf_t0 = Profiler::now_ns();
+    }
+
+    {
+        ENGINE_PROFILE_SCOPE(OUTPUT_PROJ, -1);
+
+        auto run = [&](int begin, int end, int tid) {
+            ENGINE_PROFILE_SCOPE(MATMUL_CHUNK, -1);
+            PerfCounters::attach_current_thread();
+
+            float* chunk = head_chunk_.data() + static_cast<size_t>(tid) * HEAD_CHUNK;
+            ScoredToken* best = head_best_.data() + static_cast<size_t>(tid) * k;
+            ScoredToken* tmp = head_tmp_.data() + static_cast<size_t>(tid) * 3 * k;
+            int& count = head_count_[tid];
+
+            for (int c = begin; c < end; c += HEAD_CHUNK) {
+                const int len = std::min(HEAD_CHUNK, end - c);
+                kernel(hidden_buf_.data(), output_weight_ + static_cast<size_t>(c) * n_embd,
+                       chunk, 1, len, n_embd, 0, len);
+
+                if (check_numerics_ && head_bad_[tid] < 0) {
+                    const int bad = ops::simd::find_non_finite_f32(chunk, len);
+                    if (bad >= 0) head_bad_[tid] = c + bad;
+                }
+
+                // Top-k do bloco, mesclado com o corrente (ambos ordenados)
+                ScoredToken* local = tmp + 2 * k;
+                const int m = ops::simd::top_k_f32(chunk, len, std::min(k, len), local);
+                for (int i = 0; i < m; ++i) local[i].idx += c;
+
+                const int merged = std::min(k, count + m);
+                std::merge(best, best + count, local, local + m, tmp, before);
+                std::copy(tmp, tmp + merged, best);
+                count = merged;
+            }
+        };
+
+        if (pool_) {
+            pool_->parallel_for(n_vocab, run, HEAD_CHUNK);
+        } else {
+            run(0, n_vocab, 0);
+        }
+
+        // Mescla entre threads: o top-k global fica no início de head_best_
+        int total = 0;
+        for (int t = 0; t < threads; ++t) {
+            std::copy_n(head_best_.begin() + static_cast<size_t>(t) * k, head_count_[t],
+                        head_tmp_.begin() + total);
+            total += head_count_[t];
+        }
+        std::partial_sort(head_tmp_.begin(), head_tmp_.begin() + k, head_tmp_.begin() + total, before);
+        std::copy_n(head_tmp_.begin(), k, head_best_.begin());
+    }
+
+    if (perf) record_perf(config_.n_layers, perf_before, perf_t0);
+
+    for (int t = 0; t < threads; ++t) {
+        if (head_bad_[t] >= 0) {
+            // Recalcula o logit para o relatório (o bloco já foi descartado)
+            const int idx = head_bad_[t];
+            float value = 0.0f;
+            kernel(hidden_buf_.data(), output_weight_ + static_cast<size_t>(idx) * n_embd,
+                   &value, 1, 1, n_embd, 0, 1);
+            report_non_finite(ProfOp::OUTPUT_PROJ, -1, idx, value);
+            return false;
         }
-    } else {
-        std::cerr << "[ERROR] output_weight_ is NULL!\n";
-        return;
     }
 
-    std::cout << "[forward] DONE\n";
+    ENGINE_LOG_TRACE("forward", "fused head: top[0]=" << head_best_[0].idx << " (" << head_best_[0].val << ")");
+    return true;
 }
+
 /* ================================================= */
 /* LAYER */
 /* ================================================= */
 
-void CpuBackend::forward_layer(int layer_idx, float* hidden, int seq_len) {
+// Para no primeiro ponto não finito: o resto do forward só propagaria o NaN
+bool CpuBackend::check_finite(const float* x, uint32_t n, ProfOp op, int layer) {
+    if (!check_numerics_) return true;
+
+    const int bad = ops::simd::find_non_finite_f32(x, static_cast<int>(n));
+    if (bad < 0) return true;
+
+    report_non_finite(op, layer, bad, x[bad]);
+    return false;
+}
+
+void CpuBackend::report_non_finite(ProfOp op, int layer, int index, float value) {
+    MetricsRegistry::global().counter(
+        "engine_numerics_nonfinite",
+        "Forward passes stopped at the first NaN/Inf, by op and layer",
+        {{"backend", "cpu"}, {"op", prof_op_name(op)}, {"layer", std::to_string(layer)}}
+    ).inc();
+
+    ENGINE_LOG_ERROR("forward", "NaN/Inf after " << prof_op_name(op)
+                     << (layer >= 0 ? " layer " + std::to_string(layer) : std::string())
+                     << " at [" << index << "]=" << value
+                     << " (forward #" << (forward_count_ - 1) << ")");
+}
+
+bool CpuBackend::forward_layer(int layer_idx, float* hidden, int seq_len) {
     const int n = static_cast<int>(config_.n_embd);
     const auto& L = layers_[layer_idx];
 
@@ -340,14 +803,23 @@ void CpuBackend::forward_layer(int layer_idx, float* hidden, int seq_len) {
     std::vector<float> residual(n);
     ops::copy_f32(residual.data(), hidden, n);
 
-    forward_attention(L, hidden, seq_len);
-    ops::add_f32(hidden, residual.data(), n);
+    forward_attention(layer_idx, L, hidden, seq_len);
+    if (!check_finite(hidden, config_.n_embd, ProfOp::ATTN_OUT_PROJ, layer_idx)) return false;
+    {
+        ENGINE_PROFILE_SCOPE(RESIDUAL, layer_idx);
+        ops::add_f32(hidden, residual.data(), n);
 
-    // Residual 2
-    ops::copy_f32(residual.data(), hidden, n);
+        // Residual 2
+        ops::copy_f32(residual.data(), hidden, n);
+    }
 
-    forward_ffn(L, hidden, seq_len);
-    ops::add_f32(hidden, residual.data(), n);
+    forward_ffn(layer_idx, L, hidden, seq_len);
+    if (!check_finite(hidden, config_.n_embd, ProfOp::FFN_DOWN, layer_idx)) return false;
+    {
+        ENGINE_PROFILE_SCOPE(RESIDUAL, layer_idx);
+        ops::add_f32(hidden, residual.data(), n);
+    }
+    return true;
 }
 
 /* ================================================= */
@@ -355,12 +827,14 @@ void CpuBackend::forward_layer(int layer_idx, float* hidden, int seq_len) {
 /* ================================================= */
 
 void CpuBackend::forward_attention(
+    int layer_idx,
     const TransformerLayer& L,
     float* hidden,
     int seq_len
 ) {
 
     if (L.attn_norm_weight) {
+        ENGINE_PROFILE_SCOPE(RMS_NORM, layer_idx);
         ops::rms_norm_f32(
             hidden, hidden,
             L.attn_norm_weight,
@@ -372,24 +846,32 @@ void CpuBackend::forward_attention(
     std::vector<float> K(config_.n_embd);
     std::vector<float> V(config_.n_embd);
 
-    ops::matmul_f32(hidden, L.wq, Q.data(),
-                   seq_len, config_.n_embd, config_.n_embd);
+    {
+        ENGINE_PROFILE_SCOPE(QKV_PROJ, layer_idx);
 
-    ops::matmul_f32(hidden, L.wk, K.data(),
-                   seq_len, config_.n_embd, config_.n_embd);
+        matmul(hidden, L.wq, Q.data(),
+               seq_len, config_.n_embd, config_.n_embd);
 
-    ops::matmul_f32(hidden, L.wv, V.data(),
-                   seq_len, config_.n_embd, config_.n_embd);
+        matmul(hidden, L.wk, K.data(),
+               seq_len, config_.n_embd, config_.n_embd);
+
+        matmul(hidden, L.wv, V.data(),
+               seq_len, config_.n_embd, config_.n_embd);
+    }
 
     std::vector<float> out(config_.n_embd);
 
-    ops::attention_f32(
-        out.data(),
-        Q.data(), K.data(), V.data(),
-        seq_len, config_.n_embd
-    );
+    {
+        ENGINE_PROFILE_SCOPE(ATTENTION, layer_idx);
+        ops::attention_f32(
+            out.data(),
+            Q.data(), K.data(), V.data(),
+            seq_len, config_.n_embd
+        );
+    }
 
-    ops::matmul_f32(
+    ENGINE_PROFILE_SCOPE(ATTN_OUT_PROJ, layer_idx);
+    matmul(
         out.data(), L.wo, hidden,
         seq_len, config_.n_embd, config_.n_embd
     );
@@ -400,12 +882,14 @@ void CpuBackend::forward_attention(
 /* ================================================= */
 
 void CpuBackend::forward_ffn(
+    int layer_idx,
     const TransformerLayer& L,
     float* hidden,
     int seq_len
 ) {
 
     if (L.ffn_norm_weight) {
+        ENGINE_PROFILE_SCOPE(RMS_NORM, layer_idx);
         ops::rms_norm_f32(
             hidden, hidden,
             L.ffn_norm_weight,
@@ -418,17 +902,24 @@ void CpuBackend::forward_ffn(
     std::vector<float> gate(ffn_dim);
     std::vector<float> up(ffn_dim);
 
-    ops::matmul_f32(hidden, L.w1, gate.data(),
-                   seq_len, ffn_dim, config_.n_embd);
+    {
+        ENGINE_PROFILE_SCOPE(FFN_UP_GATE, layer_idx);
 
-    ops::silu_f32(gate.data(), ffn_dim);
+        matmul(hidden, L.w1, gate.data(),
+               seq_len, ffn_dim, config_.n_embd);
 
-    ops::matmul_f32(hidden, L.w3, up.data(),
-                   seq_len, ffn_dim, config_.n_embd);
+        matmul(hidden, L.w3, up.data(),
+               seq_len, ffn_dim, config_.n_embd);
+    }
 
-    ops::mul_f32(gate.data(), gate.data(), up.data(), ffn_dim);
+    {
+        ENGINE_PROFILE_SCOPE(FFN_ACT, layer_idx);
+        ops::silu_f32(gate.data(), ffn_dim);
+        ops::mul_f32(gate.data(), gate.data(), up.data(), ffn_dim);
+    }
 
-    ops::matmul_f32(
+    ENGINE_PROFILE_SCOPE(FFN_DOWN, layer_idx);
+    matmul(
         gate.data(), L.w2, hidden,
         seq_len, config_.n_embd, ffn_dim
     );
@@ -438,161 +929,148 @@ void CpuBackend::forward_ffn(
 /* STATS */
 /* ================================================= */
 
-BackendStats CpuBackend::stats() const {
-
-    BackendStats s = last_stats_;
-
-    if (s.exec_time_ms > 0) {
-        s.tokens_per_sec =
-            (s.tokens_total * 1000.0) / s.exec_time_ms;
-    }
+void CpuBackend::reset_run_stats() {
+    // Fecha a conta do run anterior; energia até aqui não vai para o novo
+    if (energy_) energy_->finish_request(request_id_);
+    ++request_id_;
 
-    return s;
+    last_stats_ = BackendStats{};
+    itl_ns_.reset();
+    reset_peak_rss();  // o pico em stats() passa a ser o deste run
+    perf_regions_.assign(config_.n_layers + 1, PerfSample{});
+    run_start_ = std::chrono::steady_clock::now();
+    last_token_time_ = {};
 }
 
-std::string CpuBackend::generate(
-    const std::string& prompt,
-    int max_tokens,
-    const SamplingConfig& sampling
-) {
-    std::cout << "[cpu] generating from prompt: \"" << prompt << "\"\n";
-    std::cout << std::flush;  // ← FORÇAR OUTPUT
-
-    // 1. Tokeniza
-    std::cout << "[debug] tokenizing..." << std::endl;
-    auto tokens = tokenizer_->encode(prompt);
-    std::cout << "[debug] got " << tokens.size() << " tokens: ";
-    for (auto t : tokens) std::cout << t << " ";
-    std::cout << std::endl;
+// Cada forward bem-sucedido conta como um token do run loop (engine run).
+// Em generate(), os números são substituídos pelos do generator ao final.
+void CpuBackend::account_token() {
+    const auto now = std::chrono::steady_clock::now();
 
-    if (tokens.empty()) {
-        std::cerr << "[error] tokenization returned empty!\n";
-        return "";
+    if (last_token_time_ == std::chrono::steady_clock::time_point{}) {
+        last_stats_.ttft_ms =
+            std::chrono::duration<double, std::milli>(now - run_start_).count();
+    } else {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_token_time_).count();
+        itl_ns_.record(static_cast<uint64_t>(ns));
+        backend_metrics().token_interval.observe(static_cast<double>(ns) / 1e9);
     }
 
-    // 2. Prefill
-    std::cout << "[debug] prefill starting..." << std::endl;
-    for (size_t i = 0; i < tokens.size(); ++i) {
-        std::cout << "[prefill] " << (i+1) << "/" << tokens.size() << std::endl;
-
-        TensorView in_view;
-        in_view.data = &tokens[i];
+    backend_metrics().forwards.inc();
 
-        TensorView out_view;
-        out_view.data = logits_buf_.data();
-
-        forward(in_view, out_view);
+    last_token_time_ = now;
+    ++last_stats_.tokens_total;
+    if (energy_) energy_->add_tokens(request_id_);
+    if (governor_threads_.load(std::memory_order_relaxed) != applied_governor_threads_) {
+        apply_threads();
     }
-    std::cout << "[debug] prefill done" << std::endl;
+    last_stats_.exec_time_ms =
+        std::chrono::duration<double, std::milli>(now - run_start_).count();
+}
 
-    // No generate(), após o prefill:
+void CpuBackend::record_perf(size_t region, const PerfSample& before, uint64_t t0_ns) {
+    if (region >= perf_regions_.size()) return;
 
-std::cout << "[debug] prefill done\n";
+    PerfSample delta = PerfCounters::read_all() - before;
+    delta.time_ns = Profiler::now_ns() - t0_ns;
+    perf_regions_[region] += delta;
+}
 
-// ========== DEBUG DOS LOGITS ==========
-std::cout << "[debug] checking logits after prefill...\n";
-float max_logit = -INFINITY;
-float min_logit = INFINITY;
-int max_idx = 0;
-bool has_nan = false;
+BackendStats CpuBackend::stats() const {
 
-for (size_t i = 0; i < config_.n_vocab; ++i) {
-    float val = logits_buf_[i];
+    BackendStats s = last_stats_;
 
-    if (std::isnan(val) || std::isinf(val)) {
-        std::cerr << "[ERROR] NaN/Inf at logit[" << i << "]\n";
-        has_nan = true;
-        break;
-    }
+    s.memory = memory_report();
+    publish_memory(s.memory);
 
-    if (val > max_logit) {
-        max_logit = val;
-        max_idx = i;
-    }
-    if (val < min_logit) {
-        min_logit = val;
+    if (s.exec_time_ms > 0) {
+        s.tokens_per_sec =
+            (s.tokens_total * 1000.0) / s.exec_time_ms;
     }
-}
 
-if (has_nan) {
-    std::cerr << "[ERROR] Logits contain NaN/Inf! Cannot continue.\n";
-    return "";
-}
+    s.itl_p50_ms = itl_ns_.percentile(0.50) / 1e6;
+    s.itl_p90_ms = itl_ns_.percentile(0.90) / 1e6;
+    s.itl_p99_ms = itl_ns_.percentile(0.99) / 1e6;
+    s.itl_max_ms = itl_ns_.max() / 1e6;
 
-std::cout << "[debug] logits range: min=" << min_logit
-          << " max=" << max_logit
-          << " (at token=" << max_idx << ")\n";
+    if (energy_) {
+        const auto e = energy_->request(request_id_);
+        s.energy_prefill_joules = e.prefill_joules;
+        s.energy_decode_joules = e.decode_joules;
+        s.energy_total_joules = e.joules();
 
-std::cout << "[debug] first 10 logits: ";
-for (int i = 0; i < 10; ++i) {
-    std::cout << logits_buf_[i] << " ";
-}
-std::cout << "\n";
-
-// Teste com greedy sampler
-SamplingConfig greedy_config;
-greedy_config.strategy = SamplingStrategy::GREEDY;
-Sampler greedy_sampler(greedy_config);
-
-int32_t test_token = greedy_sampler.sample(logits_buf_.data(), config_.n_vocab);
-std::cout << "[debug] greedy sampler chose: " << test_token << "\n";
-
-// Verificar se todos os logits são iguais
-bool all_equal = true;
-float first_val = logits_buf_[0];
-for (size_t i = 1; i < std::min(config_.n_vocab, 100u); ++i) {
-    if (std::abs(logits_buf_[i] - first_val) > 1e-6) {
-        all_equal = false;
-        break;
+        if (s.exec_time_ms > 0) {
+            s.watts_avg = s.energy_total_joules / (s.exec_time_ms / 1000.0);
+        }
+        if (s.energy_total_joules > 0) {
+            s.tokens_per_watt = s.tokens_total / s.energy_total_joules;
+        }
+        if (s.tokens_total > 0) {
+            s.joules_per_token = s.energy_total_joules / double(s.tokens_total);
+        }
     }
-}
 
-if (all_equal) {
-    std::cerr << "[WARNING] All logits are equal! Model may not be working.\n";
+    return s;
 }
-// ========== FIM DEBUG ==========
 
-std::cout << "[debug] decode starting...\n";
+std::string CpuBackend::generate(
+    const std::string& prompt,
+    int max_tokens,
+    const SamplingConfig& sampling,
+    std::shared_ptr<const Grammar> grammar,
+    std::vector<std::string> stop_strings
+) {
+    ENGINE_LOG_DEBUG("cpu", "generating from prompt: \"" << prompt << "\"");
 
+    // O generator guarda Sampler*: troca a configuração no mesmo objeto e
+    // mantém o generator (VocabTrie e cache de máscaras da gramática)
+    if (sampler_) {
+        *sampler_ = Sampler(sampling);
+    } else {
+        sampler_ = std::make_unique<Sampler>(sampling);
+    }
 
+    GenerationConfig config;
+    config.max_tokens = max_tokens;
+    config.max_context_length = static_cast<int>(config_.n_ctx);
+    config.max_joules = power_limits_.max_joules_per_request;
+    config.grammar = std::move(grammar);
+    config.stop_strings = std::move(stop_strings);
 
-    // 3. Generate
-    std::cout << "[debug] decode starting..." << std::endl;
-    std::vector<int32_t> generated_tokens;
+    return generate_advanced(prompt, config);
+}
 
-    sampler_ = std::make_unique<Sampler>(sampling);
+std::string CpuBackend::generate_advanced(
+    const std::string& prompt,
+    const GenerationConfig& config
+) {
+    if (!tokenizer_) {
+        throw std::runtime_error("[cpu] generate called before load_model");
+    }
 
-    for (int i = 0; i < max_tokens; ++i) {
-        std::cout << "[decode] " << (i+1) << "/" << max_tokens << std::endl;
+    if (!sampler_) {
+        sampler_ = std::make_unique<Sampler>();
+    }
 
-        int32_t next_token = sampler_->sample(
-            logits_buf_.data(),
-            config_.n_vocab
+    if (!generator_) {
+        generator_ = std::make_unique<AutoregressiveGenerator>(
+            this, tokenizer_.get(), sampler_.get(), config_.n_vocab
         );
+    }
 
-        std::cout << "[decode] sampled: " << next_token << std::endl;
-
-        if (next_token == tokenizer_->eos_token()) {
-            std::cout << "[cpu] EOS" << std::endl;
-            break;
-        }
-
-        generated_tokens.push_back(next_token);
-
-        TensorView in_view;
-        in_view.data = &next_token;
-
-        TensorView out_view;
-        out_view.data = logits_buf_.data();
+    reset_run_stats();
 
-        forward(in_view, out_view);
-    }
+    std::string text = generator_->generate(prompt, config);
 
-    std::cout << "[debug] decoding text..." << std::endl;
-    std::string result = tokenizer_->decode(generated_tokens);
-    std::cout << "[debug] done!" << std::endl;
+    // Estatísticas do request: tokens gerados e tempo de parede
+    const GenerationStats& gs = generator_->stats();
+    last_stats_.tokens_total = static_cast<uint64_t>(gs.generated_tokens);
+    last_stats_.prompt_tokens = static_cast<uint64_t>(gs.prompt_tokens);
+    last_stats_.exec_time_ms = gs.total_ms;
+    last_stats_.ttft_ms = gs.ttft_ms;
+    itl_ns_ = generator_->itl_histogram();
 
-    return result;
+    return text;
 }
 
 } // namespace engine
@@ -1,12 +1,24 @@
 #pragma once
 
 #include "backend/backend.h"
+#include "backend/cpu/ops_simd.h"
+#include "backend/cpu/tuning_profile.h"
+#include "core/execution_plan.h"
+#include "core/thread_pool.h"
 #include "metrics/power_linux.h"
+#include "metrics/power_governor.h"
+#include "metrics/energy_sampler.h"
+#include "metrics/perf_counters.h"
+#include "metrics/histogram.h"
+#include "metrics/profiler.h"
 #include "model/gguf_loader.h"
 #include "model/tokenizer.h"
 #include "model/sampler.h"
 #include "model/autoregressive_generator.h"  // ← NOVO
 
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <vector>
 #include <memory>
 
@@ -67,22 +79,73 @@ struct ModelConfig {
 class CpuBackend final : public Backend {
 public:
     CpuBackend();
-
+    explicit CpuBackend(const core::ExecutionPlan& plan);
+    ~CpuBackend() override;
 
     void init() override;
     ModelInfo load_model(const std::string& model_path) override;
     void forward(const TensorView& in, TensorView& out) override;
+    bool forward_top_k(const TensorView& in, int k, float* values, int32_t* indices) override;
     BackendStats stats() const override;
+    bool last_forward_ok() const override { return last_forward_ok_; }
+
+    std::optional<double> energy_joules() const override;
+    std::optional<double> request_energy_joules() const override;
+    int batch_limit() const override;
+    void set_phase(ExecutionPhase phase) override;
+
+    // ═══════════════════════════════════════════════════════════
+    // Ajustes de execução (autotuner / perfil por host)
+    // ═══════════════════════════════════════════════════════════
+
+    int max_threads() const { return pool_ ? pool_->size() : 1; }
+
+    // Fixa a mesma contagem para prefill e decode
+    void set_threads(int n);
+
+    MatmulKernel matmul_kernel() const { return kernel_; }
+    void set_matmul_kernel(MatmulKernel k) { kernel_ = k; }
+
+    const ModelConfig& model_config() const { return config_; }
+
+    // Medidor RAPL (nullptr sem powercap) — leitura por domínio
+    const PowerLinux* power_meter() const { return power_ok_ ? &power_ : nullptr; }
+
+    // Tempo e contadores de hardware do último run, por região: um por
+    // layer e, por último, a projeção de saída. Gravado com PerfCounters
+    // ligado ou set_region_timing(true) (só tempo).
+    const std::vector<PerfSample>& perf_regions() const { return perf_regions_; }
+    void set_region_timing(bool on) { region_timing_ = on; }
+
+    // Bytes de pesos lidos por token em cada região (mesma indexação)
+    struct RegionBytes {
+        uint64_t gguf = 0;      // tamanho no arquivo (quantizado)
+        uint64_t streamed = 0;  // lido pelos kernels (F32 após dequant)
+    };
+    const std::vector<RegionBytes>& region_bytes() const { return region_bytes_; }
+
+    // Começa um novo run: zera stats e regiões e abre um novo request de energia
+    void reset_run_stats();
+
+    // Bytes por componente (pesos mapeados/residentes, dequant, KV, scratch) + RSS
+    MemoryReport memory_report() const;
+
+    ThreadPool* thread_pool() { return pool_.get(); }
+    int decode_threads() const { return decode_threads_; }
 
     // ═══════════════════════════════════════════════════════════
     // NOVA API - Geração com Generator
     // ═══════════════════════════════════════════════════════════
 
     // Gera texto usando AutoregressiveGenerator
+    // (grammar != nullptr: saída restrita à gramática;
+    //  stop_strings: o texto termina antes da primeira ocorrência)
     std::string generate(
         const std::string& prompt,
         int max_tokens = 50,
-        const SamplingConfig& sampling = {}
+        const SamplingConfig& sampling = {},
+        std::shared_ptr<const Grammar> grammar = nullptr,
+        std::vector<std::string> stop_strings = {}
     );
 
 
@@ -141,25 +204,89 @@ private:
     std::vector<float> hidden_buf_;
     std::vector<float> logits_buf_;
 
+    // lm_head fundido: por thread, um bloco de logits e o top-k corrente
+    static constexpr int HEAD_CHUNK = 256;
+    std::vector<float> head_chunk_;
+    std::vector<ops::simd::ScoredToken> head_best_;   // [threads][k]
+    std::vector<ops::simd::ScoredToken> head_tmp_;    // [threads][3k]
+    std::vector<int> head_count_;
+    std::vector<int> head_bad_;                       // 1º índice não finito por thread
+
     // KV Cache
     std::vector<float> k_cache_;
     std::vector<float> v_cache_;
     int kv_pos_ = 0;
 
+    // Execução
+    uint32_t n_threads_ = 0;
+    core::PowerLimits power_limits_{};
+    std::unique_ptr<ThreadPool> pool_;
+    MatmulKernel kernel_ = MatmulKernel::SCALAR;
+
+    // Threads por fase (prefill largo, decode estreito)
+    int prefill_threads_ = 0;
+    int decode_threads_ = 0;
+    bool decode_explicit_ = false;
+    std::atomic<ExecutionPhase> phase_{ExecutionPhase::PREFILL};
+    // Teto do governador: escrito pela thread dele, aplicado só na thread
+    // chamadora (set_phase/account_token), dona das threads por fase
+    std::atomic<int> governor_threads_{std::numeric_limits<int>::max()};
+    int applied_governor_threads_ = std::numeric_limits<int>::max();
+
     // Metrics
     BackendStats last_stats_{};
+    LogHistogram itl_ns_;
+    std::chrono::steady_clock::time_point run_start_{};
+    std::chrono::steady_clock::time_point last_token_time_{};
     PowerLinux power_{};
     bool power_ok_ = false;
-    double energy_start_ = 0.0;
+
+    // Atribuição de energia por fase e por request (ativo com RAPL)
+    std::unique_ptr<EnergySampler> energy_;
+    uint64_t request_id_ = 0;
+
+    // perf_event por região (layers + output proj), somado entre threads
+    std::vector<PerfSample> perf_regions_;
+    std::vector<RegionBytes> region_bytes_;
+    bool region_timing_ = false;
+    void record_perf(size_t region, const PerfSample& before, uint64_t t0_ns);
+    void compute_region_bytes();
+
+    // NaN/Inf nas ativações: checa o tensor inteiro nos pontos de saída das ops
+    core::NumericsCheck numerics_{};
+    bool check_numerics_ = false;  // vale para o forward corrente
+    uint64_t forward_count_ = 0;
+    bool last_forward_ok_ = true;
+    bool check_finite(const float* x, uint32_t n, ProfOp op, int layer);
+    void report_non_finite(ProfOp op, int layer, int index, float value);
+
+    // Power cap (ativo só com PowerLimits::max_watts > 0 e RAPL disponível)
+    std::unique_ptr<PowerGovernor> governor_;
+    std::atomic<int> batch_limit_{0};
 
     // Internal helpers
     void extract_weights();
     void dequantize_weights();
     void init_rope_freqs();
+    void apply_tuning_profile(const std::string& model_path);
+    void apply_threads();
+    void start_governor();
+
+    void account_token();
+    void publish_memory(const MemoryReport& m) const;
+
+    // matmul particionado em N entre as threads ativas do pool
+    void matmul(const float* A, const float* B, float* C, int M, int N, int K);
+
+    // Embedding → layers → output norm em hidden_buf_ (false = abortar o token)
+    bool forward_hidden(const TensorView& in);
+
+    // Projeção de saída + top-k por thread, mesclado no fim (em head_best_)
+    bool output_top_k(int k);
 
-    void forward_layer(int layer_idx, float* hidden, int seq_len);
-    void forward_attention(const TransformerLayer& layer, float* hidden, int seq_len);
-    void forward_ffn(const TransformerLayer& layer, float* hidden, int seq_len);
+    bool forward_layer(int layer_idx, float* hidden, int seq_len);
+    void forward_attention(int layer_idx, const TransformerLayer& layer, float* hidden, int seq_len);
+    void forward_ffn(int layer_idx, const TransformerLayer& layer, float* hidden, int seq_len);
 };
 
 } // namespace engine
@@ -1,10 +1,10 @@
 #include "backend/cpu/ops.h"
 #include "backend/cpu/quants.h"
+#include "core/logger.h"
 
 #include <cstring>
 #include <algorithm>
 #include <cmath>
-#include <iostream>
 
 namespace engine {
 namespace ops {
@@ -19,7 +19,7 @@ void dequantize_q4_k_m(float* dst, const void* src, int n) {
     const int nb = n / QK_K;  // Número de blocos
     
     if (n % QK_K != 0) {
-        std::cerr << "[dequant] WARNING: n=" << n << " not multiple of " << QK_K << "\n";
+        ENGINE_LOG_WARN("dequant", "n=" << n << " not multiple of " << QK_K);
     }
     
     const block_q4_K* blocks = static_cast<const block_q4_K*>(src);
@@ -115,8 +115,7 @@ void dequantize_q6_k(float* dst, const void* src, int n) {
     const int nb = n / QK_K;
 
     if (n % QK_K != 0) {
-        std::cerr << "[dequant] WARNING: Q6_K n=" << n
-                  << " not multiple of " << QK_K << "\n";
+        ENGINE_LOG_WARN("dequant", "Q6_K n=" << n << " not multiple of " << QK_K);
     }
 
     const block_q6_K* blocks = static_cast<const block_q6_K*>(src);
@@ -193,12 +192,12 @@ void dequantize_q6_k(float* dst, const void* src, int n) {
 
         case GgmlType::Q4_0:
         case GgmlType::Q4_1:
-            std::cerr << "[dequant] Q4_0/Q4_1 not supported (would corrupt)\n";
+            ENGINE_LOG_ERROR("dequant", "Q4_0/Q4_1 not supported (would corrupt)");
             std::memset(dst, 0, (size_t)n * sizeof(float));
             return;
 
         case GgmlType::Q8_1:
-            std::cerr << "[dequant] Q8_1 not supported (different layout)\n";
+            ENGINE_LOG_ERROR("dequant", "Q8_1 not supported (different layout)");
             std::memset(dst, 0, (size_t)n * sizeof(float));
             return;
 
@@ -210,14 +209,14 @@ void dequantize_q6_k(float* dst, const void* src, int n) {
         case GgmlType::Q8_K:
         case GgmlType::IQ2_XXS:
         case GgmlType::IQ2_XS:
-            std::cerr << "[dequant] type " << static_cast<int>(type)
-                      << " not implemented, returning zeros\n";
+            ENGINE_LOG_ERROR("dequant", "type " << static_cast<int>(type)
+                             << " not implemented, returning zeros");
             std::memset(dst, 0, (size_t)n * sizeof(float));
             return;
 
         default:
-            std::cerr << "[dequant] unknown type " << static_cast<int>(type)
-                      << ", returning zeros\n";
+            ENGINE_LOG_ERROR("dequant", "unknown type " << static_cast<int>(type)
+                             << ", returning zeros");
             std::memset(dst, 0, (size_t)n * sizeof(float));
             return;
     }
@@ -12,6 +12,14 @@ namespace ops {
 void matmul_f32(
     const float* A, const float* B, float* C,
     int M, int N, int K
+) {
+    matmul_f32_range(A, B, C, M, N, K, 0, N);
+}
+
+void matmul_f32_range(
+    const float* A, const float* B, float* C,
+    int M, int N, int K,
+    int n_begin, int n_end
 ) {
     // A: row-major (M x K)
     // B: ggml layout (ne0=K, ne1=N) => B[k + K*j]
@@ -20,7 +28,7 @@ void matmul_f32(
     for (int i = 0; i < M; ++i) {
         const float* arow = A + (size_t)i * K;
 
-        for (int j = 0; j < N; ++j) {
+        for (int j = n_begin; j < n_end; ++j) {
             const float* bcol = B + (size_t)K * j; // coluna j contígua em K
             float sum = 0.0f;
 
@@ -12,6 +12,13 @@ namespace ops {
 // ============================================================================
 
 void matmul_f32(const float* A, const float* B, float* C, int M, int N, int K);
+
+// Calcula apenas as colunas [n_begin, n_end) de C (particionamento entre threads)
+void matmul_f32_range(
+    const float* A, const float* B, float* C,
+    int M, int N, int K,
+    int n_begin, int n_end
+);
 void add_f32(float* dst, const float* src, int n);
 void mul_f32(float* dst, const float* a, const float* b, int n);
 void copy_f32(float* dst, const float* src, int n);
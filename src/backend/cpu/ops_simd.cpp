@@ -1,4 +1,6 @@
 #include "ops_simd.h"
+#include "core/logger.h"
+#include <cstdint>
 #include <cstring>
 #include <algorithm>
 #include <cmath>
@@ -66,6 +68,21 @@ void matmul_f32_optimized(
 #endif
 }
 
+void matmul_f32_range_simd(
+    const float* A, const float* B, float* C,
+    int M, int N, int K,
+    int n_begin, int n_end
+) {
+    // B: ggml layout (ne0=K, ne1=N) => coluna j contígua em K
+    for (int i = 0; i < M; ++i) {
+        const float* arow = A + (size_t)i * K;
+
+        for (int j = n_begin; j < n_end; ++j) {
+            C[(size_t)i * N + j] = dot_product_f32(arow, B + (size_t)K * j, K);
+        }
+    }
+}
+
 // ============================================================================
 // DOT PRODUCT
 // ============================================================================
@@ -201,8 +218,8 @@ void rms_norm_f32_simd(
 
     // PROTEÇÃO: Se rms_sq ainda for muito pequeno ou negativo
     if (rms_sq <= 0.0f || std::isnan(rms_sq) || std::isinf(rms_sq)) {
-        std::cerr << "[ERROR] Invalid RMS: sum_sq=" << sum_sq
-                  << " n=" << n << " eps=" << eps << "\n";
+        ENGINE_LOG_ERROR("simd", "invalid RMS: sum_sq=" << sum_sq
+                         << " n=" << n << " eps=" << eps);
         // Fallback: copiar input
         for (int j = 0; j < n; ++j) {
             out[j] = in[j] * weight[j];
@@ -221,8 +238,7 @@ void rms_norm_f32_simd(
 
     // Verificar se scale é válido
     if (std::isnan(scale) || std::isinf(scale)) {
-        std::cerr << "[ERROR] Invalid scale: " << scale
-                  << " (rms=" << rms << ")\n";
+        ENGINE_LOG_ERROR("simd", "invalid scale: " << scale << " (rms=" << rms << ")");
         for (int j = 0; j < n; ++j) {
             out[j] = in[j] * weight[j];
         }
@@ -366,6 +382,155 @@ bool is_avx2_available() {
 #endif
 }
 
+// ============================================================================
+// CHECAGEM NUMÉRICA
+// ============================================================================
+
+// NaN/Inf <=> expoente todo em 1. Teste inteiro: não depende de -ffast-math.
+static inline bool non_finite_bits(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return (bits & 0x7f800000u) == 0x7f800000u;
+}
+
+int find_non_finite_f32(const float* x, int n) {
+    int i = 0;
+#ifdef __AVX2__
+    const __m256i exp_mask = _mm256_set1_epi32(0x7f800000);
+
+    // 32 floats por iteração; o índice exato só é procurado se houver acerto
+    for (; i + 31 < n; i += 32) {
+        __m256i hit = _mm256_setzero_si256();
+        for (int k = 0; k < 32; k += 8) {
+            const __m256i v = _mm256_and_si256(
+                _mm256_castps_si256(_mm256_loadu_ps(x + i + k)), exp_mask
+            );
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(v, exp_mask));
+        }
+        if (!_mm256_testz_si256(hit, hit)) break;
+    }
+#endif
+    for (; i < n; ++i) {
+        if (non_finite_bits(x[i])) return i;
+    }
+    return -1;
+}
+
+// ============================================================================
+// REDUÇÕES / SELEÇÃO
+// ============================================================================
+
+float max_f32(const float* x, int n) {
+    int i = 0;
+    float m = -INFINITY;
+#ifdef __AVX2__
+    if (n >= 32) {
+        __m256 m0 = _mm256_loadu_ps(x);
+        __m256 m1 = m0, m2 = m0, m3 = m0;
+        for (; i + 31 < n; i += 32) {
+            m0 = _mm256_max_ps(m0, _mm256_loadu_ps(x + i));
+            m1 = _mm256_max_ps(m1, _mm256_loadu_ps(x + i + 8));
+            m2 = _mm256_max_ps(m2, _mm256_loadu_ps(x + i + 16));
+            m3 = _mm256_max_ps(m3, _mm256_loadu_ps(x + i + 24));
+        }
+        m0 = _mm256_max_ps(_mm256_max_ps(m0, m1), _mm256_max_ps(m2, m3));
+
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, m0);
+        for (float v : lanes) m = std::max(m, v);
+    }
+#endif
+    for (; i < n; ++i) m = std::max(m, x[i]);
+    return m;
+}
+
+int argmax_f32(const float* x, int n) {
+    if (n <= 0) return -1;
+
+    // Duas passadas: máximo vetorizado, depois a primeira ocorrência
+    const float m = max_f32(x, n);
+
+    int i = 0;
+#ifdef __AVX2__
+    const __m256 vm = _mm256_set1_ps(m);
+    for (; i + 7 < n; i += 8) {
+        const int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(x + i), vm, _CMP_EQ_OQ));
+        if (mask) return i + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (x[i] == m) return i;
+    }
+    return 0;  // só NaN
+}
+
+// Topo do min-heap = pior candidato (menor valor; no empate, maior índice)
+static inline bool heap_better(const ScoredToken& a, const ScoredToken& b) {
+    return a.val > b.val || (a.val == b.val && a.idx < b.idx);
+}
+
+int top_k_f32(const float* x, int n, int k, ScoredToken* out) {
+    k = std::min(k, n);
+    if (k <= 0) return 0;
+
+    ScoredToken* heap = out;
+    ScoredToken* heap_end = out + k;
+
+    int i = 0;
+    for (; i < k; ++i) heap[i] = {x[i], i};
+    std::make_heap(heap, heap_end, heap_better);
+
+    // Índices só crescem: empate com o topo nunca entra (estrito >)
+    auto offer = [heap, heap_end](float v, int32_t idx) {
+        if (!(v > heap[0].val)) return;
+        std::pop_heap(heap, heap_end, heap_better);
+        heap_end[-1] = {v, idx};
+        std::push_heap(heap, heap_end, heap_better);
+    };
+
+#ifdef __AVX2__
+    for (; i + 7 < n; i += 8) {
+        const __m256 thr = _mm256_set1_ps(heap[0].val);
+        unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(x + i), thr, _CMP_GT_OQ))
+        );
+        while (mask) {
+            const int b = __builtin_ctz(mask);
+            offer(x[i + b], i + b);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < n; ++i) offer(x[i], i);
+
+    std::sort(heap, heap_end, heap_better);
+    return k;
+}
+
+void mask_f32(float* x, const uint32_t* allow, int n, float fill) {
+    int i = 0;
+#ifdef __AVX2__
+    const __m256i lane_bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256 fill_v = _mm256_set1_ps(fill);
+
+    for (; i + 31 < n; i += 32) {
+        const uint32_t word = allow[i >> 5];
+        if (word == 0xFFFFFFFFu) continue;  // bloco todo permitido
+
+        for (int k = 0; k < 32; k += 8) {
+            const __m256i bits = _mm256_and_si256(
+                _mm256_set1_epi32(static_cast<int>((word >> k) & 0xFF)), lane_bit
+            );
+            const __m256 keep = _mm256_castsi256_ps(_mm256_cmpeq_epi32(bits, lane_bit));
+            _mm256_storeu_ps(x + i + k, _mm256_blendv_ps(fill_v, _mm256_loadu_ps(x + i + k), keep));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (!((allow[i >> 5] >> (i & 31)) & 1u)) x[i] = fill;
+    }
+}
+
 void benchmark_ops() {
     std::cout << "=== SIMD Benchmark ===\n";
     std::cout << "AVX2 available: " << (is_avx2_available() ? "YES" : "NO") << "\n";
@@ -26,6 +26,13 @@ void matmul_f32_transposed(
     int M, int N, int K
 );
 
+// Variante de ops::matmul_f32_range com dot product AVX2 (layout ggml de B)
+void matmul_f32_range_simd(
+    const float* A, const float* B, float* C,
+    int M, int N, int K,
+    int n_begin, int n_end
+);
+
 // ============================================================================
 // DOT PRODUCT OTIMIZADO
 // ============================================================================
@@ -78,6 +85,36 @@ void rope_f32_simd(
     int pos_offset = 0
 );
 
+// ============================================================================
+// CHECAGEM NUMÉRICA
+// ============================================================================
+
+// Índice do primeiro elemento NaN/Inf, ou -1 se todos forem finitos
+int find_non_finite_f32(const float* x, int n);
+
+// ============================================================================
+// REDUÇÕES / SELEÇÃO (sampling)
+// ============================================================================
+
+float max_f32(const float* x, int n);
+
+// Índice do maior valor (o menor índice em caso de empate)
+int argmax_f32(const float* x, int n);
+
+struct ScoredToken {
+    float val;
+    int32_t idx;
+};
+
+// Os k maiores de x, em ordem decrescente (empate: menor índice primeiro).
+// Pré-filtro SIMD contra o menor valor do heap; só candidatos entram no heap.
+// out com espaço para k (é usado como o próprio heap). Retorna min(k, n).
+int top_k_f32(const float* x, int n, int k, ScoredToken* out);
+
+// x[i] = fill onde o bit i de allow (1 bit por elemento, LSB primeiro)
+// está zerado. Máscaras de tokens da decodificação restrita.
+void mask_f32(float* x, const uint32_t* allow, int n, float fill);
+
 // ============================================================================
 // UTILITIES
 // ============================================================================
@@ -0,0 +1,149 @@
+#include "backend/cpu/roofline.h"
+#include "backend/cpu/cpu_backend.h"
+#include "backend/cpu/ops_simd.h"
+#include "core/logger.h"
+
+#include <chrono>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace engine {
+
+Roofline::Roofline(CpuBackend& backend) : backend_(backend) {
+}
+
+std::string Roofline::probe_path() {
+    return (fs::path{TuningProfile::cache_dir()} /
+            (TuningProfile::current_host() + ".bandwidth")).string();
+}
+
+BandwidthProfile Roofline::peak(const Options& options, bool& cached) {
+    const std::string path = probe_path();
+
+    if (!options.reprobe) {
+        if (auto p = BandwidthProfile::load(path); p.has_value()) {
+            cached = true;
+            return *p;
+        }
+    }
+
+    // O teto é do host: mede com o pool inteiro, depois volta ao decode
+    ThreadPool* pool = backend_.thread_pool();
+    const int decode = backend_.decode_threads();
+
+    BandwidthProfile p;
+    if (pool) {
+        backend_.set_threads(backend_.max_threads());
+        p = BandwidthProbe::run(*pool, options.probe);
+        backend_.set_threads(decode);
+    }
+    p.host = TuningProfile::current_host();
+
+    if (!p.save(path)) {
+        ENGINE_LOG_WARN("roofline", "cannot cache bandwidth probe: " << path);
+    }
+
+    cached = false;
+    return p;
+}
+
+Roofline::KernelReport Roofline::measure(MatmulKernel kernel, const Options& options, double peak_gbps) {
+    backend_.set_matmul_kernel(kernel);
+    backend_.set_phase(ExecutionPhase::DECODE);
+
+    const uint32_t n_vocab = backend_.model_config().n_vocab;
+    std::vector<float> logits(n_vocab);
+
+    // Mesma carga sintética do autotuner (tokens espalhados pelo vocabulário)
+    auto run_tokens = [&](int count, int salt) {
+        for (int i = 0; i < count; ++i) {
+            int32_t token = static_cast<int32_t>(
+                (static_cast<uint64_t>(i + salt) * 7919u) % n_vocab
+            );
+
+            TensorView in;
+            in.data = &token;
+            in.shape = {1};
+
+            TensorView out;
+            out.data = logits.data();
+            out.shape = {n_vocab};
+
+            backend_.forward(in, out);
+        }
+    };
+
+    run_tokens(options.warmup_tokens, 0);
+
+    backend_.set_region_timing(true);
+    backend_.reset_run_stats();
+
+    const auto t0 = std::chrono::steady_clock::now();
+    run_tokens(options.tokens, options.warmup_tokens);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    backend_.set_region_timing(false);
+
+    const auto& bytes = backend_.region_bytes();
+    const auto& timing = backend_.perf_regions();
+    const double tokens = std::max(1, options.tokens);
+
+    KernelReport r;
+    r.kernel = kernel;
+
+    uint64_t total_bytes = 0;
+    for (const auto& b : bytes) total_bytes += b.streamed;
+
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    if (secs > 0.0) {
+        r.tokens_per_sec = tokens / secs;
+        r.gbps = double(total_bytes) * r.tokens_per_sec / 1e9;
+    }
+    if (peak_gbps > 0.0) r.fraction_of_peak = r.gbps / peak_gbps;
+
+    for (size_t i = 0; i < bytes.size() && i < timing.size(); ++i) {
+        Region reg;
+        reg.name = (i + 1 == bytes.size()) ? "output_proj" : "layer " + std::to_string(i);
+        reg.bytes_per_token = bytes[i].streamed;
+        reg.ms_per_token = timing[i].time_ns / 1e6 / tokens;
+
+        if (timing[i].time_ns > 0) {
+            reg.gbps = double(bytes[i].streamed) * tokens / double(timing[i].time_ns);
+        }
+        if (peak_gbps > 0.0) reg.fraction_of_peak = reg.gbps / peak_gbps;
+
+        r.regions.push_back(reg);
+    }
+
+    return r;
+}
+
+Roofline::Report Roofline::run(const Options& options) {
+    Report report;
+    report.peak = peak(options, report.peak_cached);
+    report.peak_path = probe_path();
+
+    for (const auto& b : backend_.region_bytes()) {
+        report.gguf_bytes_per_token += b.gguf;
+        report.streamed_bytes_per_token += b.streamed;
+    }
+
+    std::vector<MatmulKernel> kernels = options.kernels;
+    if (kernels.empty()) {
+        kernels.push_back(MatmulKernel::SCALAR);
+        if (ops::simd::is_avx2_available()) {
+            kernels.push_back(MatmulKernel::SIMD);
+        }
+    }
+
+    const MatmulKernel original = backend_.matmul_kernel();
+    for (MatmulKernel k : kernels) {
+        report.kernels.push_back(measure(k, options, report.peak.read_gbps));
+    }
+    backend_.set_matmul_kernel(original);
+
+    return report;
+}
+
+} // namespace engine
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "backend/cpu/tuning_profile.h"
+#include "metrics/bandwidth_probe.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace engine {
+
+class CpuBackend;
+
+/**
+ * Roofline de decode para o backend CPU (`engine bench --roofline`).
+ *
+ * Decode é GEMV: cada token lê todos os pesos uma vez, então
+ * bytes/token é conhecido a partir dos tensores do modelo e
+ *   GB/s atingido = bytes/token × tokens/s
+ * é comparado com o teto de banda do host (BandwidthProbe, cacheado).
+ * O relatório sai por kernel de matmul e por região (layer, output proj).
+ */
+class Roofline {
+public:
+    struct Options {
+        std::vector<MatmulKernel> kernels;  // vazio = todas disponíveis
+        int warmup_tokens = 4;
+        int tokens = 32;
+        bool reprobe = false;               // ignora o probe cacheado
+        BandwidthProbe::Options probe;
+    };
+
+    struct Region {
+        std::string name;
+        uint64_t bytes_per_token = 0;
+        double ms_per_token = 0.0;
+        double gbps = 0.0;
+        double fraction_of_peak = 0.0;
+    };
+
+    struct KernelReport {
+        MatmulKernel kernel = MatmulKernel::SCALAR;
+        double tokens_per_sec = 0.0;
+        double gbps = 0.0;
+        double fraction_of_peak = 0.0;
+        std::vector<Region> regions;
+    };
+
+    struct Report {
+        BandwidthProfile peak;
+        std::string peak_path;
+        bool peak_cached = false;
+
+        uint64_t gguf_bytes_per_token = 0;
+        uint64_t streamed_bytes_per_token = 0;
+
+        std::vector<KernelReport> kernels;
+    };
+
+    explicit Roofline(CpuBackend& backend);
+
+    // Backend já inicializado e com o modelo carregado.
+    Report run(const Options& options);
+
+    // Caminho do probe cacheado para o host atual
+    static std::string probe_path();
+
+private:
+    CpuBackend& backend_;
+
+    BandwidthProfile peak(const Options& options, bool& cached);
+    KernelReport measure(MatmulKernel kernel, const Options& options, double peak_gbps);
+};
+
+} // namespace engine
@@ -0,0 +1,126 @@
+#include "backend/cpu/tuning_profile.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace engine {
+
+const char* matmul_kernel_name(MatmulKernel k) {
+    switch (k) {
+        case MatmulKernel::SCALAR: return "scalar";
+        case MatmulKernel::SIMD:   return "simd";
+    }
+    return "scalar";
+}
+
+std::optional<MatmulKernel> matmul_kernel_from_name(const std::string& s) {
+    if (s == "scalar") return MatmulKernel::SCALAR;
+    if (s == "simd")   return MatmulKernel::SIMD;
+    return std::nullopt;
+}
+
+/* ================================================= */
+
+std::string TuningProfile::current_host() {
+#ifdef __linux__
+    char buf[256] = {};
+    if (::gethostname(buf, sizeof(buf) - 1) == 0 && buf[0] != '\0') {
+        return buf;
+    }
+#endif
+    return "localhost";
+}
+
+// Identifica o modelo por nome + tamanho (quantizações diferentes → perfis diferentes)
+std::string TuningProfile::model_id(const std::string& model_path) {
+    const fs::path p{model_path};
+
+    std::error_code ec;
+    const auto size = fs::file_size(p, ec);
+
+    std::string id = p.stem().string();
+    if (!ec) {
+        id += '-';
+        id += std::to_string(size);
+    }
+    return id;
+}
+
+std::string TuningProfile::cache_dir() {
+    if (const char* d = std::getenv("ENGINE_TUNE_DIR"); d && *d) {
+        return d;
+    }
+    if (const char* d = std::getenv("XDG_CACHE_HOME"); d && *d) {
+        return (fs::path{d} / "engine" / "tune").string();
+    }
+    if (const char* d = std::getenv("HOME"); d && *d) {
+        return (fs::path{d} / ".cache" / "engine" / "tune").string();
+    }
+    return ".engine_tune";
+}
+
+std::string TuningProfile::path_for(const std::string& model_path) {
+    return (fs::path{cache_dir()} / (current_host() + "__" + model_id(model_path) + ".profile")).string();
+}
+
+/* ================================================= */
+
+std::optional<TuningProfile> TuningProfile::load(const std::string& path) {
+    std::ifstream f(path);
+    if (!f.is_open()) return std::nullopt;
+
+    TuningProfile p;
+    std::string line;
+
+    while (std::getline(f, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        const auto eq = line.find('=');
+        if (eq == std::string::npos) continue;
+
+        const std::string key = line.substr(0, eq);
+        const std::string val = line.substr(eq + 1);
+
+        try {
+            if (key == "host")                  p.host = val;
+            else if (key == "model")            p.model = val;
+            else if (key == "threads")          p.threads = std::stoi(val);
+            else if (key == "kernel")           p.kernel = matmul_kernel_from_name(val).value_or(MatmulKernel::SCALAR);
+            else if (key == "tokens_per_sec")   p.tokens_per_sec = std::stod(val);
+            else if (key == "tokens_per_joule") p.tokens_per_joule = std::stod(val);
+        } catch (const std::exception&) {
+            return std::nullopt;  // perfil corrompido: ignora
+        }
+    }
+
+    if (p.threads <= 0) return std::nullopt;
+    return p;
+}
+
+bool TuningProfile::save(const std::string& path) const {
+    std::error_code ec;
+    fs::create_directories(fs::path{path}.parent_path(), ec);
+
+    std::ofstream f(path, std::ios::trunc);
+    if (!f.is_open()) return false;
+
+    f << "# engine tuning profile (engine tune)\n"
+      << "host=" << host << "\n"
+      << "model=" << model << "\n"
+      << "threads=" << threads << "\n"
+      << "kernel=" << matmul_kernel_name(kernel) << "\n"
+      << "tokens_per_sec=" << tokens_per_sec << "\n"
+      << "tokens_per_joule=" << tokens_per_joule << "\n";
+
+    return static_cast<bool>(f);
+}
+
+} // namespace engine
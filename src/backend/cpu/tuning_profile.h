@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace engine {
+
+// Variantes de kernel de matmul disponíveis no backend CPU
+enum class MatmulKernel {
+    SCALAR,  // ops::matmul_f32_range
+    SIMD     // ops::simd::matmul_f32_range_simd (AVX2)
+};
+
+const char* matmul_kernel_name(MatmulKernel k);
+std::optional<MatmulKernel> matmul_kernel_from_name(const std::string& s);
+
+/**
+ * Perfil de execução por host/modelo produzido por `engine tune`.
+ *
+ * Salvo em texto (key=value) em:
+ *   $ENGINE_TUNE_DIR ou $XDG_CACHE_HOME/engine/tune ou ~/.cache/engine/tune
+ * com nome <host>__<modelo>.profile, e carregado pelo CpuBackend no load_model.
+ */
+struct TuningProfile {
+    std::string host;
+    std::string model;
+
+    int threads = 0;
+    MatmulKernel kernel = MatmulKernel::SCALAR;
+
+    // Medições do melhor ponto (informativas)
+    double tokens_per_sec = 0.0;
+    double tokens_per_joule = 0.0;
+
+    static std::string current_host();
+    static std::string model_id(const std::string& model_path);
+
+    // Diretório de cache por host (perfis, probe de banda)
+    static std::string cache_dir();
+
+    // Caminho do perfil para (host atual, modelo)
+    static std::string path_for(const std::string& model_path);
+
+    static std::optional<TuningProfile> load(const std::string& path);
+    bool save(const std::string& path) const;
+};
+
+} // namespace engine
@@ -3,11 +3,29 @@
 
 #include "core/engine.h"
 #include "core/execution_plan.h"
+#include "core/logger.h"
+#include "core/thread_pool.h"
 #include "core/version.h"
+#include "model/gguf_inspector.h"
+#include "model/grammar.h"
 #include "model/quantization_utils.h"
 #include "model/sampler.h"
+#include "model/tokenizer.h"
 #include "scheduler/scheduler.h"
 #include "backend/cpu/cpu_backend.h"
+#include "backend/cpu/autotuner.h"
+#include "backend/cpu/roofline.h"
+#include "metrics/bandwidth_probe.h"
+#include "metrics/metrics_registry.h"
+#include "metrics/metrics_server.h"
+#include "metrics/perf_counters.h"
+#include "metrics/profiler.h"
+
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <vector>
 
 static void print_usage() {
     std::cerr <<
@@ -15,15 +33,200 @@ static void print_usage() {
         "  engine run --model <path> [options]\n"
         "  engine generate --model <path> --prompt <text> [options]\n"
         "  engine scheduler --model <path> [options]\n"
+        "  engine tune --model <path> [--tune-tokens <n>] [--tune-threads <a,b,...>]\n"
+        "  engine bench --model <path> --roofline [--bench-tokens <n>] [--reprobe]\n"
+        "  engine inspect --model <path> --estimate [--ctx <n>] [--batch <n>] [--reprobe]\n"
         "  engine --version\n\n"
         "Options:\n"
         "  --model <path>        Path to GGUF model\n"
         "  --prompt <text>       Prompt for generation\n"
         "  --max-tokens <n>      Max tokens (default: 16)\n"
         "  --backend <type>      Backend type (default: cpu)\n"
-        "  --temperature <f>     Sampling temperature (default: 1.0)\n"
-        "  --top-k <n>           Top-k sampling (default: 40)\n"
-        "  --top-p <f>           Top-p sampling (default: 0.95)\n";
+        "  --threads <n>         Worker threads (default: all cores)\n"
+        "  --prefill-threads <n> Threads for prompt prefill (default: all)\n"
+        "  --decode-threads <n>  Threads for decode (default: tuned or half)\n"
+        "  --max-watts <w>       Power cap enforced by the governor (needs RAPL)\n"
+        "  --max-joules <j>      Energy budget per request (stops generation)\n"
+        "  --energy-interval-ms <n> RAPL sampling period (default: 50)\n"
+        "  --nan-check <m>       NaN/Inf check of activations: off, always or N\n"
+        "                        (every N forward passes; default: 32)\n"
+        "  --metrics-port <n>    Serve OpenMetrics on 127.0.0.1:<n> while running\n"
+        "  --metrics-socket <p>  Serve OpenMetrics on a Unix socket while running\n"
+        "  --log-level <l>       trace|debug|info|warn|error|off (default: info,\n"
+        "                        or ENGINE_LOG_LEVEL)\n"
+        "  --memory-budget-mb <n> Scheduler: RAM for the model plus KV reservations\n"
+        "  --kv-budget-mb <n>    Scheduler: KV bytes for concurrent jobs (overrides)\n"
+        "  --admission <p>       Scheduler when the KV budget is full: queue | reject\n"
+        "  --prompt-tokens <n>   Scheduler: prompt length charged to each job's KV\n"
+        "                        reservation (default: --prompt tokenized, else 0)\n"
+        "  --temperature <f>     Sampling temperature, <= 0 is greedy (default: 1.0)\n"
+        "  --top-k <n>           Keep the k most likely tokens (default: off)\n"
+        "  --top-p <f>           Nucleus sampling threshold (default: off)\n"
+        "  --min-p <f>           Drop tokens with p < min_p * p_max (default: off)\n"
+        "  --repeat-penalty <f>  Penalty for recently seen tokens (default: 1.0)\n"
+        "  --frequency-penalty <f> Subtract count * f from seen tokens\n"
+        "  --presence-penalty <f> Subtract f from seen tokens\n"
+        "  --repeat-last-n <n>   History window for the penalties (default: 64)\n"
+        "  --logit-bias <t=b,...> Add b to the logit of token t (-inf bans it)\n"
+        "  --samplers <list>     Stage order (default: penalties,logit_bias,top_k,\n"
+        "                        min_p,top_p,temperature)\n"
+        "  --grammar <file>      Constrain output to a GBNF grammar (rule root)\n"
+        "  --json                Constrain output to a JSON object\n"
+        "  --stop <text>         Stop before <text> (repeatable; \\n, \\t, \\\\ escapes)\n"
+        "  --profile <prefix>    Write <prefix>.json (per-op summary) and\n"
+        "                        <prefix>.trace.json (Chrome trace) for generate\n"
+        "  --perf-counters       Per-layer IPC / LLC misses / branch misses\n"
+        "                        via perf_event_open (generate)\n";
+}
+
+static void print_perf_regions(const std::vector<engine::PerfSample>& regions) {
+    if (regions.empty()) return;
+
+    std::cout << "\nHardware counters (per layer, summed over tokens and threads):\n";
+    std::cout << "  region        time_ms      IPC   LLC_miss  branch_miss  est_GB/s\n";
+
+    engine::PerfSample total;
+    for (size_t i = 0; i < regions.size(); ++i) {
+        const auto& r = regions[i];
+        total += r;
+
+        const std::string name = (i + 1 == regions.size())
+            ? "output_proj"
+            : "layer " + std::to_string(i);
+
+        std::printf("  %-12s %8.3f %8.2f %10llu %12llu %9.2f\n",
+                    name.c_str(), r.time_ns / 1e6, r.ipc(),
+                    static_cast<unsigned long long>(r.llc_misses),
+                    static_cast<unsigned long long>(r.branch_misses),
+                    r.est_gbps());
+    }
+
+    std::printf("  %-12s %8.3f %8.2f %10llu %12llu %9.2f\n",
+                "total", total.time_ns / 1e6, total.ipc(),
+                static_cast<unsigned long long>(total.llc_misses),
+                static_cast<unsigned long long>(total.branch_misses),
+                total.est_gbps());
+}
+
+static void print_roofline(const engine::Roofline::Report& r) {
+    std::printf("\nMachine peak (STREAM-style, %d threads, %zu MB): read %.2f GB/s, triad %.2f GB/s\n",
+                r.peak.threads, r.peak.array_mb, r.peak.read_gbps, r.peak.triad_gbps);
+    std::printf("  %s %s\n", r.peak_cached ? "cached:" : "saved: ", r.peak_path.c_str());
+    std::printf("Weights per decode token: %.2f MB streamed (F32 after dequant), %.2f MB in GGUF\n",
+                r.streamed_bytes_per_token / 1e6, r.gguf_bytes_per_token / 1e6);
+
+    for (const auto& k : r.kernels) {
+        std::printf("\nkernel=%s  tokens/s=%.2f  achieved=%.2f GB/s  (%.1f%% of read peak)\n",
+                    engine::matmul_kernel_name(k.kernel), k.tokens_per_sec, k.gbps,
+                    100.0 * k.fraction_of_peak);
+        std::printf("  region         MB/token  ms/token     GB/s   %%peak\n");
+        for (const auto& reg : k.regions) {
+            std::printf("  %-12s %10.3f %9.4f %8.2f %7.1f\n",
+                        reg.name.c_str(), reg.bytes_per_token / 1e6, reg.ms_per_token,
+                        reg.gbps, 100.0 * reg.fraction_of_peak);
+        }
+    }
+
+    for (const auto& k : r.kernels) {
+        if (k.fraction_of_peak > 1.0) {
+            std::printf("\nNote: >100%% of peak means the weights are cache-resident "
+                        "(model smaller than the LLC); the DRAM ceiling does not apply.\n");
+            break;
+        }
+    }
+}
+
+// --log-level vale para todos os comandos e sobrepõe ENGINE_LOG_LEVEL
+static bool apply_log_level(int argc, char** argv) {
+    for (int i = 2; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) != "--log-level") continue;
+
+        const auto level = engine::log_level_from_name(argv[++i]);
+        if (!level) {
+            std::cerr << "Error: unknown log level: " << argv[i] << "\n";
+            return false;
+        }
+        engine::Logger::set_level(*level);
+    }
+    return true;
+}
+
+// Endpoint OpenMetrics opcional (vive enquanto o comando roda)
+static bool start_metrics_endpoint(int argc, char** argv, engine::MetricsServer& server) {
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        bool ok = true;
+
+        if (arg == "--metrics-port" && i + 1 < argc) {
+            ok = server.start_tcp(static_cast<uint16_t>(std::stoul(argv[++i])));
+            if (ok) ENGINE_LOG_INFO("metrics", "serving on 127.0.0.1:" << server.port());
+        }
+        else if (arg == "--metrics-socket" && i + 1 < argc) {
+            const std::string path = argv[++i];
+            ok = server.start_unix(path);
+            if (ok) ENGINE_LOG_INFO("metrics", "serving on unix:" << path);
+        }
+        else {
+            continue;
+        }
+
+        if (!ok) {
+            std::cerr << "Error: metrics endpoint: " << server.error() << "\n";
+            return false;
+        }
+        return true;
+    }
+    return true;
+}
+
+// Banda do host (cache do probe do roofline); mede com o pool inteiro se faltar
+static engine::BandwidthProfile host_bandwidth(bool reprobe) {
+    const std::string path = engine::Roofline::probe_path();
+
+    if (!reprobe) {
+        if (auto p = engine::BandwidthProfile::load(path); p.has_value()) return *p;
+    }
+
+    engine::ThreadPool pool;
+    engine::BandwidthProfile p = engine::BandwidthProbe::run(pool, {});
+    p.host = engine::TuningProfile::current_host();
+    if (!p.save(path)) {
+        ENGINE_LOG_WARN("cli", "cannot cache bandwidth probe: " << path);
+    }
+    return p;
+}
+
+static void print_estimate(const engine::GgufEstimate& e) {
+    const double MiB = 1024.0 * 1024.0;
+
+    std::printf("Model: layers=%u embd=%u vocab=%u  context=%u batch=%u\n",
+                e.n_layers, e.n_embd, e.n_vocab, e.context, e.batch);
+    std::printf("Weights by type:\n");
+    for (const auto& t : e.weights_by_type) {
+        std::printf("  %-8s %5llu tensors  %10.2f MiB\n", t.type.c_str(),
+                    static_cast<unsigned long long>(t.tensors), t.bytes / MiB);
+    }
+    std::printf("Memory (MiB):\n");
+    std::printf("  weights (mmap)  %10.2f\n", e.weights_bytes / MiB);
+    std::printf("  dequant (F32)   %10.2f\n", e.dequant_bytes / MiB);
+    std::printf("  KV cache        %10.2f\n", e.kv_bytes / MiB);
+    std::printf("  scratch         %10.2f\n", e.scratch_bytes / MiB);
+    std::printf("  total           %10.2f\n", e.total_bytes() / MiB);
+    std::printf("Decode: %.2f MB/token streamed", e.streamed_bytes_per_token / 1e6);
+    if (e.tokens_per_sec > 0.0) {
+        std::printf(", host read %.2f GB/s -> <= %.1f tokens/s\n", e.bandwidth_gbps, e.tokens_per_sec);
+    } else {
+        std::printf("\n");
+    }
+
+    std::printf("{ \"weights_bytes\": %llu, \"dequant_bytes\": %llu, \"kv_bytes\": %llu, "
+                "\"scratch_bytes\": %llu, \"total_bytes\": %llu, \"tokens_per_sec\": %.2f }\n",
+                static_cast<unsigned long long>(e.weights_bytes),
+                static_cast<unsigned long long>(e.dequant_bytes),
+                static_cast<unsigned long long>(e.kv_bytes),
+                static_cast<unsigned long long>(e.scratch_bytes),
+                static_cast<unsigned long long>(e.total_bytes()),
+                e.tokens_per_sec);
 }
 
 static bool parse_common_args(
@@ -44,14 +247,69 @@ static bool parse_common_args(
         else if (arg == "--backend" && i + 1 < argc) {
             plan.backend = argv[++i];
         }
+        else if (arg == "--threads" && i + 1 < argc) {
+            plan.n_threads = std::stoul(argv[++i]);
+        }
+        else if (arg == "--prefill-threads" && i + 1 < argc) {
+            plan.prefill_threads = std::stoul(argv[++i]);
+        }
+        else if (arg == "--decode-threads" && i + 1 < argc) {
+            plan.decode_threads = std::stoul(argv[++i]);
+        }
+        else if (arg == "--max-watts" && i + 1 < argc) {
+            plan.power.max_watts = std::stod(argv[++i]);
+        }
+        else if (arg == "--energy-interval-ms" && i + 1 < argc) {
+            plan.power.sample_interval_ms = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--nan-check" && i + 1 < argc) {
+            const std::string mode = argv[++i];
+            if (mode == "off") {
+                plan.numerics.mode = core::NumericsCheckMode::OFF;
+            } else if (mode == "always") {
+                plan.numerics.mode = core::NumericsCheckMode::ALWAYS;
+            } else {
+                plan.numerics.mode = core::NumericsCheckMode::EVERY_N;
+                plan.numerics.interval = static_cast<uint32_t>(std::stoul(mode));
+            }
+        }
+        else if (arg == "--max-joules" && i + 1 < argc) {
+            plan.power.max_joules_per_request = std::stod(argv[++i]);
+        }
     }
 
     return !model_path.empty();
 }
 
-static engine::SamplingConfig parse_sampling_args(int argc, char** argv) {
+static std::vector<int> parse_int_list(const std::string& v) {
+    std::vector<int> out;
+    std::stringstream ss(v);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(std::stoi(item));
+    }
+    return out;
+}
+
+// "\n", "\t" e "\\" da linha de comando viram os caracteres
+static std::string unescape(const std::string& v) {
+    std::string out;
+    for (size_t i = 0; i < v.size(); ++i) {
+        if (v[i] == '\\' && i + 1 < v.size()) {
+            const char c = v[++i];
+            out += c == 'n' ? '\n' : c == 't' ? '\t' : c;
+        } else {
+            out += v[i];
+        }
+    }
+    return out;
+}
+
+static std::optional<engine::SamplingConfig> parse_sampling_args(int argc, char** argv) {
     engine::SamplingConfig config;
-    config.strategy = engine::SamplingStrategy::TEMPERATURE;
+    config.strategy = engine::SamplingStrategy::CHAIN;
+    config.top_k = 0;      // estágios desligados até serem pedidos
+    config.top_p = 1.0f;
 
     for (int i = 2; i < argc; ++i) {
         std::string arg = argv[i];
@@ -61,11 +319,47 @@ static engine::SamplingConfig parse_sampling_args(int argc, char** argv) {
         }
         else if (arg == "--top-k" && i + 1 < argc) {
             config.top_k = std::stoi(argv[++i]);
-            config.strategy = engine::SamplingStrategy::TOP_K;
         }
         else if (arg == "--top-p" && i + 1 < argc) {
             config.top_p = std::stof(argv[++i]);
-            config.strategy = engine::SamplingStrategy::TOP_P;
+        }
+        else if (arg == "--min-p" && i + 1 < argc) {
+            config.min_p = std::stof(argv[++i]);
+        }
+        else if (arg == "--repeat-penalty" && i + 1 < argc) {
+            config.repeat_penalty = std::stof(argv[++i]);
+        }
+        else if (arg == "--frequency-penalty" && i + 1 < argc) {
+            config.frequency_penalty = std::stof(argv[++i]);
+        }
+        else if (arg == "--presence-penalty" && i + 1 < argc) {
+            config.presence_penalty = std::stof(argv[++i]);
+        }
+        else if (arg == "--repeat-last-n" && i + 1 < argc) {
+            config.penalty_last_n = std::stoi(argv[++i]);
+        }
+        else if (arg == "--logit-bias" && i + 1 < argc) {
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                const auto eq = item.find('=');
+                if (eq == std::string::npos) {
+                    std::cerr << "Error: --logit-bias expects token=bias, got: " << item << "\n";
+                    return std::nullopt;
+                }
+                config.logit_bias.push_back({
+                    static_cast<int32_t>(std::stol(item.substr(0, eq))),
+                    std::stof(item.substr(eq + 1))
+                });
+            }
+        }
+        else if (arg == "--samplers" && i + 1 < argc) {
+            auto chain = engine::parse_sampler_chain(argv[++i]);
+            if (!chain) {
+                std::cerr << "Error: unknown sampler stage in: " << argv[i] << "\n";
+                return std::nullopt;
+            }
+            config.chain = std::move(*chain);
         }
     }
 
@@ -95,6 +389,20 @@ int main(int argc, char** argv) {
         return 0;
     }
 
+    if (command == "--help" || command == "-h") {
+        print_usage();
+        return 0;
+    }
+
+    if (!apply_log_level(argc, argv)) {
+        return 2;
+    }
+
+    engine::MetricsServer metrics_server(engine::MetricsRegistry::global());
+    if (!start_metrics_endpoint(argc, argv, metrics_server)) {
+        return 2;
+    }
+
     /* ───────────────────────────────────────────── */
     if (command == "run") {
         if (!parse_common_args(argc, argv, model_path, plan)) {
@@ -130,14 +438,90 @@ int main(int argc, char** argv) {
 
         // Parsing de sampling
         auto sampling_config = parse_sampling_args(argc, argv);
+        if (!sampling_config) {
+            return 2;
+        }
+
+        // Decodificação restrita
+        std::shared_ptr<const engine::Grammar> grammar;
+        std::vector<std::string> stop_strings;
+        try {
+            for (int i = 2; i < argc; ++i) {
+                const std::string arg = argv[i];
+                if (arg == "--json") {
+                    grammar = engine::Grammar::json();
+                } else if (arg == "--grammar" && i + 1 < argc) {
+                    std::ifstream f(argv[++i]);
+                    if (!f) {
+                        std::cerr << "Error: cannot read grammar file: " << argv[i] << "\n";
+                        return 2;
+                    }
+                    std::stringstream text;
+                    text << f.rdbuf();
+                    grammar = engine::Grammar::parse(text.str());
+                } else if (arg == "--stop" && i + 1 < argc) {
+                    stop_strings.push_back(unescape(argv[++i]));
+                }
+            }
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 2;
+        }
+
+        std::string profile_prefix;
+        bool perf_counters = false;
+        for (int i = 2; i < argc; ++i) {
+            if (std::string(argv[i]) == "--profile" && i + 1 < argc) {
+                profile_prefix = argv[++i];
+            } else if (std::string(argv[i]) == "--perf-counters") {
+                perf_counters = true;
+            }
+        }
 
         // Cria backend diretamente para usar generate()
-        engine::CpuBackend backend;
+        engine::CpuBackend backend(plan);
         backend.init();
         backend.load_model(model_path);
 
+        if (!profile_prefix.empty()) {
+#ifdef ENGINE_PROFILING
+            engine::Profiler::reset();
+            engine::Profiler::set_enabled(true);
+#else
+            ENGINE_LOG_WARN("cli", "--profile ignored (built without ENGINE_PROFILING)");
+#endif
+        }
+
+        if (perf_counters && !engine::PerfCounters::enable()) {
+            ENGINE_LOG_WARN("cli", "--perf-counters unavailable: " << engine::PerfCounters::error());
+        }
+
+        // Energia por domínio RAPL (package, core, uncore, dram por socket)
+        const engine::PowerLinux* meter = backend.power_meter();
+        const auto domains_before = meter ? meter->read_domains()
+                                          : std::vector<engine::PowerLinux::DomainReading>{};
+
         // Gera texto
-        std::string result = backend.generate(prompt, plan.max_tokens, sampling_config);
+        std::string result = backend.generate(prompt, plan.max_tokens, *sampling_config, grammar, stop_strings);
+
+        const auto domains_after = meter ? meter->read_domains()
+                                         : std::vector<engine::PowerLinux::DomainReading>{};
+
+        engine::Logger::flush();  // diagnósticos antes da saída do programa
+
+        if (engine::Profiler::enabled()) {
+            engine::Profiler::set_enabled(false);
+
+            const std::string summary = profile_prefix + ".json";
+            const std::string trace = profile_prefix + ".trace.json";
+
+            if (!engine::Profiler::write_summary_json(summary) ||
+                !engine::Profiler::write_chrome_trace(trace)) {
+                std::cerr << "Error: cannot write profile to " << profile_prefix << ".*\n";
+                return 1;
+            }
+            std::cout << "Profile: " << summary << ", " << trace << "\n";
+        }
 
         // Output
         std::cout << "\n=== Generated Text ===\n";
@@ -150,12 +534,182 @@ int main(int argc, char** argv) {
         std::cout << "  Tokens: " << stats.tokens_total << "\n";
         std::cout << "  Time: " << stats.exec_time_ms << " ms\n";
         std::cout << "  Tokens/sec: " << stats.tokens_per_sec << "\n";
+        std::cout << "  TTFT: " << stats.ttft_ms << " ms\n";
+        std::cout << "  ITL p50/p90/p99/max: " << stats.itl_p50_ms << " / "
+                  << stats.itl_p90_ms << " / " << stats.itl_p99_ms << " / "
+                  << stats.itl_max_ms << " ms\n";
 
         if (stats.watts_avg > 0) {
             std::cout << "  Power: " << stats.watts_avg << " W\n";
+            std::cout << "  Energy: " << stats.energy_total_joules << " J (prefill "
+                      << stats.energy_prefill_joules << " J, decode "
+                      << stats.energy_decode_joules << " J)\n";
             std::cout << "  Tokens/Watt: " << stats.tokens_per_watt << "\n";
+            std::cout << "  Joules/token: " << stats.joules_per_token << "\n";
+        }
+
+        const auto& mem = stats.memory;
+        const double MiB = 1024.0 * 1024.0;
+        std::cout << "  Memory (MiB): weights " << mem.weights_resident / MiB
+                  << " resident / " << mem.weights_mapped / MiB << " mapped, dequant "
+                  << mem.dequant / MiB << ", KV " << mem.kv_cache / MiB
+                  << ", scratch " << mem.scratch / MiB << "\n";
+        std::cout << "  RSS: " << mem.rss / MiB << " MiB (peak " << mem.peak_rss / MiB << " MiB)\n";
+
+        if (!domains_after.empty() && domains_after.size() == domains_before.size()) {
+            std::cout << "  Energy by domain:\n";
+            for (size_t i = 0; i < domains_after.size(); ++i) {
+                const auto* d = domains_after[i].domain;
+                std::cout << "    " << d->zone << " (" << d->name << "): "
+                          << (domains_after[i].joules - domains_before[i].joules) << " J\n";
+            }
+        }
+
+        std::cout << "{ \"tokens\": " << stats.tokens_total
+                  << ", \"prompt_tokens\": " << stats.prompt_tokens
+                  << ", \"exec_time_ms\": " << stats.exec_time_ms
+                  << ", \"tokens_per_sec\": " << stats.tokens_per_sec
+                  << ", \"ttft_ms\": " << stats.ttft_ms
+                  << ", \"itl_p50_ms\": " << stats.itl_p50_ms
+                  << ", \"itl_p90_ms\": " << stats.itl_p90_ms
+                  << ", \"itl_p99_ms\": " << stats.itl_p99_ms
+                  << ", \"itl_max_ms\": " << stats.itl_max_ms
+                  << ", \"watts_avg\": " << stats.watts_avg
+                  << ", \"energy_total_joules\": " << stats.energy_total_joules
+                  << ", \"energy_prefill_joules\": " << stats.energy_prefill_joules
+                  << ", \"energy_decode_joules\": " << stats.energy_decode_joules
+                  << ", \"tokens_per_watt\": " << stats.tokens_per_watt
+                  << ", \"joules_per_token\": " << stats.joules_per_token
+                  << ", \"resident_bytes\": " << stats.memory.resident_total()
+                  << ", \"peak_rss_bytes\": " << stats.memory.peak_rss << " }\n";
+
+        if (engine::PerfCounters::enabled()) {
+            engine::PerfCounters::disable();
+            print_perf_regions(backend.perf_regions());
+        }
+
+        return 0;
+    }
+
+    /* ───────────────────────────────────────────── */
+    if (command == "tune") {
+        if (!parse_common_args(argc, argv, model_path, plan)) {
+            print_usage();
+            return 2;
+        }
+
+        engine::Autotuner::Options options;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--tune-tokens" && i + 1 < argc) {
+                options.tokens_per_trial = std::stoi(argv[++i]);
+            }
+            else if (arg == "--tune-threads" && i + 1 < argc) {
+                options.thread_counts = parse_int_list(argv[++i]);
+            }
+        }
+
+        engine::CpuBackend backend(plan);
+        backend.init();
+        backend.load_model(model_path);
+
+        engine::Autotuner tuner(backend);
+        auto profile = tuner.run(model_path, options);
+
+        const std::string path = engine::TuningProfile::path_for(model_path);
+        if (!profile.save(path)) {
+            std::cerr << "Error: cannot write tuning profile: " << path << "\n";
+            return 1;
+        }
+
+        engine::Logger::flush();
+        std::cout << "\nBest: threads=" << profile.threads
+                  << " kernel=" << engine::matmul_kernel_name(profile.kernel)
+                  << " tokens/s=" << profile.tokens_per_sec
+                  << " tokens/J=" << profile.tokens_per_joule << "\n";
+        std::cout << "Profile saved: " << path << "\n";
+        return 0;
+    }
+
+    /* ───────────────────────────────────────────── */
+    if (command == "bench") {
+        if (!parse_common_args(argc, argv, model_path, plan)) {
+            print_usage();
+            return 2;
         }
 
+        bool roofline = false;
+        engine::Roofline::Options options;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--roofline") {
+                roofline = true;
+            }
+            else if (arg == "--bench-tokens" && i + 1 < argc) {
+                options.tokens = std::stoi(argv[++i]);
+            }
+            else if (arg == "--reprobe") {
+                options.reprobe = true;
+            }
+        }
+
+        if (!roofline) {
+            std::cerr << "Error: bench needs a mode (--roofline)\n";
+            return 2;
+        }
+
+        engine::CpuBackend backend(plan);
+        backend.init();
+        backend.load_model(model_path);
+
+        engine::Roofline bench(backend);
+        const auto report = bench.run(options);
+        engine::Logger::flush();
+        print_roofline(report);
+        return 0;
+    }
+
+    /* ───────────────────────────────────────────── */
+    if (command == "inspect") {
+        if (!parse_common_args(argc, argv, model_path, plan)) {
+            print_usage();
+            return 2;
+        }
+
+        bool estimate = false;
+        bool reprobe = false;
+        engine::GgufEstimateOptions options;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--estimate") {
+                estimate = true;
+            }
+            else if (arg == "--ctx" && i + 1 < argc) {
+                options.context = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--batch" && i + 1 < argc) {
+                options.batch = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--reprobe") {
+                reprobe = true;
+            }
+        }
+
+        if (!estimate) {
+            std::cerr << "Error: inspect needs a mode (--estimate)\n";
+            return 2;
+        }
+
+        options.bandwidth_gbps = host_bandwidth(reprobe).read_gbps;
+
+        try {
+            const auto e = engine::GgufInspector::estimate(model_path, options);
+            engine::Logger::flush();
+            print_estimate(e);
+        } catch (const std::exception& ex) {
+            std::cerr << "Error: " << ex.what() << "\n";
+            return 1;
+        }
         return 0;
     }
 
@@ -166,14 +720,52 @@ int main(int argc, char** argv) {
             return 2;
         }
 
-        engine::Scheduler scheduler;
+        engine::SchedulerConfig sc;
+        sc.model_path = model_path;
+        std::string prompt;
+        std::optional<uint32_t> prompt_tokens;
+        for (int i = 2; i + 1 < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--prompt") {
+                prompt = argv[++i];
+            } else if (arg == "--prompt-tokens") {
+                prompt_tokens = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--memory-budget-mb") {
+                sc.memory_budget_bytes = std::stoull(argv[++i]) * 1024ull * 1024ull;
+            } else if (arg == "--kv-budget-mb") {
+                sc.kv_budget_bytes = std::stoull(argv[++i]) * 1024ull * 1024ull;
+            } else if (arg == "--admission") {
+                sc.policy = std::string(argv[++i]) == "reject" ? engine::AdmissionPolicy::REJECT
+                                                               : engine::AdmissionPolicy::QUEUE;
+            }
+        }
+
+        // A reserva de KV de cada job inclui o prompt
+        if (!prompt_tokens && !prompt.empty()) {
+            engine::SimpleTokenizer tokenizer;
+            if (tokenizer.load_from_gguf(model_path)) {
+                prompt_tokens = static_cast<uint32_t>(tokenizer.encode(prompt).size());
+            } else {
+                std::cerr << "Warning: no tokenizer in " << model_path
+                          << "; prompt not charged to the KV reservation\n";
+            }
+        }
+        plan.prompt_tokens = prompt_tokens.value_or(0);
+
+        engine::Scheduler scheduler(sc);
 
         core::ExecutionPlan p1 = plan;
         core::ExecutionPlan p2 = plan;
         p2.max_tokens = plan.max_tokens * 2;
 
-        scheduler.submit(p1, 1);
-        scheduler.submit(p2, 10);
+        for (const auto& [p, priority] : {std::pair{p1, 1}, std::pair{p2, 10}}) {
+            const auto a = scheduler.try_submit(p, priority);
+            if (!a.accepted) {
+                std::cout << "rejected: " << a.reason;
+                if (a.retry_after_s > 0.0) std::cout << " (retry after " << a.retry_after_s << " s)";
+                std::cout << "\n";
+            }
+        }
 
         while (!scheduler.empty()) {
             scheduler.run_batch();
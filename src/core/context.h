@@ -4,17 +4,46 @@
 
 namespace engine {
 
+    // Memória por componente, em bytes. "mapped" é o GGUF em mmap (só entra
+    // em RAM sob demanda); o resto é alocado e residente.
+    struct MemoryReport {
+        uint64_t weights_mapped = 0;
+        uint64_t weights_resident = 0;   // páginas do mapeamento em RAM
+        uint64_t dequant = 0;            // cópias F32 dos pesos quantizados
+        uint64_t kv_cache = 0;
+        uint64_t scratch = 0;            // buffers de trabalho do forward
+        uint64_t rss = 0;                // processo inteiro
+        uint64_t peak_rss = 0;           // pico do último run (ou do processo)
+
+        uint64_t resident_total() const {
+            return weights_resident + dequant + kv_cache + scratch;
+        }
+    };
+
     struct BackendStats {
         uint64_t tokens_total = 0;
+        uint64_t prompt_tokens = 0;
         double exec_time_ms = 0.0;
 
         // Métricas derivadas
         double tokens_per_sec = 0.0;
 
+        // Latência (SLOs): time-to-first-token e inter-token latency
+        double ttft_ms = 0.0;
+        double itl_p50_ms = 0.0;
+        double itl_p90_ms = 0.0;
+        double itl_p99_ms = 0.0;
+        double itl_max_ms = 0.0;
+
         // Energia (quando disponível)
         double watts_avg = 0.0;
-        double tokens_per_watt = 0.0;
+        double tokens_per_watt = 0.0;       // tokens/s por watt = tokens/J
         double energy_total_joules = 0.0;
+        double energy_prefill_joules = 0.0;
+        double energy_decode_joules = 0.0;
+        double joules_per_token = 0.0;      // base de faturamento por token gerado
+
+        MemoryReport memory;
     };
 
 } // namespace engine
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include "../backend/backend_factory.h"
 #include "../backend/backend.h"
 #include "../backend/tensor.h"
+#include "../model/sampler.h"
+#include "./logger.h"
 
 #include <iostream>
+#include <vector>
 
 namespace engine {
 
@@ -15,8 +18,8 @@ void Engine::run(const std::string& model_path, const core::ExecutionPlan& plan)
     std::cout << "Iniciando WeOS...\n";
 
     // logs técnicos (opcional manter)
-    std::cout << "[weos] backend: " << plan.backend << "\n";
-    std::cout << "[weos] max_tokens: " << plan.max_tokens << "\n";
+    ENGINE_LOG_INFO("weos", "backend: " << plan.backend);
+    ENGINE_LOG_INFO("weos", "max_tokens: " << plan.max_tokens);
 
     auto backend = BackendFactory::create(plan);
 
@@ -24,20 +27,45 @@ void Engine::run(const std::string& model_path, const core::ExecutionPlan& plan)
     auto model_info = backend->load_model(model_path);
 
 
-    std::cout << "[engine] model context: " << model_info.context_length << "\n";
-    std::cout << "[engine] model embedding: " << model_info.embedding_dim << "\n";
+    ENGINE_LOG_INFO("engine", "model context: " << model_info.context_length);
+    ENGINE_LOG_INFO("engine", "model embedding: " << model_info.embedding_dim);
 
-    TensorView in{};
-    TensorView out{};
+    // Run loop: greedy a partir do token 1 (BOS na maioria dos vocabulários)
+    std::vector<float> logits(model_info.vocab_size);
+    Sampler greedy;
+    int32_t token = model_info.vocab_size > 1 ? 1 : 0;
+
+    backend->set_phase(ExecutionPhase::DECODE);
 
     for (uint32_t i = 0; i < plan.max_tokens; ++i) {
+        TensorView in{};
+        in.data = &token;
+        in.shape = {1};
+
+        TensorView out{};
+        out.data = logits.data();
+        out.shape = {model_info.vocab_size};
+
         backend->forward(in, out);
+        token = greedy.sample(logits);
     }
 
     auto stats = backend->stats();
-    std::cout << "[engine] execution complete\n";
+    ENGINE_LOG_INFO("engine", "execution complete");
+    Logger::flush();
     std::cout << "{ \"tokens\": " << stats.tokens_total
-              << ", \"exec_time_ms\": " << stats.exec_time_ms << " }\n";
+              << ", \"exec_time_ms\": " << stats.exec_time_ms
+              << ", \"tokens_per_sec\": " << stats.tokens_per_sec
+              << ", \"ttft_ms\": " << stats.ttft_ms
+              << ", \"itl_p50_ms\": " << stats.itl_p50_ms
+              << ", \"itl_p90_ms\": " << stats.itl_p90_ms
+              << ", \"itl_p99_ms\": " << stats.itl_p99_ms
+              << ", \"itl_max_ms\": " << stats.itl_max_ms
+              << ", \"watts_avg\": " << stats.watts_avg
+              << ", \"energy_total_joules\": " << stats.energy_total_joules
+              << ", \"tokens_per_watt\": " << stats.tokens_per_watt
+              << ", \"resident_bytes\": " << stats.memory.resident_total()
+              << ", \"peak_rss_bytes\": " << stats.memory.peak_rss << " }\n";
 }
 
 } // namespace engine
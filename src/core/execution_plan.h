@@ -15,7 +15,21 @@ enum class QuantizationPolicy {
 };
 
 struct PowerLimits {
-    double max_watts = 0.0;
+    double max_watts = 0.0;               // 0 = sem cap (governador desligado)
+    double max_joules_per_request = 0.0;  // 0 = sem orçamento de energia
+    uint32_t sample_interval_ms = 50;     // período do amostrador de energia (RAPL)
+};
+
+// Verificação de NaN/Inf nas ativações do forward (CPU)
+enum class NumericsCheckMode {
+    OFF,
+    EVERY_N,  // um forward a cada `interval`
+    ALWAYS
+};
+
+struct NumericsCheck {
+    NumericsCheckMode mode = NumericsCheckMode::EVERY_N;
+    uint32_t interval = 32;
 };
 
 struct ExecutionPlan {
@@ -24,7 +38,13 @@ struct ExecutionPlan {
     engine::QuantizationType quantization;
 
     uint32_t max_tokens;
+    uint32_t prompt_tokens = 0;    // conhecido antes do prefill (admissão por KV)
     PowerLimits power;
+    NumericsCheck numerics;
+
+    uint32_t n_threads = 0;        // 0 = hardware_concurrency
+    uint32_t prefill_threads = 0;  // 0 = todas as threads do pool
+    uint32_t decode_threads = 0;   // 0 = perfil de tuning ou metade do pool
 
     std::string scheduler_policy;
     bool streaming = true;
@@ -0,0 +1,222 @@
+#include "core/logger.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+namespace {
+
+LogLevel initial_level() {
+    if (const char* env = std::getenv("ENGINE_LOG_LEVEL"); env && *env) {
+        if (auto l = log_level_from_name(env)) return *l;
+    }
+    return LogLevel::INFO;
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count()
+    );
+}
+
+struct Record {
+    uint64_t ts_ns = 0;
+    LogLevel level = LogLevel::INFO;
+    const char* tag = "";
+    std::string text;
+};
+
+// SPSC: a thread dona produz; o consumidor é quem segura drain_mtx
+struct Ring {
+    static constexpr uint64_t SIZE = 1024;
+
+    std::array<Record, SIZE> slots;
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};  // a thread dona terminou
+};
+
+class Backend {
+public:
+    Backend() : start_ns_(now_ns()) {
+        thread_ = std::thread(&Backend::run, this);
+    }
+
+    ~Backend() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mtx_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        if (thread_.joinable()) thread_.join();
+        drain();
+    }
+
+    // O ring sobrevive à thread: ao sair, o dono só o marca como retired e
+    // drain() o devolve à lista livre depois de esvaziá-lo. Threads novas
+    // reaproveitam os livres, então o total acompanha o pico de threads
+    // vivas, não quantas já existiram (um pool novo por backend).
+    Ring& local_ring() {
+        struct Owner {
+            Ring* ring = nullptr;
+            ~Owner() {
+                if (ring) ring->retired.store(true, std::memory_order_release);
+            }
+        };
+        thread_local Owner owner;
+
+        if (!owner.ring) {
+            std::lock_guard<std::mutex> lock(rings_mtx_);
+            if (!free_.empty()) {
+                rings_.push_back(std::move(free_.back()));
+                free_.pop_back();
+            } else {
+                rings_.push_back(std::make_unique<Ring>());
+            }
+            owner.ring = rings_.back().get();
+        }
+        return *owner.ring;
+    }
+
+    void drain() {
+        std::lock_guard<std::mutex> lock(drain_mtx_);
+
+        batch_.clear();
+        uint64_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> rl(rings_mtx_);
+            for (size_t k = 0; k < rings_.size(); ) {
+                Ring& r = *rings_[k];
+
+                // Lido antes de head: retired visto => nada mais será escrito
+                const bool retired = r.retired.load(std::memory_order_acquire);
+
+                const uint64_t t = r.tail.load(std::memory_order_relaxed);
+                const uint64_t h = r.head.load(std::memory_order_acquire);
+                for (uint64_t i = t; i < h; ++i) {
+                    batch_.push_back(std::move(r.slots[i % Ring::SIZE]));
+                }
+                r.tail.store(h, std::memory_order_release);
+                dropped += r.dropped.exchange(0, std::memory_order_relaxed);
+
+                if (retired) {
+                    r.retired.store(false, std::memory_order_relaxed);
+                    std::swap(rings_[k], rings_.back());
+                    free_.push_back(std::move(rings_.back()));
+                    rings_.pop_back();
+                } else {
+                    ++k;
+                }
+            }
+        }
+
+        std::stable_sort(batch_.begin(), batch_.end(),
+                         [](const Record& a, const Record& b) { return a.ts_ns < b.ts_ns; });
+
+        for (const Record& rec : batch_) {
+            const double t = double(rec.ts_ns - std::min(rec.ts_ns, start_ns_)) / 1e9;
+            std::fprintf(stderr, "%9.4f %c [%s] %s\n",
+                         t, log_level_name(rec.level)[0], rec.tag, rec.text.c_str());
+        }
+        if (dropped > 0) {
+            std::fprintf(stderr, "          W [log] %llu messages dropped (ring full)\n",
+                         static_cast<unsigned long long>(dropped));
+        }
+        if (!batch_.empty() || dropped > 0) std::fflush(stderr);
+    }
+
+private:
+    uint64_t start_ns_;
+
+    std::mutex rings_mtx_;
+    std::vector<std::unique_ptr<Ring>> rings_;  // com thread dona (viva ou a drenar)
+    std::vector<std::unique_ptr<Ring>> free_;   // vazios, prontos para reuso
+
+    std::mutex drain_mtx_;
+    std::vector<Record> batch_;
+
+    std::thread thread_;
+    std::mutex wake_mtx_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(wake_mtx_);
+        while (!stop_) {
+            wake_.wait_for(lock, std::chrono::milliseconds(10), [this] { return stop_; });
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+};
+
+Backend& backend() {
+    static Backend b;
+    return b;
+}
+
+} // namespace
+
+std::atomic<int> Logger::level_{static_cast<int>(initial_level())};
+
+const char* log_level_name(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO";
+        case LogLevel::WARN:  return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::OFF:   return "OFF";
+    }
+    return "INFO";
+}
+
+std::optional<LogLevel> log_level_from_name(const std::string& s) {
+    std::string v = s;
+    std::transform(v.begin(), v.end(), v.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    if (v == "trace") return LogLevel::TRACE;
+    if (v == "debug") return LogLevel::DEBUG;
+    if (v == "info")  return LogLevel::INFO;
+    if (v == "warn" || v == "warning") return LogLevel::WARN;
+    if (v == "error") return LogLevel::ERROR;
+    if (v == "off")   return LogLevel::OFF;
+    return std::nullopt;
+}
+
+void Logger::write(LogLevel level, const char* tag, std::string text) {
+    Ring& r = backend().local_ring();
+
+    const uint64_t h = r.head.load(std::memory_order_relaxed);
+    if (h - r.tail.load(std::memory_order_acquire) >= Ring::SIZE) {
+        r.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& rec = r.slots[h % Ring::SIZE];
+    rec.ts_ns = now_ns();
+    rec.level = level;
+    rec.tag = tag;
+    rec.text = std::move(text);
+
+    r.head.store(h + 1, std::memory_order_release);
+}
+
+void Logger::flush() {
+    backend().drain();
+}
+
+} // namespace engine
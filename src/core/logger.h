@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+
+namespace engine {
+
+/**
+ * Logger assíncrono com níveis.
+ *
+ * - Nível de compilação (ENGINE_LOG_COMPILE_LEVEL, opção CMake): abaixo
+ *   dele as macros ENGINE_LOG_* somem do binário — custo zero.
+ * - Nível de runtime (--log-level / ENGINE_LOG_LEVEL): abaixo dele o custo
+ *   é um load relaxado e um branch; a mensagem nem é formatada.
+ * - Cada thread publica num ring buffer próprio (SPSC, sem lock); uma
+ *   thread de fundo drena os rings e escreve em stderr, em ordem de tempo.
+ *   Ring cheio descarta a mensagem (o hot path nunca bloqueia em I/O) e
+ *   o descarte é reportado na próxima drenagem. O ring de uma thread que
+ *   terminou é drenado e reaproveitado pela próxima thread que logar.
+ *
+ * Saída de programa (texto gerado, estatísticas, JSON) continua em stdout;
+ * o logger é só para diagnóstico.
+ */
+enum class LogLevel : int {
+    TRACE = 0,
+    DEBUG = 1,
+    INFO  = 2,
+    WARN  = 3,
+    ERROR = 4,
+    OFF   = 5
+};
+
+const char* log_level_name(LogLevel level);
+std::optional<LogLevel> log_level_from_name(const std::string& s);
+
+class Logger {
+public:
+    static void set_level(LogLevel level) {
+        level_.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+    static LogLevel level() {
+        return static_cast<LogLevel>(level_.load(std::memory_order_relaxed));
+    }
+    static bool enabled(LogLevel level) {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    // Publica no ring da thread corrente (não bloqueia).
+    static void write(LogLevel level, const char* tag, std::string text);
+
+    // Drena tudo que já foi publicado, de forma síncrona.
+    static void flush();
+
+private:
+    static std::atomic<int> level_;
+};
+
+// Acumula uma linha e publica no destrutor
+class LogLine {
+public:
+    LogLine(LogLevel level, const char* tag) : level_(level), tag_(tag) {}
+    ~LogLine() { Logger::write(level_, tag_, std::move(os_).str()); }
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    std::ostringstream& stream() { return os_; }
+
+private:
+    LogLevel level_;
+    const char* tag_;
+    std::ostringstream os_;
+};
+
+} // namespace engine
+
+#ifndef ENGINE_LOG_COMPILE_LEVEL
+#define ENGINE_LOG_COMPILE_LEVEL 1  // DEBUG: TRACE fica fora do binário
+#endif
+
+// Uso: ENGINE_LOG_INFO("cpu", "threads: " << n);
+#define ENGINE_LOG(level, tag, expr)                                              \
+    do {                                                                          \
+        if constexpr (static_cast<int>(level) >= ENGINE_LOG_COMPILE_LEVEL) {      \
+            if (::engine::Logger::enabled(level)) {                               \
+                ::engine::LogLine engine_log_line_(level, tag);                   \
+                engine_log_line_.stream() << expr;                                \
+            }                                                                     \
+        }                                                                         \
+    } while (0)
+
+#define ENGINE_LOG_TRACE(tag, expr) ENGINE_LOG(::engine::LogLevel::TRACE, tag, expr)
+#define ENGINE_LOG_DEBUG(tag, expr) ENGINE_LOG(::engine::LogLevel::DEBUG, tag, expr)
+#define ENGINE_LOG_INFO(tag, expr)  ENGINE_LOG(::engine::LogLevel::INFO, tag, expr)
+#define ENGINE_LOG_WARN(tag, expr)  ENGINE_LOG(::engine::LogLevel::WARN, tag, expr)
+#define ENGINE_LOG_ERROR(tag, expr) ENGINE_LOG(::engine::LogLevel::ERROR, tag, expr)
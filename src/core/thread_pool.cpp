@@ -0,0 +1,92 @@
+#include "core/thread_pool.h"
+
+#include <algorithm>
+
+namespace engine {
+
+ThreadPool::ThreadPool(int n_threads) {
+    if (n_threads <= 0) {
+        n_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    n_threads = std::max(1, n_threads);
+
+    workers_.reserve(n_threads - 1);
+    for (int tid = 1; tid < n_threads; ++tid) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (int tid = 1; tid < n_threads; ++tid) {
+        workers_[tid - 1]->thread = std::thread(&ThreadPool::worker_loop, this, tid);
+    }
+
+    active_.store(n_threads, std::memory_order_relaxed);
+}
+
+ThreadPool::~ThreadPool() {
+    stop_ = true;
+    for (auto& w : workers_) w->wake.release();
+    for (auto& w : workers_) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+}
+
+void ThreadPool::set_active_threads(int n) {
+    active_.store(std::clamp(n, 1, size()), std::memory_order_relaxed);
+}
+
+void ThreadPool::run_chunk(int tid) const {
+    const int chunk = (job_n_ + job_threads_ - 1) / job_threads_;
+    const int begin = tid * chunk;
+    const int end = std::min(job_n_, begin + chunk);
+
+    if (begin < end) {
+        (*job_)(begin, end, tid);
+    }
+}
+
+void ThreadPool::parallel_for(int n, const RangeFn& fn, int min_chunk) {
+    if (n <= 0) return;
+
+    const int max_by_work = (n + std::max(1, min_chunk) - 1) / std::max(1, min_chunk);
+    const int n_threads = std::min(active_threads(), max_by_work);
+
+    if (n_threads <= 1) {
+        fn(0, n, 0);
+        return;
+    }
+
+    job_ = &fn;
+    job_n_ = n;
+    job_threads_ = n_threads;
+    remaining_.store(n_threads - 1, std::memory_order_release);
+
+    // Acorda só os participantes; os demais continuam estacionados
+    for (int tid = 1; tid < n_threads; ++tid) {
+        workers_[tid - 1]->wake.release();
+    }
+
+    run_chunk(0);
+
+    int r;
+    while ((r = remaining_.load(std::memory_order_acquire)) != 0) {
+        remaining_.wait(r, std::memory_order_acquire);
+    }
+
+    job_ = nullptr;
+}
+
+void ThreadPool::worker_loop(int tid) {
+    Worker& self = *workers_[tid - 1];
+
+    for (;;) {
+        self.wake.acquire();
+        if (stop_) return;
+
+        run_chunk(tid);
+
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            remaining_.notify_one();
+        }
+    }
+}
+
+} // namespace engine
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+/**
+ * Pool fixo de threads para paralelismo de dados no backend.
+ *
+ * - A thread chamadora participa como índice 0.
+ * - Apenas as primeiras `active_threads()` threads recebem trabalho;
+ *   as demais ficam estacionadas (bloqueadas no semáforo) sem consumir CPU.
+ * - O número de threads ativas pode ser alterado a qualquer momento
+ *   (ex.: pelo PowerGovernor); a mudança vale a partir do próximo parallel_for.
+ */
+class ThreadPool {
+public:
+    // Função de trabalho: processa o intervalo [begin, end) na thread `tid`.
+    using RangeFn = std::function<void(int begin, int end, int tid)>;
+
+    // n_threads = 0 → std::thread::hardware_concurrency()
+    explicit ThreadPool(int n_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Total de threads (workers + chamadora).
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+    int active_threads() const { return active_.load(std::memory_order_relaxed); }
+    void set_active_threads(int n);
+
+    // Divide [0, n) em blocos contíguos entre as threads ativas.
+    // `min_chunk` evita acordar threads para blocos pequenos demais.
+    void parallel_for(int n, const RangeFn& fn, int min_chunk = 1);
+
+private:
+    struct Worker {
+        std::thread thread;
+        std::binary_semaphore wake{0};
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<int> active_{1};
+
+    // Job corrente (escrito pela chamadora antes de acordar os workers)
+    const RangeFn* job_ = nullptr;
+    int job_n_ = 0;
+    int job_threads_ = 0;
+    std::atomic<int> remaining_{0};
+    bool stop_ = false;
+
+    void worker_loop(int tid);
+    void run_chunk(int tid) const;
+};
+
+} // namespace engine
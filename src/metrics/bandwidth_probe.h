@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace engine {
+
+class ThreadPool;
+
+/**
+ * Teto de banda de memória do host, medido ao estilo STREAM.
+ *
+ *   read  : redução sobre dois arrays (o padrão do GEMV de decode:
+ *           pesos só lidos, uma vez por token)
+ *   triad : a[i] = b[i] + s * c[i] (conta 3 arrays, como o STREAM)
+ *
+ * Arrays bem maiores que o LLC, inicializados em paralelo (first touch
+ * local a cada thread). Vale a melhor de N repetições.
+ * O resultado é cacheado por host (key=value) e reusado até --reprobe.
+ */
+struct BandwidthProfile {
+    std::string host;
+    int threads = 0;
+    size_t array_mb = 0;
+    double read_gbps = 0.0;
+    double triad_gbps = 0.0;
+
+    static std::optional<BandwidthProfile> load(const std::string& path);
+    bool save(const std::string& path) const;
+};
+
+class BandwidthProbe {
+public:
+    struct Options {
+        size_t total_mb = 256;  // soma dos 3 arrays
+        int repetitions = 5;
+    };
+
+    // Usa as threads ativas do pool.
+    static BandwidthProfile run(ThreadPool& pool, const Options& options);
+};
+
+} // namespace engine
@@ -0,0 +1,151 @@
+#include "metrics/energy_sampler.h"
+#include "metrics/metrics_registry.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace engine {
+
+namespace {
+
+Gauge& energy_gauge(const char* phase) {
+    return MetricsRegistry::global().gauge(
+        "engine_energy_joules", "RAPL energy attributed since start, by phase", {{"phase", phase}}
+    );
+}
+
+} // namespace
+
+EnergySampler::EnergySampler(const PowerLinux& power, int interval_ms)
+    : power_(power),
+      interval_ms_(std::max(1, interval_ms)) {
+}
+
+EnergySampler::~EnergySampler() {
+    stop();
+}
+
+void EnergySampler::start() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (running_) return;
+
+    last_joules_ = power_.read_joules();
+    running_ = true;
+    thread_ = std::thread(&EnergySampler::run, this);
+}
+
+void EnergySampler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void EnergySampler::run() {
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    while (running_) {
+        cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_), [this] { return !running_; });
+        if (!running_) break;
+        sample_locked();
+    }
+}
+
+void EnergySampler::sample_locked() {
+    const auto now = power_.read_joules();
+    if (!now.has_value()) return;
+
+    const auto prev = last_joules_;
+    last_joules_ = now;
+    if (!prev.has_value()) return;
+
+    // PowerLinux já corrige wraparound; delta negativo = contador
+    // reiniciado por fora (ex.: driver recarregado). Descarta o intervalo.
+    const double delta = *now - *prev;
+    if (delta < 0.0) {
+        pending_tokens_.clear();
+        return;
+    }
+
+    ++totals_.samples;
+
+    uint64_t tokens = 0;
+    for (const auto& [id, n] : pending_tokens_) tokens += n;
+
+    static Gauge& idle_g = energy_gauge("idle");
+    static Gauge& prefill_g = energy_gauge("prefill");
+    static Gauge& decode_g = energy_gauge("decode");
+
+    if (tokens == 0) {
+        totals_.idle_joules += delta;
+        idle_g.add(delta);
+        return;
+    }
+
+    const bool decode = (phase_ == ExecutionPhase::DECODE);
+    (decode ? totals_.decode_joules : totals_.prefill_joules) += delta;
+    (decode ? decode_g : prefill_g).add(delta);
+
+    for (const auto& [id, n] : pending_tokens_) {
+        Attribution& a = ledger_[id];
+        const double share = delta * double(n) / double(tokens);
+        (decode ? a.decode_joules : a.prefill_joules) += share;
+        a.tokens += n;
+    }
+
+    pending_tokens_.clear();
+}
+
+void EnergySampler::sample() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    sample_locked();
+}
+
+void EnergySampler::set_phase(ExecutionPhase phase) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (phase == phase_) return;
+
+    sample_locked();
+    phase_ = phase;
+}
+
+void EnergySampler::add_tokens(uint64_t request_id, uint32_t n) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    pending_tokens_[request_id] += n;
+}
+
+EnergySampler::Attribution EnergySampler::request(uint64_t request_id) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    sample_locked();
+
+    const auto it = ledger_.find(request_id);
+    return it != ledger_.end() ? it->second : Attribution{};
+}
+
+double EnergySampler::attributed_joules(uint64_t request_id) const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    const auto it = ledger_.find(request_id);
+    return it != ledger_.end() ? it->second.joules() : 0.0;
+}
+
+EnergySampler::Attribution EnergySampler::finish_request(uint64_t request_id) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    sample_locked();
+
+    Attribution a;
+    if (const auto it = ledger_.find(request_id); it != ledger_.end()) {
+        a = it->second;
+        ledger_.erase(it);
+    }
+    return a;
+}
+
+EnergySampler::Totals EnergySampler::totals() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return totals_;
+}
+
+} // namespace engine
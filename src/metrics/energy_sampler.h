@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+#include "backend/backend.h"
+#include "metrics/power_linux.h"
+
+namespace engine {
+
+/**
+ * Amostrador de energia em background (RAPL via PowerLinux).
+ *
+ * A cada intervalo, o delta de joules é atribuído:
+ *   - à fase corrente (prefill/decode);
+ *   - aos requests que processaram tokens no intervalo, em proporção
+ *     aos tokens de cada um (batching divide a energia pelo trabalho).
+ *
+ * Intervalos sem tokens ficam como energia ociosa (não faturada).
+ * Trocas de fase e fim de request forçam uma amostra, para que a
+ * fronteira de atribuição seja exata e não dependa do intervalo.
+ */
+class EnergySampler {
+public:
+    struct Attribution {
+        double prefill_joules = 0.0;
+        double decode_joules = 0.0;
+        uint64_t tokens = 0;
+
+        double joules() const { return prefill_joules + decode_joules; }
+    };
+
+    struct Totals {
+        double prefill_joules = 0.0;
+        double decode_joules = 0.0;
+        double idle_joules = 0.0;
+        uint64_t samples = 0;
+    };
+
+    EnergySampler(const PowerLinux& power, int interval_ms);
+    ~EnergySampler();
+
+    EnergySampler(const EnergySampler&) = delete;
+    EnergySampler& operator=(const EnergySampler&) = delete;
+
+    void start();
+    void stop();
+
+    // Fecha o intervalo corrente e passa a atribuir à nova fase.
+    void set_phase(ExecutionPhase phase);
+
+    // Tokens processados por um request desde a última amostra.
+    void add_tokens(uint64_t request_id, uint32_t n = 1);
+
+    // Amostra imediatamente (thread chamadora).
+    void sample();
+
+    // Atribuição acumulada do request (após uma amostra).
+    Attribution request(uint64_t request_id);
+
+    // Joules já atribuídos ao request, sem amostrar: não lê o RAPL e só
+    // muda a cada amostra (orçamento checado por token).
+    double attributed_joules(uint64_t request_id) const;
+
+    // Remove o request do ledger e devolve a atribuição final.
+    Attribution finish_request(uint64_t request_id);
+
+    Totals totals() const;
+
+private:
+    const PowerLinux& power_;
+    int interval_ms_;
+
+    mutable std::mutex mtx_;
+    ExecutionPhase phase_ = ExecutionPhase::PREFILL;
+    std::optional<double> last_joules_;
+    Totals totals_;
+
+    std::unordered_map<uint64_t, uint64_t> pending_tokens_;
+    std::unordered_map<uint64_t, Attribution> ledger_;
+
+    std::thread thread_;
+    std::condition_variable cv_;
+    bool running_ = false;
+
+    void run();
+    void sample_locked();
+};
+
+} // namespace engine
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+namespace engine {
+
+/**
+ * Histograma log-linear (estilo HDR) para latências.
+ *
+ * Cada potência de 2 é dividida em 2^SUB_BITS sub-buckets, o que dá erro
+ * relativo ≤ 1/2^SUB_BITS (~6%) nos percentis, com memória fixa e
+ * record() O(1) sem alocação. Unidade livre (ns, µs...).
+ */
+class LogHistogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int SUB_COUNT = 1 << SUB_BITS;
+    static constexpr int OCTAVES = 64 - SUB_BITS;
+    static constexpr int BUCKETS = (OCTAVES + 1) * SUB_COUNT;
+
+    void record(uint64_t v) {
+        ++buckets_[bucket_of(v)];
+        ++count_;
+        sum_ += v;
+        min_ = std::min(min_, v);
+        max_ = std::max(max_, v);
+    }
+
+    void merge(const LogHistogram& o) {
+        for (int i = 0; i < BUCKETS; ++i) buckets_[i] += o.buckets_[i];
+        count_ += o.count_;
+        sum_ += o.sum_;
+        min_ = std::min(min_, o.min_);
+        max_ = std::max(max_, o.max_);
+    }
+
+    void reset() { *this = LogHistogram{}; }
+
+    uint64_t count() const { return count_; }
+    uint64_t sum() const { return sum_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? double(sum_) / double(count_) : 0.0; }
+
+    // q em [0, 1]. Retorna o ponto médio do bucket, limitado a [min, max].
+    uint64_t percentile(double q) const {
+        if (count_ == 0) return 0;
+
+        const uint64_t rank = std::max<uint64_t>(
+            1, static_cast<uint64_t>(q * double(count_) + 0.5)
+        );
+
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) {
+                const uint64_t lo = bucket_low(i);
+                const uint64_t hi = bucket_low(i + 1) - 1;
+                return std::clamp(lo + (hi - lo) / 2, min(), max_);
+            }
+        }
+        return max_;
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = std::numeric_limits<uint64_t>::max();
+    uint64_t max_ = 0;
+
+    // Valores < SUB_COUNT ficam em buckets exatos; acima, (oitava, sub-bucket)
+    static int bucket_of(uint64_t v) {
+        if (v < SUB_COUNT) return static_cast<int>(v);
+        const int msb = 63 - std::countl_zero(v);
+        const int shift = msb - SUB_BITS;
+        const int sub = static_cast<int>((v >> shift) & (SUB_COUNT - 1));
+        return (shift + 1) * SUB_COUNT + sub;
+    }
+
+    static uint64_t bucket_low(int b) {
+        if (b < SUB_COUNT) return static_cast<uint64_t>(b);
+        const int shift = b / SUB_COUNT - 1;
+        const uint64_t sub = static_cast<uint64_t>(b % SUB_COUNT);
+        if (shift + SUB_BITS >= 64) return std::numeric_limits<uint64_t>::max();
+        return (uint64_t(SUB_COUNT) + sub) << shift;
+    }
+};
+
+} // namespace engine
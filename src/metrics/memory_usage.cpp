@@ -0,0 +1,73 @@
+#include "metrics/memory_usage.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace engine {
+
+ProcessMemory read_process_memory() {
+    ProcessMemory m;
+
+#ifdef __linux__
+    std::ifstream f("/proc/self/status");
+    std::string line;
+
+    // Linhas "VmRSS:    1234 kB"
+    auto kb_value = [](const std::string& l) {
+        const size_t p = l.find_first_of("0123456789");
+        return p == std::string::npos ? 0ull : std::stoull(l.substr(p)) * 1024ull;
+    };
+
+    while (std::getline(f, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) m.rss_bytes = kb_value(line);
+        else if (line.rfind("VmHWM:", 0) == 0) m.peak_rss_bytes = kb_value(line);
+    }
+#endif
+
+    return m;
+}
+
+bool reset_peak_rss() {
+#ifdef __linux__
+    std::ofstream f("/proc/self/clear_refs");
+    if (!f.is_open()) return false;
+    f << "5";
+    f.flush();
+    return static_cast<bool>(f);
+#else
+    return false;
+#endif
+}
+
+uint64_t resident_bytes(const void* addr, size_t len) {
+#ifdef __linux__
+    if (!addr || len == 0) return 0;
+
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(addr) & ~(uintptr_t(page) - 1);
+    const uintptr_t end = reinterpret_cast<uintptr_t>(addr) + len;
+    const size_t n_pages = (end - begin + page - 1) / page;
+
+    std::vector<unsigned char> vec(n_pages);
+    if (::mincore(reinterpret_cast<void*>(begin), end - begin, vec.data()) != 0) return 0;
+
+    uint64_t resident = 0;
+    for (unsigned char v : vec) {
+        if (v & 1) resident += page;
+    }
+    return std::min<uint64_t>(resident, len);
+#else
+    (void)addr;
+    (void)len;
+    return 0;
+#endif
+}
+
+} // namespace engine
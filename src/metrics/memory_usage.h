@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace engine {
+
+/**
+ * Memória do processo (Linux, /proc).
+ *
+ * - rss / peak_rss vêm de VmRSS / VmHWM em /proc/self/status.
+ * - reset_peak_rss() zera o VmHWM (clear_refs = 5) para medir o pico de
+ *   um único run; se o kernel recusar, o pico é o do processo inteiro.
+ * - resident_bytes() conta as páginas de um mapeamento que estão em RAM
+ *   (mincore), útil para pesos mmapped que só entram sob demanda.
+ *
+ * Fora do Linux tudo retorna 0 / false.
+ */
+struct ProcessMemory {
+    uint64_t rss_bytes = 0;
+    uint64_t peak_rss_bytes = 0;
+};
+
+ProcessMemory read_process_memory();
+
+bool reset_peak_rss();
+
+uint64_t resident_bytes(const void* addr, size_t len);
+
+} // namespace engine
@@ -0,0 +1,207 @@
+#include "metrics/metrics_registry.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace engine {
+
+namespace metrics_detail {
+
+int shard_index() {
+    static std::atomic<int> next{0};
+    thread_local const int index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+} // namespace metrics_detail
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& s : shards_) total += s.v.load(std::memory_order_relaxed);
+    return total;
+}
+
+/* ================================================= */
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)) {
+    std::sort(bounds_.begin(), bounds_.end());
+    for (auto& s : shards_) {
+        s.counts = std::make_unique<std::atomic<uint64_t>[]>(bounds_.size() + 1);
+    }
+}
+
+void Histogram::observe(double v) {
+    // Poucos buckets: busca linear é mais barata que binária
+    size_t b = 0;
+    while (b < bounds_.size() && v > bounds_[b]) ++b;
+
+    Shard& s = shards_[metrics_detail::shard_index()];
+    s.counts[b].fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(v, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snap;
+    snap.cumulative.assign(bounds_.size() + 1, 0);
+
+    for (const auto& s : shards_) {
+        for (size_t b = 0; b <= bounds_.size(); ++b) {
+            snap.cumulative[b] += s.counts[b].load(std::memory_order_relaxed);
+        }
+        snap.sum += s.sum.load(std::memory_order_relaxed);
+    }
+
+    for (size_t b = 1; b < snap.cumulative.size(); ++b) {
+        snap.cumulative[b] += snap.cumulative[b - 1];
+    }
+    snap.count = snap.cumulative.back();
+    return snap;
+}
+
+/* ================================================= */
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+std::vector<double> MetricsRegistry::latency_buckets() {
+    return {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+            0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+}
+
+// Chamado com mtx_ travado
+MetricsRegistry::Series& MetricsRegistry::series(
+    const std::string& name, const std::string& help, Type type, const Labels& labels
+) {
+    auto [it, inserted] = families_.try_emplace(name);
+    Family& f = it->second;
+    if (inserted) {
+        f.type = type;
+        f.help = help;
+    } else if (f.type != type) {
+        throw std::logic_error("metric '" + name + "' registered with two types");
+    }
+
+    for (auto& s : f.series) {
+        if (s->labels == labels) return *s;
+    }
+
+    f.series.push_back(std::make_unique<Series>());
+    f.series.back()->labels = labels;
+    return *f.series.back();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Series& s = series(name, help, Type::COUNTER, labels);
+    if (!s.counter) s.counter = std::make_unique<Counter>();
+    return *s.counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Series& s = series(name, help, Type::GAUGE, labels);
+    if (!s.gauge) s.gauge = std::make_unique<Gauge>();
+    return *s.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::vector<double>& bounds, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Series& s = series(name, help, Type::HISTOGRAM, labels);
+    if (!s.histogram) s.histogram = std::make_unique<Histogram>(bounds);
+    return *s.histogram;
+}
+
+/* ================================================= */
+/* OPENMETRICS */
+/* ================================================= */
+
+namespace {
+
+void write_escaped(std::ostringstream& os, const std::string& v) {
+    for (char c : v) {
+        if (c == '\\') os << "\\\\";
+        else if (c == '"') os << "\\\"";
+        else if (c == '\n') os << "\\n";
+        else os << c;
+    }
+}
+
+// {a="x",b="y"} com um label extra opcional (ex.: le="0.5")
+void write_labels(std::ostringstream& os, const MetricsRegistry::Labels& labels,
+                  const char* extra_key = nullptr, const std::string& extra_val = {}) {
+    if (labels.empty() && !extra_key) return;
+
+    os << '{';
+    bool first = true;
+    for (const auto& [k, v] : labels) {
+        os << (first ? "" : ",") << k << "=\"";
+        write_escaped(os, v);
+        os << '"';
+        first = false;
+    }
+    if (extra_key) {
+        os << (first ? "" : ",") << extra_key << "=\"" << extra_val << '"';
+    }
+    os << '}';
+}
+
+std::string format_bound(double b) {
+    std::ostringstream os;
+    os << b;
+    return os.str();
+}
+
+} // namespace
+
+std::string MetricsRegistry::render_openmetrics() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    std::ostringstream os;
+    os.precision(17);
+
+    for (const auto& [name, f] : families_) {
+        const char* type = f.type == Type::COUNTER ? "counter"
+                         : f.type == Type::GAUGE   ? "gauge"
+                                                   : "histogram";
+
+        os << "# TYPE " << name << ' ' << type << '\n';
+        os << "# HELP " << name << ' ' << f.help << '\n';
+
+        for (const auto& s : f.series) {
+            if (s->counter) {
+                os << name << "_total";
+                write_labels(os, s->labels);
+                os << ' ' << s->counter->value() << '\n';
+            } else if (s->gauge) {
+                os << name;
+                write_labels(os, s->labels);
+                os << ' ' << s->gauge->value() << '\n';
+            } else if (s->histogram) {
+                const auto snap = s->histogram->snapshot();
+                const auto& bounds = s->histogram->bounds();
+
+                for (size_t b = 0; b <= bounds.size(); ++b) {
+                    os << name << "_bucket";
+                    write_labels(os, s->labels, "le",
+                                 b < bounds.size() ? format_bound(bounds[b]) : "+Inf");
+                    os << ' ' << snap.cumulative[b] << '\n';
+                }
+                os << name << "_count";
+                write_labels(os, s->labels);
+                os << ' ' << snap.count << '\n';
+                os << name << "_sum";
+                write_labels(os, s->labels);
+                os << ' ' << snap.sum << '\n';
+            }
+        }
+    }
+
+    os << "# EOF\n";
+    return os.str();
+}
+
+} // namespace engine
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace engine {
+
+/**
+ * Registro de métricas do engine (counters, gauges, histogramas),
+ * exportado em texto OpenMetrics por MetricsServer.
+ *
+ * Hot path sem lock: cada thread escreve no seu shard (linha de cache
+ * própria) com fetch_add relaxado; a leitura soma os shards.
+ * Registro e render pegam mutex, mas só acontecem no setup e no scrape.
+ *
+ * As métricas vivem até o fim do processo: quem registra guarda a
+ * referência (tipicamente num static local) e incrementa direto.
+ */
+namespace metrics_detail {
+
+constexpr int SHARDS = 16;
+
+// Shard da thread corrente (round-robin na primeira chamada)
+int shard_index();
+
+} // namespace metrics_detail
+
+class Counter {
+public:
+    void inc(uint64_t n = 1) {
+        shards_[metrics_detail::shard_index()].v.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> v{0};
+    };
+    std::array<Shard, metrics_detail::SHARDS> shards_;
+};
+
+class Gauge {
+public:
+    void set(double v) { v_.store(v, std::memory_order_relaxed); }
+    void add(double d) { v_.fetch_add(d, std::memory_order_relaxed); }
+    double value() const { return v_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> v_{0.0};
+};
+
+class Histogram {
+public:
+    // bounds: limites superiores dos buckets, crescentes (+Inf implícito)
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double v);
+
+    struct Snapshot {
+        std::vector<uint64_t> cumulative;  // um por bound, + o de +Inf
+        double sum = 0.0;
+        uint64_t count = 0;
+    };
+    Snapshot snapshot() const;
+
+    const std::vector<double>& bounds() const { return bounds_; }
+
+private:
+    struct alignas(64) Shard {
+        std::unique_ptr<std::atomic<uint64_t>[]> counts;
+        std::atomic<double> sum{0.0};
+    };
+
+    std::vector<double> bounds_;
+    std::array<Shard, metrics_detail::SHARDS> shards_;
+};
+
+class MetricsRegistry {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    static MetricsRegistry& global();
+
+    // Mesmo (nome, labels) devolve a mesma instância.
+    // Counters: nome sem "_total" (o sufixo entra na exposição).
+    Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::vector<double>& bounds, const Labels& labels = {});
+
+    // Buckets padrão de latência, em segundos (100 µs .. 10 s)
+    static std::vector<double> latency_buckets();
+
+    // Exposição OpenMetrics 1.0 (termina em "# EOF")
+    std::string render_openmetrics() const;
+
+private:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Series {
+        Labels labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    struct Family {
+        Type type = Type::COUNTER;
+        std::string help;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    mutable std::mutex mtx_;
+    std::map<std::string, Family> families_;
+
+    Series& series(const std::string& name, const std::string& help, Type type, const Labels& labels);
+};
+
+} // namespace engine
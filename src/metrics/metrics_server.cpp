@@ -0,0 +1,178 @@
+#include "metrics/metrics_server.h"
+#include "metrics/metrics_registry.h"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace engine {
+
+MetricsServer::MetricsServer(const MetricsRegistry& registry) : registry_(registry) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+#ifdef __linux__
+
+bool MetricsServer::start_tcp(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error_ = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    const int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  // só local
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        error_ = "bind 127.0.0.1:" + std::to_string(port) + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+        port_ = ntohs(addr.sin_port);
+    }
+
+    return start(fd);
+}
+
+bool MetricsServer::start_unix(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        error_ = "unix socket path too long: " + path;
+        return false;
+    }
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error_ = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size());
+
+    ::unlink(path.c_str());  // socket velho de uma execução anterior
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        error_ = "bind " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    unix_path_ = path;
+    return start(fd);
+}
+
+bool MetricsServer::start(int fd) {
+    if (::listen(fd, 8) < 0) {
+        error_ = std::string("listen: ") + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    listen_fd_ = fd;
+    error_.clear();
+    running_.store(true);
+    thread_ = std::thread(&MetricsServer::run, this);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false)) return;
+
+    if (thread_.joinable()) thread_.join();
+
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+
+    if (!unix_path_.empty()) {
+        ::unlink(unix_path_.c_str());
+        unix_path_.clear();
+    }
+}
+
+void MetricsServer::run() {
+    while (running_.load()) {
+        // Timeout curto para perceber stop()
+        pollfd p{listen_fd_, POLLIN, 0};
+        if (::poll(&p, 1, 200) <= 0) continue;
+
+        const int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) continue;
+
+        serve(client);
+        ::close(client);
+    }
+}
+
+void MetricsServer::serve(int client_fd) {
+    // Lê só o cabeçalho da requisição (o caminho não importa)
+    char buf[2048];
+    std::string request;
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        pollfd p{client_fd, POLLIN, 0};
+        if (::poll(&p, 1, 1000) <= 0) return;
+
+        const ssize_t n = ::recv(client_fd, buf, sizeof(buf), 0);
+        if (n <= 0) return;
+        request.append(buf, static_cast<size_t>(n));
+    }
+
+    std::string response;
+    if (request.rfind("GET ", 0) == 0) {
+        const std::string body = registry_.render_openmetrics();
+        response =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n\r\n" + body;
+    } else {
+        response =
+            "HTTP/1.1 405 Method Not Allowed\r\n"
+            "Content-Length: 0\r\n"
+            "Connection: close\r\n\r\n";
+    }
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        const ssize_t n = ::send(client_fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        sent += static_cast<size_t>(n);
+    }
+}
+
+#else
+
+bool MetricsServer::start_tcp(uint16_t) {
+    error_ = "metrics endpoint not supported on this platform";
+    return false;
+}
+
+bool MetricsServer::start_unix(const std::string&) {
+    error_ = "metrics endpoint not supported on this platform";
+    return false;
+}
+
+void MetricsServer::stop() {
+}
+
+#endif
+
+} // namespace engine
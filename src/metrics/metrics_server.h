@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace engine {
+
+class MetricsRegistry;
+
+/**
+ * Endpoint HTTP mínimo que serve MetricsRegistry em texto OpenMetrics.
+ *
+ * Escuta em 127.0.0.1:<port> ou num Unix socket; qualquer GET recebe
+ * o scrape corrente (Prometheus: metrics_path livre). Uma thread,
+ * uma conexão por vez — scrapes são raros e o render é barato.
+ */
+class MetricsServer {
+public:
+    explicit MetricsServer(const MetricsRegistry& registry);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    bool start_tcp(uint16_t port);
+    bool start_unix(const std::string& path);
+    void stop();
+
+    // Motivo da última falha de start_* (vazio se ok).
+    const std::string& error() const { return error_; }
+
+    // Porta efetiva (útil com port = 0)
+    uint16_t port() const { return port_; }
+
+private:
+    const MetricsRegistry& registry_;
+
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::string unix_path_;
+    std::string error_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    bool start(int fd);
+    void run();
+    void serve(int client_fd);
+};
+
+} // namespace engine
@@ -0,0 +1,250 @@
+#include "metrics/perf_counters.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace engine {
+
+PerfSample& PerfSample::operator+=(const PerfSample& o) {
+    cycles += o.cycles;
+    instructions += o.instructions;
+    llc_misses += o.llc_misses;
+    branch_misses += o.branch_misses;
+    time_ns += o.time_ns;
+    return *this;
+}
+
+PerfSample PerfSample::operator-(const PerfSample& o) const {
+    // Contadores são monotônicos; a saturação protege contra reescala
+    auto sub = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+
+    PerfSample r;
+    r.cycles = sub(cycles, o.cycles);
+    r.instructions = sub(instructions, o.instructions);
+    r.llc_misses = sub(llc_misses, o.llc_misses);
+    r.branch_misses = sub(branch_misses, o.branch_misses);
+    r.time_ns = sub(time_ns, o.time_ns);
+    return r;
+}
+
+std::atomic<bool> PerfCounters::enabled_{false};
+
+namespace {
+
+enum Slot { CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, N_SLOTS };
+
+struct ThreadGroup {
+    int fds[N_SLOTS] = {-1, -1, -1, -1};
+    int index[N_SLOTS] = {-1, -1, -1, -1};  // posição do evento no read do grupo
+    int n_events = 0;
+};
+
+std::mutex g_mtx;
+std::vector<std::unique_ptr<ThreadGroup>> g_groups;
+PerfSample g_retired;  // contagem final dos grupos de threads que já terminaram
+std::string g_error;
+
+void close_group(ThreadGroup* group);
+
+// Fecha o grupo quando a thread termina: cada pool novo (autotuner,
+// roofline, jobs do scheduler) abriria mais fds sem nunca fechar
+struct GroupOwner {
+    ThreadGroup* group = nullptr;
+    ~GroupOwner() {
+        if (group) close_group(group);
+    }
+};
+
+thread_local bool t_attached = false;
+thread_local GroupOwner t_group;
+
+#ifdef __linux__
+
+int open_event(uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 0;
+    attr.exclude_kernel = 1;  // permitido com perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP
+                     | PERF_FORMAT_TOTAL_TIME_ENABLED
+                     | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+std::string describe_errno(int err) {
+    std::string msg = "perf_event_open: ";
+    msg += std::strerror(err);
+
+    if (err == EACCES || err == EPERM) {
+        std::ifstream f("/proc/sys/kernel/perf_event_paranoid");
+        int level = 0;
+        if (f >> level) {
+            msg += " (kernel.perf_event_paranoid=" + std::to_string(level) + ")";
+        }
+    } else if (err == ENOENT || err == ENODEV || err == EOPNOTSUPP) {
+        msg += " (no hardware PMU exposed, e.g. VM/container)";
+    }
+    return msg;
+}
+
+// Abre o grupo da thread corrente. Sem o líder (cycles) não há grupo.
+std::unique_ptr<ThreadGroup> open_group(int* err) {
+    static constexpr uint64_t configs[N_SLOTS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+
+    auto g = std::make_unique<ThreadGroup>();
+
+    const int leader = open_event(configs[CYCLES], -1);
+    if (leader < 0) {
+        *err = errno;
+        return nullptr;
+    }
+    g->fds[CYCLES] = leader;
+    g->index[CYCLES] = g->n_events++;
+
+    // Eventos opcionais: se um faltar (PMU sem o evento), o resto segue
+    for (int s = INSTRUCTIONS; s < N_SLOTS; ++s) {
+        const int fd = open_event(configs[s], leader);
+        if (fd < 0) continue;
+        g->fds[s] = fd;
+        g->index[s] = g->n_events++;
+    }
+
+    return g;
+}
+
+PerfSample read_group(const ThreadGroup& g) {
+    // { nr, time_enabled, time_running, values[nr] }
+    uint64_t buf[3 + N_SLOTS] = {};
+
+    PerfSample s;
+    const ssize_t n = ::read(g.fds[CYCLES], buf, sizeof(buf));
+    if (n < static_cast<ssize_t>(3 * sizeof(uint64_t))) return s;
+
+    const uint64_t enabled = buf[1];
+    const uint64_t running = buf[2];
+    const double scale = (running > 0 && running < enabled)
+        ? double(enabled) / double(running)
+        : 1.0;
+
+    auto value = [&](int slot) -> uint64_t {
+        const int i = g.index[slot];
+        if (i < 0 || static_cast<uint64_t>(i) >= buf[0]) return 0;
+        return static_cast<uint64_t>(double(buf[3 + i]) * scale);
+    };
+
+    s.cycles = value(CYCLES);
+    s.instructions = value(INSTRUCTIONS);
+    s.llc_misses = value(LLC_MISSES);
+    s.branch_misses = value(BRANCH_MISSES);
+    return s;
+}
+
+#endif
+
+void close_group(ThreadGroup* group) {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(g_mtx);
+
+    // A contagem final vai para g_retired: read_all() continua monotônico
+    g_retired += read_group(*group);
+    for (int fd : group->fds) {
+        if (fd >= 0) ::close(fd);
+    }
+
+    g_groups.erase(std::remove_if(g_groups.begin(), g_groups.end(),
+                                  [&](const auto& g) { return g.get() == group; }),
+                   g_groups.end());
+#else
+    (void)group;
+#endif
+}
+
+} // namespace
+
+const std::string& PerfCounters::error() {
+    return g_error;
+}
+
+bool PerfCounters::enable() {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(g_mtx);
+    if (enabled()) return true;
+
+    if (!t_attached) {
+        int err = 0;
+        auto g = open_group(&err);
+        if (!g) {
+            g_error = describe_errno(err);
+            return false;
+        }
+        t_group.group = g.get();
+        g_groups.push_back(std::move(g));
+        t_attached = true;
+    }
+
+    g_error.clear();
+    enabled_.store(true, std::memory_order_relaxed);
+    return true;
+#else
+    g_error = "perf_event_open: not supported on this platform";
+    return false;
+#endif
+}
+
+// Os grupos ficam abertos até a thread terminar: religar não reabre nada e
+// read_all() continua válido.
+void PerfCounters::disable() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void PerfCounters::attach_slow() {
+#ifdef __linux__
+    if (t_attached) return;
+    t_attached = true;  // uma tentativa por thread, mesmo se falhar
+
+    int err = 0;
+    auto g = open_group(&err);
+    if (!g) return;
+
+    std::lock_guard<std::mutex> lock(g_mtx);
+    t_group.group = g.get();
+    g_groups.push_back(std::move(g));
+#endif
+}
+
+PerfSample PerfCounters::read_all() {
+    PerfSample total;
+
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(g_mtx);
+    total = g_retired;
+    for (const auto& g : g_groups) {
+        total += read_group(*g);
+    }
+#endif
+
+    return total;
+}
+
+} // namespace engine
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace engine {
+
+/**
+ * Contadores de hardware via perf_event_open (Linux).
+ *
+ * - Um grupo por thread (cycles como líder + instructions, LLC misses,
+ *   branch misses), aberto pela própria thread na primeira vez que ela
+ *   roda trabalho com os contadores ligados; o grupo fica registrado
+ *   globalmente e é lido por qualquer thread. Quando a thread termina, o
+ *   grupo é fechado e a contagem final entra num acumulado.
+ * - Os contadores correm livres (só user space); regiões são medidas
+ *   por diferença de read_all() antes/depois.
+ * - Com multiplexação, os valores são escalados por time_enabled/time_running.
+ *
+ * Se o kernel bloquear (perf_event_paranoid, container sem PMU, não-Linux),
+ * enable() retorna false, error() explica o motivo e nada mais é medido.
+ */
+struct PerfSample {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t llc_misses = 0;
+    uint64_t branch_misses = 0;
+    uint64_t time_ns = 0;  // tempo de parede da região (preenchido por quem mede)
+
+    double ipc() const { return cycles ? double(instructions) / double(cycles) : 0.0; }
+
+    // Estimativa de tráfego de memória: uma linha de cache por LLC miss
+    double est_bytes() const { return double(llc_misses) * 64.0; }
+    double est_gbps() const { return time_ns ? est_bytes() / double(time_ns) : 0.0; }
+
+    PerfSample& operator+=(const PerfSample& o);
+    PerfSample operator-(const PerfSample& o) const;
+};
+
+class PerfCounters {
+public:
+    // Abre o grupo da thread chamadora; false se o kernel negar acesso.
+    static bool enable();
+    static void disable();
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Motivo da última falha de enable() (vazio se ok).
+    static const std::string& error();
+
+    // Abre o grupo da thread corrente, se ligado e ainda não aberto.
+    static void attach_current_thread() {
+        if (enabled()) attach_slow();
+    }
+
+    // Soma dos contadores de todas as threads registradas.
+    static PerfSample read_all();
+
+private:
+    static std::atomic<bool> enabled_;
+    static void attach_slow();
+};
+
+} // namespace engine
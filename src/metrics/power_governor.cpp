@@ -0,0 +1,127 @@
+#include "metrics/power_governor.h"
+#include "core/logger.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace engine {
+
+PowerGovernor::PowerGovernor(const PowerLinux& power, const Config& config, ApplyFn apply)
+    : power_(power),
+      config_(config),
+      apply_(std::move(apply)),
+      threads_(std::max(config.min_threads, config.max_threads)),
+      batch_(std::max(config.min_batch, config.max_batch)) {
+}
+
+PowerGovernor::~PowerGovernor() {
+    stop();
+}
+
+void PowerGovernor::start() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (running_ || config_.max_watts <= 0.0) return;
+
+    running_ = true;
+    thread_ = std::thread(&PowerGovernor::run, this);
+}
+
+void PowerGovernor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+bool PowerGovernor::step(double watts) {
+    int threads = threads_.load(std::memory_order_relaxed);
+    int batch = batch_.load(std::memory_order_relaxed);
+
+    if (watts > config_.max_watts) {
+        if (threads > config_.min_threads) {
+            --threads;
+        } else if (batch > config_.min_batch) {
+            batch = std::max(config_.min_batch, batch / 2);
+        } else {
+            return false;  // já no mínimo
+        }
+    } else if (watts < config_.max_watts * (1.0 - config_.hysteresis)) {
+        if (batch < config_.max_batch) {
+            batch = std::min(config_.max_batch, batch * 2);
+        } else if (threads < config_.max_threads) {
+            ++threads;
+        } else {
+            return false;  // já no máximo
+        }
+    } else {
+        return false;  // dentro da banda
+    }
+
+    threads_.store(threads, std::memory_order_relaxed);
+    batch_.store(batch, std::memory_order_relaxed);
+
+    if (apply_) apply_(threads, batch);
+    return true;
+}
+
+void PowerGovernor::run() {
+    using clock = std::chrono::steady_clock;
+
+    auto last_t = clock::now();
+    auto last_j = power_.read_joules();
+
+    bool settling = false;
+    bool first = true;
+
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    while (running_) {
+        cv_.wait_for(lock, std::chrono::milliseconds(config_.interval_ms),
+                     [this] { return !running_; });
+        if (!running_) break;
+
+        const auto now_t = clock::now();
+        const auto now_j = power_.read_joules();
+
+        if (!now_j.has_value() || !last_j.has_value()) {
+            last_t = now_t;
+            last_j = now_j;
+            continue;
+        }
+
+        const double dt = std::chrono::duration<double>(now_t - last_t).count();
+        const double dj = *now_j - *last_j;
+
+        last_t = now_t;
+        last_j = now_j;
+
+        // Contador voltou (wraparound) ou intervalo degenerado: descarta
+        if (dt <= 0.0 || dj < 0.0) continue;
+
+        const double inst = dj / dt;
+        const double prev = watts_.load(std::memory_order_relaxed);
+        const double ema = first ? inst : 0.5 * inst + 0.5 * prev;
+        first = false;
+
+        watts_.store(ema, std::memory_order_relaxed);
+
+        // Após uma mudança, espera uma amostra para o consumo acomodar
+        if (settling) {
+            settling = false;
+            continue;
+        }
+
+        if (step(ema)) {
+            settling = true;
+            ENGINE_LOG_INFO("governor", "watts=" << ema
+                            << " cap=" << config_.max_watts
+                            << " -> threads=" << threads()
+                            << " batch=" << batch_size());
+        }
+    }
+}
+
+} // namespace engine
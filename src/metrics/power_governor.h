@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "metrics/power_linux.h"
+
+namespace engine {
+
+/**
+ * Governador de potência em malha fechada.
+ *
+ * Uma thread de amostragem calcula a potência instantânea a partir de
+ * deltas de PowerLinux::read_joules() e ajusta os atuadores para manter
+ * o consumo abaixo de PowerLimits::max_watts:
+ *
+ *   acima do cap   → reduz threads ativas; no mínimo, reduz o batch
+ *   abaixo do cap  → devolve batch e depois threads (ordem inversa)
+ *
+ * Um passo por amostra, com histerese, para não oscilar com o ruído do RAPL.
+ */
+class PowerGovernor {
+public:
+    struct Config {
+        double max_watts = 0.0;
+        int interval_ms = 100;
+
+        int min_threads = 1;
+        int max_threads = 1;
+        int min_batch = 1;
+        int max_batch = 32;
+
+        // Só volta a subir quando watts < max_watts * (1 - hysteresis)
+        double hysteresis = 0.10;
+    };
+
+    // Chamado (na thread do governador) sempre que os atuadores mudam.
+    using ApplyFn = std::function<void(int threads, int batch)>;
+
+    PowerGovernor(const PowerLinux& power, const Config& config, ApplyFn apply);
+    ~PowerGovernor();
+
+    PowerGovernor(const PowerGovernor&) = delete;
+    PowerGovernor& operator=(const PowerGovernor&) = delete;
+
+    void start();
+    void stop();
+
+    int threads() const { return threads_.load(std::memory_order_relaxed); }
+    int batch_size() const { return batch_.load(std::memory_order_relaxed); }
+
+    // Potência suavizada (EMA) da última amostra, em watts.
+    double watts() const { return watts_.load(std::memory_order_relaxed); }
+
+private:
+    const PowerLinux& power_;
+    Config config_;
+    ApplyFn apply_;
+
+    std::atomic<int> threads_;
+    std::atomic<int> batch_;
+    std::atomic<double> watts_{0.0};
+
+    std::thread thread_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool running_ = false;
+
+    void run();
+    bool step(double watts);
+};
+
+} // namespace engine
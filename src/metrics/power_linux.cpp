@@ -1,5 +1,6 @@
 #include "./power_linux.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -20,50 +21,159 @@ std::optional<uint64_t> PowerLinux::read_u64_file(const std::string& path) {
     return v;
 }
 
-bool PowerLinux::init() {
-    // Busca por qualquer energy_uj em /sys/class/powercap
-    // Exemplos comuns:
-    //   /sys/class/powercap/intel-rapl:0/energy_uj
-    //   /sys/class/powercap/intel-rapl:0:0/energy_uj
-    //   /sys/class/powercap/amd-rapl:0/energy_uj (depende do kernel/driver)
-    const fs::path base{"/sys/class/powercap"};
+const char* PowerLinux::domain_kind_name(DomainKind kind) {
+    switch (kind) {
+        case DomainKind::PACKAGE: return "package";
+        case DomainKind::CORE:    return "core";
+        case DomainKind::UNCORE:  return "uncore";
+        case DomainKind::DRAM:    return "dram";
+        case DomainKind::PSYS:    return "psys";
+        case DomainKind::OTHER:   break;
+    }
+    return "other";
+}
+
+PowerLinux::DomainKind PowerLinux::classify(const std::string& name) {
+    if (name.rfind("package", 0) == 0) return DomainKind::PACKAGE;
+    if (name == "core")   return DomainKind::CORE;
+    if (name == "uncore") return DomainKind::UNCORE;
+    if (name == "dram")   return DomainKind::DRAM;
+    if (name == "psys")   return DomainKind::PSYS;
+    return DomainKind::OTHER;
+}
 
-    if (!fs::exists(base) || !fs::is_directory(base)) {
+bool PowerLinux::init(const std::string& root) {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    domains_.clear();
+    counters_.clear();
+    total_domains_.clear();
+    summary_.clear();
+
+    const fs::path base{root};
+
+    std::error_code ec;
+    if (!fs::is_directory(base, ec)) {
         return false;
     }
 
-    std::vector<std::string> candidates;
+    // No sysfs real, /sys/class/powercap lista todas as zonas e subzonas
+    // como symlinks no primeiro nível: "<driver>:<pkg>[:<sub>]".
+    // Zonas MMIO (intel-rapl-mmio:*) duplicam o package e são ignoradas.
+    std::vector<std::string> zones;
+    for (const auto& entry : fs::directory_iterator(base, ec)) {
+        const std::string zone = entry.path().filename().string();
+        const auto colon = zone.find(':');
+        if (colon == std::string::npos) continue;
+        if (zone.find("mmio") != std::string::npos) continue;
+        zones.push_back(zone);
+    }
+    std::sort(zones.begin(), zones.end());
 
-    // Coleta todos os arquivos energy_uj dentro da árvore
-    for (const auto& entry : fs::recursive_directory_iterator(base)) {
-        if (!entry.is_regular_file()) continue;
-        const auto p = entry.path();
-        if (p.filename() == "energy_uj") {
-            candidates.push_back(p.string());
+    for (const auto& zone : zones) {
+        const fs::path dir = base / zone;
+        const std::string energy_path = (dir / "energy_uj").string();
+
+        const auto uj = read_u64_file(energy_path);
+        if (!uj.has_value()) continue;
+
+        Domain d;
+        d.zone = zone;
+
+        std::ifstream nf(dir / "name");
+        if (!(nf >> d.name)) d.name = zone;
+        d.kind = classify(d.name);
+
+        // "intel-rapl:1:0" → package 1
+        const auto first = zone.find(':');
+        try {
+            d.package = std::stoi(zone.substr(first + 1));
+        } catch (...) {
+            d.package = 0;
         }
+
+        d.max_range_uj = read_u64_file((dir / "max_energy_range_uj").string()).value_or(0);
+
+        domains_.push_back(d);
+
+        Counter c;
+        c.energy_uj_path = energy_path;
+        c.last_uj = *uj;
+        c.total_uj = 0;
+        counters_.push_back(c);
     }
 
-    // Heurística simples: pegar o primeiro candidato que consegue ler.
-    // (No futuro: priorizar package-level vs core-level, etc.)
-    for (const auto& c : candidates) {
-        auto v = read_u64_file(c);
-        if (v.has_value()) {
-            energy_uj_path_ = c;
-            return true;
+    // Total: packages + DRAM; sem package, psys (plataforma); senão tudo
+    auto collect = [this](auto pred) {
+        for (size_t i = 0; i < domains_.size(); ++i) {
+            if (pred(domains_[i].kind)) total_domains_.push_back(i);
         }
+    };
+
+    collect([](DomainKind k) { return k == DomainKind::PACKAGE || k == DomainKind::DRAM; });
+    if (total_domains_.empty()) collect([](DomainKind k) { return k == DomainKind::PSYS; });
+    if (total_domains_.empty()) collect([](DomainKind) { return true; });
+
+    for (size_t i : total_domains_) {
+        if (!summary_.empty()) summary_ += '+';
+        summary_ += domains_[i].name;
+        if (domains_[i].kind == DomainKind::DRAM) {
+            summary_ += '-';
+            summary_ += std::to_string(domains_[i].package);
+        }
+    }
+
+    return !domains_.empty();
+}
+
+bool PowerLinux::update_locked(size_t i) const {
+    Counter& c = counters_[i];
+
+    const auto uj = read_u64_file(c.energy_uj_path);
+    if (!uj.has_value()) return false;
+
+    if (*uj >= c.last_uj) {
+        c.total_uj += *uj - c.last_uj;
+    } else {
+        // Wraparound: o contador voltou a zero depois de max_energy_range_uj
+        const uint64_t range = domains_[i].max_range_uj;
+        c.total_uj += (range > c.last_uj ? range - c.last_uj : 0) + *uj;
     }
 
-    return false;
+    c.last_uj = *uj;
+    return true;
 }
 
 std::optional<double> PowerLinux::read_joules() const {
-    if (energy_uj_path_.empty()) return std::nullopt;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (total_domains_.empty()) return std::nullopt;
 
-    auto uj = read_u64_file(energy_uj_path_);
-    if (!uj.has_value()) return std::nullopt;
+    uint64_t uj = 0;
+    for (size_t i : total_domains_) {
+        if (!update_locked(i)) return std::nullopt;
+        uj += counters_[i].total_uj;
+    }
 
     // microjoules -> joules
-    return static_cast<double>(*uj) / 1'000'000.0;
+    return static_cast<double>(uj) / 1'000'000.0;
+}
+
+std::vector<PowerLinux::DomainReading> PowerLinux::read_domains() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    std::vector<DomainReading> out;
+    out.reserve(domains_.size());
+
+    for (size_t i = 0; i < domains_.size(); ++i) {
+        update_locked(i);
+
+        DomainReading r;
+        r.domain = &domains_[i];
+        r.joules = static_cast<double>(counters_[i].total_uj) / 1'000'000.0;
+        out.push_back(r);
+    }
+
+    return out;
 }
 
 } // namespace engine
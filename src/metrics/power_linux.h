@@ -1,38 +1,98 @@
 #pragma once
 
 #include <cstdint>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace engine {
 
 /**
  * Medidor de energia via Linux powercap (RAPL-like).
  *
- * Fonte típica (exemplos):
- *   /sys/class/powercap/intel-rapl:0/energy_uj
- *   /sys/class/powercap/intel-rapl:0:0/energy_uj
+ * Enumera todas as zonas e subzonas em /sys/class/powercap:
+ *   intel-rapl:0      package-0   (socket 0)
+ *   intel-rapl:0:0    core
+ *   intel-rapl:0:1    uncore
+ *   intel-rapl:0:2    dram
+ *   intel-rapl:1      package-1   (socket 1)
+ *   amd-rapl:0 ...    (depende do kernel/driver)
+ *
+ * Cada contador energy_uj dá a volta em max_energy_range_uj; a correção
+ * de wraparound é feita por domínio e exige pelo menos uma leitura por
+ * volta (minutos a centenas de watts — o amostrador lê a cada ~50 ms).
  *
  * Unidades:
  *   energy_uj => microjoules
  */
 class PowerLinux {
 public:
+    enum class DomainKind {
+        PACKAGE,
+        CORE,
+        UNCORE,
+        DRAM,
+        PSYS,
+        OTHER
+    };
+
+    struct Domain {
+        std::string zone;     // ex.: "intel-rapl:0:2"
+        std::string name;     // conteúdo de <zone>/name, ex.: "dram"
+        DomainKind kind = DomainKind::OTHER;
+        int package = 0;      // socket (primeiro índice da zona)
+        uint64_t max_range_uj = 0;  // 0 = desconhecido (sem correção)
+    };
+
+    struct DomainReading {
+        const Domain* domain = nullptr;
+        double joules = 0.0;  // acumulado monotônico desde init()
+    };
+
+    static constexpr const char* DEFAULT_ROOT = "/sys/class/powercap";
+
     PowerLinux() = default;
 
-    // Inicializa o medidor (descobre um energy_uj válido).
-    bool init();
+    PowerLinux(const PowerLinux&) = delete;
+    PowerLinux& operator=(const PowerLinux&) = delete;
+
+    // Inicializa o medidor (descobre os domínios legíveis sob root).
+    bool init(const std::string& root = DEFAULT_ROOT);
 
-    // Lê energia acumulada (em Joules).
+    // Energia total acumulada (em Joules): packages + DRAM de todos os sockets.
+    // Core/uncore já estão contidos no package e não entram na soma.
     std::optional<double> read_joules() const;
 
-    // Caminho selecionado (para debug).
-    const std::string& energy_path() const { return energy_uj_path_; }
+    // Energia acumulada por domínio (em Joules), na ordem de domains().
+    std::vector<DomainReading> read_domains() const;
+
+    const std::vector<Domain>& domains() const { return domains_; }
+
+    // Domínios que compõem o total, para debug (ex.: "package-0+dram").
+    const std::string& energy_path() const { return summary_; }
+
+    static const char* domain_kind_name(DomainKind kind);
 
 private:
-    std::string energy_uj_path_;
+    struct Counter {
+        std::string energy_uj_path;
+        uint64_t last_uj = 0;
+        uint64_t total_uj = 0;
+    };
+
+    std::vector<Domain> domains_;
+    std::vector<size_t> total_domains_;  // índices somados em read_joules()
+    std::string summary_;
+
+    // Lido por várias threads (amostrador, governador, generator)
+    mutable std::mutex mtx_;
+    mutable std::vector<Counter> counters_;
+
+    bool update_locked(size_t i) const;
 
     static std::optional<uint64_t> read_u64_file(const std::string& path);
+    static DomainKind classify(const std::string& name);
 };
 
 } // namespace engine
@@ -0,0 +1,207 @@
+#include "metrics/profiler.h"
+#include "metrics/histogram.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace engine {
+
+std::atomic<bool> Profiler::enabled_{false};
+
+const char* prof_op_name(ProfOp op) {
+    switch (op) {
+        case ProfOp::FORWARD:       return "forward";
+        case ProfOp::EMBEDDING:     return "embedding";
+        case ProfOp::RMS_NORM:      return "rms_norm";
+        case ProfOp::QKV_PROJ:      return "qkv_proj";
+        case ProfOp::ATTENTION:     return "attention";
+        case ProfOp::ATTN_OUT_PROJ: return "attn_out_proj";
+        case ProfOp::FFN_UP_GATE:   return "ffn_up_gate";
+        case ProfOp::FFN_ACT:       return "ffn_act";
+        case ProfOp::FFN_DOWN:      return "ffn_down";
+        case ProfOp::RESIDUAL:      return "residual";
+        case ProfOp::OUTPUT_NORM:   return "output_norm";
+        case ProfOp::OUTPUT_PROJ:   return "output_proj";
+        case ProfOp::SAMPLING:      return "sampling";
+        case ProfOp::MATMUL_CHUNK:  return "matmul_chunk";
+        case ProfOp::COUNT:         break;
+    }
+    return "unknown";
+}
+
+namespace {
+
+struct Event {
+    uint64_t start_ns;
+    uint64_t end_ns;
+    int32_t layer;
+    ProfOp op;
+};
+
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::vector<Event> events;
+    uint64_t dropped = 0;
+};
+
+// Limite por thread para não crescer sem fim em execuções longas
+constexpr size_t MAX_EVENTS_PER_THREAD = size_t(1) << 20;
+
+std::mutex g_registry_mtx;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;  // sobrevivem ao fim da thread
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer& local_buffer() {
+    if (!t_buffer) {
+        std::lock_guard<std::mutex> lock(g_registry_mtx);
+        auto buf = std::make_unique<ThreadBuffer>();
+        buf->tid = static_cast<uint32_t>(g_buffers.size());
+        buf->events.reserve(4096);
+        t_buffer = buf.get();
+        g_buffers.push_back(std::move(buf));
+    }
+    return *t_buffer;
+}
+
+} // namespace
+
+void Profiler::record(ProfOp op, int layer, uint64_t start_ns, uint64_t end_ns) {
+    ThreadBuffer& buf = local_buffer();
+
+    if (buf.events.size() >= MAX_EVENTS_PER_THREAD) {
+        ++buf.dropped;
+        return;
+    }
+
+    buf.events.push_back(Event{start_ns, end_ns, static_cast<int32_t>(layer), op});
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(g_registry_mtx);
+    for (auto& b : g_buffers) {
+        b->events.clear();
+        b->dropped = 0;
+    }
+}
+
+/* ================================================= */
+/* SUMMARY JSON */
+/* ================================================= */
+
+bool Profiler::write_summary_json(const std::string& path) {
+    std::lock_guard<std::mutex> lock(g_registry_mtx);
+
+    std::map<std::pair<int, int>, LogHistogram> per_op_layer;
+    std::map<int, LogHistogram> per_op;
+
+    uint64_t n_events = 0;
+    uint64_t dropped = 0;
+
+    for (const auto& b : g_buffers) {
+        dropped += b->dropped;
+        for (const Event& e : b->events) {
+            const uint64_t dur = e.end_ns - e.start_ns;
+            per_op_layer[{static_cast<int>(e.op), e.layer}].record(dur);
+            per_op[static_cast<int>(e.op)].record(dur);
+            ++n_events;
+        }
+    }
+
+    std::ofstream f(path, std::ios::trunc);
+    if (!f.is_open()) return false;
+
+    // Fração do tempo de forward gasta em cada op (ops folha apenas)
+    const auto fwd = per_op.find(static_cast<int>(ProfOp::FORWARD));
+    const double forward_ns = (fwd != per_op.end()) ? double(fwd->second.sum()) : 0.0;
+
+    auto write_stats = [&f](const LogHistogram& h) {
+        f << "\"count\": " << h.count()
+          << ", \"total_ns\": " << h.sum()
+          << ", \"mean_ns\": " << static_cast<uint64_t>(h.mean())
+          << ", \"min_ns\": " << h.min()
+          << ", \"p50_ns\": " << h.percentile(0.50)
+          << ", \"p90_ns\": " << h.percentile(0.90)
+          << ", \"p99_ns\": " << h.percentile(0.99)
+          << ", \"max_ns\": " << h.max();
+    };
+
+    f << "{\n"
+      << "  \"events\": " << n_events << ",\n"
+      << "  \"dropped\": " << dropped << ",\n"
+      << "  \"by_op\": [\n";
+
+    bool first = true;
+    for (const auto& [op, h] : per_op) {
+        f << (first ? "" : ",\n") << "    { \"op\": \"" << prof_op_name(static_cast<ProfOp>(op)) << "\", ";
+        write_stats(h);
+
+        const bool leaf = op != static_cast<int>(ProfOp::FORWARD)
+                       && op != static_cast<int>(ProfOp::MATMUL_CHUNK);
+        if (leaf && forward_ns > 0.0) {
+            f << ", \"forward_share\": " << double(h.sum()) / forward_ns;
+        }
+        f << " }";
+        first = false;
+    }
+
+    f << "\n  ],\n  \"by_layer\": [\n";
+
+    first = true;
+    for (const auto& [key, h] : per_op_layer) {
+        if (key.second < 0) continue;
+        f << (first ? "" : ",\n") << "    { \"op\": \"" << prof_op_name(static_cast<ProfOp>(key.first))
+          << "\", \"layer\": " << key.second << ", ";
+        write_stats(h);
+        f << " }";
+        first = false;
+    }
+
+    f << "\n  ]\n}\n";
+    return static_cast<bool>(f);
+}
+
+/* ================================================= */
+/* CHROME TRACE */
+/* ================================================= */
+
+bool Profiler::write_chrome_trace(const std::string& path) {
+    std::lock_guard<std::mutex> lock(g_registry_mtx);
+
+    uint64_t t0 = std::numeric_limits<uint64_t>::max();
+    for (const auto& b : g_buffers) {
+        for (const Event& e : b->events) t0 = std::min(t0, e.start_ns);
+    }
+
+    std::ofstream f(path, std::ios::trunc);
+    if (!f.is_open()) return false;
+
+    f << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+
+    bool first = true;
+    for (const auto& b : g_buffers) {
+        for (const Event& e : b->events) {
+            f << (first ? "" : ",\n")
+              << "{\"name\": \"" << prof_op_name(e.op) << "\""
+              << ", \"cat\": \"" << (e.layer >= 0 ? "layer" : "model") << "\""
+              << ", \"ph\": \"X\""
+              << ", \"ts\": " << double(e.start_ns - t0) / 1000.0
+              << ", \"dur\": " << double(e.end_ns - e.start_ns) / 1000.0
+              << ", \"pid\": 1, \"tid\": " << b->tid;
+            if (e.layer >= 0) f << ", \"args\": {\"layer\": " << e.layer << "}";
+            f << "}";
+            first = false;
+        }
+    }
+
+    f << "\n]}\n";
+    return static_cast<bool>(f);
+}
+
+} // namespace engine
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace engine {
+
+/**
+ * Profiler por op e por layer do backend CPU.
+ *
+ * - Cada thread grava eventos (op, layer, início, fim) no seu próprio
+ *   buffer, sem lock; o registro do buffer acontece uma vez por thread.
+ * - Ao final, os eventos são agregados em histogramas por (op, layer)
+ *   e exportados como resumo JSON e timeline Chrome trace_event
+ *   (chrome://tracing / Perfetto).
+ *
+ * Compilado só com ENGINE_PROFILING (opção CMake). Sem ela, as macros
+ * ENGINE_PROFILE_* expandem para nada e o hot path não muda.
+ * Com ela, o custo em runtime desligado é um load relaxado por escopo.
+ */
+enum class ProfOp : uint8_t {
+    FORWARD,
+    EMBEDDING,
+    RMS_NORM,
+    QKV_PROJ,
+    ATTENTION,
+    ATTN_OUT_PROJ,
+    FFN_UP_GATE,
+    FFN_ACT,
+    FFN_DOWN,
+    RESIDUAL,
+    OUTPUT_NORM,
+    OUTPUT_PROJ,
+    SAMPLING,
+    MATMUL_CHUNK,  // bloco de matmul executado por uma thread do pool
+    COUNT
+};
+
+const char* prof_op_name(ProfOp op);
+
+class Profiler {
+public:
+    static void set_enabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Grava um evento no buffer da thread corrente (sem lock).
+    static void record(ProfOp op, int layer, uint64_t start_ns, uint64_t end_ns);
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()
+            ).count()
+        );
+    }
+
+    // Descarta todos os eventos gravados.
+    // Deve ser chamado sem nenhuma thread gravando.
+    static void reset();
+
+    // Exporta (também sem threads gravando). Retorna false se não conseguir escrever.
+    static bool write_summary_json(const std::string& path);
+    static bool write_chrome_trace(const std::string& path);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Temporizador de escopo: grava um evento ao sair, se o profiler estiver ligado.
+class ProfileScope {
+public:
+    ProfileScope(ProfOp op, int layer)
+        : op_(op), layer_(layer),
+          start_(Profiler::enabled() ? Profiler::now_ns() : 0) {}
+
+    ~ProfileScope() {
+        if (start_ != 0) {
+            Profiler::record(op_, layer_, start_, Profiler::now_ns());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfOp op_;
+    int layer_;
+    uint64_t start_;
+};
+
+} // namespace engine
+
+#define ENGINE_PROFILE_CONCAT_(a, b) a##b
+#define ENGINE_PROFILE_CONCAT(a, b) ENGINE_PROFILE_CONCAT_(a, b)
+
+#ifdef ENGINE_PROFILING
+#define ENGINE_PROFILE_SCOPE(op, layer) \
+    ::engine::ProfileScope ENGINE_PROFILE_CONCAT(engine_prof_, __LINE__)(::engine::ProfOp::op, (layer))
+#else
+#define ENGINE_PROFILE_SCOPE(op, layer) ((void)(layer))
+#endif
@@ -3,6 +3,9 @@
 #include "sampler.h"
 #include "../backend/backend.h"
 #include "../backend/tensor.h"
+#include "../metrics/profiler.h"
+#include "../metrics/metrics_registry.h"
+#include "../core/logger.h"
 
 #include <iostream>
 #include <algorithm>
@@ -31,17 +34,65 @@ void GenerationStats::print() const {
     std::cout << "  Prefill: " << prefill_tokens_per_sec << " tokens/sec\n";
     std::cout << "  Decode: " << decode_tokens_per_sec << " tokens/sec\n";
 
+    std::cout << "\nLatency:\n";
+    std::cout << "  TTFT: " << ttft_ms << " ms\n";
+    std::cout << "  ITL p50/p90/p99/max: " << itl_p50_ms << " / " << itl_p90_ms
+              << " / " << itl_p99_ms << " / " << itl_max_ms << " ms\n";
+
     std::cout << "\nStop Reason: ";
     switch (stop_reason) {
         case MAX_TOKENS: std::cout << "MAX_TOKENS\n"; break;
         case EOS_TOKEN: std::cout << "EOS_TOKEN\n"; break;
         case STOP_TOKEN: std::cout << "STOP_TOKEN\n"; break;
+        case STOP_STRING: std::cout << "STOP_STRING\n"; break;
         case MIN_PROBABILITY: std::cout << "MIN_PROBABILITY\n"; break;
+        case ENERGY_BUDGET: std::cout << "ENERGY_BUDGET\n"; break;
         case ERROR: std::cout << "ERROR\n"; break;
     }
     std::cout << "============================\n\n";
 }
 
+// ============================================================================
+// Métricas exportadas (OpenMetrics)
+// ============================================================================
+
+namespace {
+
+struct GeneratorMetrics {
+    Counter& prompt_tokens;
+    Counter& generated_tokens;
+    Histogram& ttft;
+    Histogram& itl;
+    Histogram& request;
+
+    Counter& stopped(GenerationStats::StopReason reason) {
+        static const char* names[] = {
+            "max_tokens", "eos_token", "stop_token", "stop_string", "min_probability", "energy_budget", "error"
+        };
+        return MetricsRegistry::global().counter(
+            "engine_generator_requests", "Finished generation requests by stop reason",
+            {{"stop_reason", names[reason]}}
+        );
+    }
+};
+
+GeneratorMetrics& generator_metrics() {
+    auto& r = MetricsRegistry::global();
+    static GeneratorMetrics m{
+        r.counter("engine_generator_prompt_tokens", "Prompt tokens processed by prefill"),
+        r.counter("engine_generator_generated_tokens", "Tokens emitted by decode"),
+        r.histogram("engine_generator_ttft_seconds", "Time to first token",
+                    MetricsRegistry::latency_buckets()),
+        r.histogram("engine_generator_itl_seconds", "Inter-token latency",
+                    MetricsRegistry::latency_buckets()),
+        r.histogram("engine_generator_request_seconds", "Prefill + decode time per request",
+                    MetricsRegistry::latency_buckets()),
+    };
+    return m;
+}
+
+} // namespace
+
 // ============================================================================
 // AutoregressiveGenerator
 // ============================================================================
@@ -49,8 +100,10 @@ void GenerationStats::print() const {
 AutoregressiveGenerator::AutoregressiveGenerator(
     Backend* backend,
     SimpleTokenizer* tokenizer,
-    Sampler* sampler
-) : backend_(backend), tokenizer_(tokenizer), sampler_(sampler) {
+    Sampler* sampler,
+    uint32_t n_vocab
+) : backend_(backend), tokenizer_(tokenizer), sampler_(sampler),
+    n_vocab_(n_vocab ? n_vocab : static_cast<uint32_t>(tokenizer->vocab_size())) {
 }
 
 std::string AutoregressiveGenerator::generate(
@@ -63,14 +116,16 @@ std::string AutoregressiveGenerator::generate(
     auto prompt_tokens = tokenizer_->encode(prompt);
 
     if (config.verbose) {
-        std::cout << "[gen] prompt tokens: " << prompt_tokens.size() << "\n";
+        ENGINE_LOG_INFO("gen", "prompt tokens: " << prompt_tokens.size());
     }
 
     // 2. Generate tokens
     auto output_tokens = generate_tokens(prompt_tokens, config);
 
-    // 3. Detokenize
-    std::string result = tokenizer_->decode(output_tokens);
+    // 3. Detokenize (com stop strings, o texto já cortado no match)
+    std::string result = config.stop_strings.empty()
+        ? tokenizer_->decode(output_tokens)
+        : text_;
 
     auto end_time = std::chrono::steady_clock::now();
     stats_.total_ms = std::chrono::duration<double, std::milli>(
@@ -96,12 +151,38 @@ std::vector<int32_t> AutoregressiveGenerator::generate_tokens(
 ) {
     stats_ = GenerationStats{};  // Reset
     stats_.prompt_tokens = static_cast<int>(prompt_tokens.size());
+    itl_ns_.reset();
 
     std::vector<int32_t> output_tokens;
     output_tokens.reserve(config.max_tokens);
 
+    logits_buffer_.resize(n_vocab_);
+    energy_start_ = backend_->request_energy_joules();
+
+    // Histórico das penalidades começa pelo prompt
+    sampler_->reset_history();
+    for (int32_t token : prompt_tokens) sampler_->accept(token);
+
+    if (config.grammar) {
+        if (!vocab_trie_) {
+            vocab_trie_ = std::make_shared<VocabTrie>(*tokenizer_, n_vocab_);
+        }
+        if (!grammar_ || grammar_->grammar() != config.grammar.get()) {
+            grammar_ = std::make_unique<GrammarMatcher>(config.grammar, vocab_trie_, tokenizer_->eos_token());
+        } else {
+            grammar_->reset();
+        }
+    }
+
+    if (!config.stop_strings.empty() || config.text_callback) {
+        stop_strings_ = StopStringMatcher(config.stop_strings);
+    }
+    text_.clear();
+
     // FASE 1: Prefill (processa prompt)
     auto prefill_start = std::chrono::steady_clock::now();
+    gen_start_ = prefill_start;
+    last_token_time_ = {};
     prefill_phase(prompt_tokens, config);
     auto prefill_end = std::chrono::steady_clock::now();
 
@@ -114,6 +195,12 @@ std::vector<int32_t> AutoregressiveGenerator::generate_tokens(
             (stats_.prompt_tokens * 1000.0) / stats_.prefill_ms;
     }
 
+    if (stats_.stop_reason == GenerationStats::ENERGY_BUDGET ||
+        stats_.stop_reason == GenerationStats::ERROR) {
+        publish_metrics();
+        return output_tokens;
+    }
+
     // FASE 2: Decode (gera tokens autoregressivamente)
     auto decode_start = std::chrono::steady_clock::now();
     decode_phase(output_tokens, config);
@@ -130,9 +217,25 @@ std::vector<int32_t> AutoregressiveGenerator::generate_tokens(
             (stats_.generated_tokens * 1000.0) / stats_.decode_ms;
     }
 
+    stats_.itl_p50_ms = itl_ns_.percentile(0.50) / 1e6;
+    stats_.itl_p90_ms = itl_ns_.percentile(0.90) / 1e6;
+    stats_.itl_p99_ms = itl_ns_.percentile(0.99) / 1e6;
+    stats_.itl_max_ms = itl_ns_.max() / 1e6;
+
+    publish_metrics();
     return output_tokens;
 }
 
+void AutoregressiveGenerator::publish_metrics() const {
+    auto& m = generator_metrics();
+
+    m.prompt_tokens.inc(static_cast<uint64_t>(stats_.prompt_tokens));
+    m.generated_tokens.inc(static_cast<uint64_t>(stats_.generated_tokens));
+    if (stats_.generated_tokens > 0) m.ttft.observe(stats_.ttft_ms / 1000.0);
+    m.request.observe((stats_.prefill_ms + stats_.decode_ms) / 1000.0);
+    m.stopped(stats_.stop_reason).inc();
+}
+
 // ============================================================================
 // PREFILL PHASE
 // ============================================================================
@@ -142,40 +245,61 @@ void AutoregressiveGenerator::prefill_phase(
     const GenerationConfig& config
 ) {
     if (config.verbose) {
-        std::cout << "[gen] prefill phase: " << prompt_tokens.size() << " tokens\n";
+        ENGINE_LOG_INFO("gen", "prefill phase: " << prompt_tokens.size() << " tokens");
     }
 
+    backend_->set_phase(ExecutionPhase::PREFILL);
+
     // TODO FASE 4: Batch prefill (processa múltiplos tokens por vez)
-    // Por enquanto: token-by-token
+    // Por enquanto: token-by-token, em blocos de prefill_batch_size.
+    // Entre blocos: checagem do orçamento de energia; o backend pode
+    // reduzir o bloco (ex.: governador de potência no cap).
+
+    size_t i = 0;
+    while (i < prompt_tokens.size()) {
+        if (energy_budget_exhausted(config)) {
+            stats_.stop_reason = GenerationStats::ENERGY_BUDGET;
+            if (config.verbose) {
+                ENGINE_LOG_INFO("gen", "energy budget exhausted during prefill");
+            }
+            return;
+        }
+
+        int batch = std::max(1, config.prefill_batch_size);
+        if (const int limit = backend_->batch_limit(); limit > 0) {
+            batch = std::min(batch, limit);
+        }
 
-    for (size_t i = 0; i < prompt_tokens.size(); ++i) {
-        int32_t token = prompt_tokens[i];
+        const size_t end = std::min(prompt_tokens.size(), i + static_cast<size_t>(batch));
 
-        // Preparar input
-        TensorView in_view;
-        in_view.data = const_cast<int32_t*>(&token);
-        in_view.shape = {1};
+        for (; i < end; ++i) {
+            int32_t token = prompt_tokens[i];
 
-        // Alocar buffer de logits se necessário
-        if (logits_buffer_.empty()) {
-            logits_buffer_.resize(tokenizer_->vocab_size());
-        }
+            // Preparar input
+            TensorView in_view;
+            in_view.data = const_cast<int32_t*>(&token);
+            in_view.shape = {1};
 
-        TensorView out_view;
-        out_view.data = logits_buffer_.data();
-        out_view.shape = {tokenizer_->vocab_size()};
+            TensorView out_view;
+            out_view.data = logits_buffer_.data();
+            out_view.shape = {n_vocab_};
 
-        // Forward pass
-        backend_->forward(in_view, out_view);
+            // Forward pass
+            backend_->forward(in_view, out_view);
+            if (!backend_->last_forward_ok()) {
+                ENGINE_LOG_WARN("gen", "forward failed at prompt token " << i << ": stopping");
+                stats_.stop_reason = GenerationStats::ERROR;
+                return;
+            }
 
-        if (config.verbose && i % 10 == 0) {
-            std::cout << "[gen] prefill progress: " << i << "/"
-                      << prompt_tokens.size() << "\n";
+            if (config.verbose && i % 10 == 0) {
+                ENGINE_LOG_DEBUG("gen", "prefill progress: " << i << "/" << prompt_tokens.size());
+            }
         }
     }
 
     if (config.verbose) {
-        std::cout << "[gen] prefill complete\n";
+        ENGINE_LOG_INFO("gen", "prefill complete");
     }
 }
 
@@ -188,30 +312,76 @@ void AutoregressiveGenerator::decode_phase(
     const GenerationConfig& config
 ) {
     if (config.verbose) {
-        std::cout << "[gen] decode phase: max " << config.max_tokens << " tokens\n";
+        ENGINE_LOG_INFO("gen", "decode phase: max " << config.max_tokens << " tokens");
     }
 
+    backend_->set_phase(ExecutionPhase::DECODE);
+
     int32_t current_token = 0;  // Será setado pelo primeiro sample
 
     for (int i = 0; i < config.max_tokens; ++i) {
-        // 1. Forward pass (usa último token ou logits do prefill)
+        // 0. Orçamento de energia do request
+        if (energy_budget_exhausted(config)) {
+            stats_.stop_reason = GenerationStats::ENERGY_BUDGET;
+            break;
+        }
+
+        // 1. Forward pass (usa último token ou logits do prefill).
+        // Quando o sampler só precisa dos k maiores logits, o backend pode
+        // fundir o lm_head com a seleção e não escrever o vetor inteiro.
+        int top_k = 0;
+        bool fused = false;
+
         if (i > 0) {
             TensorView in_view;
             in_view.data = &current_token;
             in_view.shape = {1};
 
-            TensorView out_view;
-            out_view.data = logits_buffer_.data();
-            out_view.shape = {tokenizer_->vocab_size()};
+            const bool full_logits = config.min_probability > 0.0f || config.grammar;
+            top_k = full_logits ? 0 : sampler_->top_logits_needed();
+            if (top_k > 0) {
+                top_values_.resize(top_k);
+                top_indices_.resize(top_k);
+                fused = backend_->forward_top_k(in_view, top_k, top_values_.data(), top_indices_.data());
+            }
 
-            backend_->forward(in_view, out_view);
+            if (!fused) {
+                TensorView out_view;
+                out_view.data = logits_buffer_.data();
+                out_view.shape = {n_vocab_};
+
+                backend_->forward(in_view, out_view);
+            }
+
+            // Logits (ou top-k) do passo anterior: amostrar deles geraria lixo
+            if (!backend_->last_forward_ok()) {
+                ENGINE_LOG_WARN("gen", "forward failed at token " << i << ": stopping");
+                stats_.stop_reason = GenerationStats::ERROR;
+                break;
+            }
         }
 
-        // 2. Sample próximo token
-        current_token = sampler_->sample(
-            logits_buffer_.data(),
-            static_cast<int>(tokenizer_->vocab_size())
-        );
+        // 2. Sample próximo token (restrito à gramática, se houver)
+        {
+            ENGINE_PROFILE_SCOPE(SAMPLING, -1);
+
+            if (config.grammar && grammar_->apply(logits_buffer_.data(), static_cast<int>(n_vocab_)) == 0) {
+                ENGINE_LOG_WARN("gen", "grammar allows no token in the current state");
+                stats_.stop_reason = GenerationStats::ERROR;
+                break;
+            }
+
+            current_token = fused
+                ? sampler_->sample_top(top_values_.data(), top_indices_.data(),
+                                       top_k, static_cast<int>(n_vocab_))
+                : sampler_->sample(logits_buffer_.data(), static_cast<int>(n_vocab_));
+
+            if (config.grammar && !grammar_->accept(current_token)) {
+                ENGINE_LOG_WARN("gen", "grammar rejected sampled token " << current_token);
+                stats_.stop_reason = GenerationStats::ERROR;
+                break;
+            }
+        }
 
         // 3. Calcula probabilidade (para stopping criterion)
         float probability = 0.0f;
@@ -232,37 +402,102 @@ void AutoregressiveGenerator::decode_phase(
         }
 
         // 4. Check stopping criteria
-        if (should_stop(current_token, i, probability, config)) {
+        if (should_stop(current_token, probability, config)) {
+            break;
+        }
+
+        // 5. Stop strings sobre o texto (o token que completa o match não
+        // entra na saída; o texto antes da ocorrência, sim)
+        if (emit_text(current_token, config)) {
+            stats_.stop_reason = GenerationStats::STOP_STRING;
             break;
         }
 
-        // 5. Add to output
+        // 6. Add to output
         output_tokens.push_back(current_token);
+        sampler_->accept(current_token);
+        mark_token_emitted();
 
-        // 6. Callback (streaming)
+        // 7. Callback (streaming)
         if (config.stream && config.token_callback) {
             config.token_callback(current_token);
         }
 
-        // 7. Log progress
+        // 8. Log progress
         if (config.verbose && (i + 1) % 10 == 0) {
-            std::cout << "[gen] generated " << (i + 1) << " tokens\n";
+            ENGINE_LOG_DEBUG("gen", "generated " << (i + 1) << " tokens");
+        }
+
+        // 9. Max tokens (após emitir o token: gera exatamente max_tokens)
+        if (static_cast<int>(output_tokens.size()) >= config.max_tokens) {
+            stats_.stop_reason = GenerationStats::MAX_TOKENS;
+            break;
         }
     }
 
+    // Sem match: o prefixo parcial retido é texto normal
+    flush_text(config);
+
     if (config.verbose) {
-        std::cout << "[gen] decode complete: " << output_tokens.size()
-                  << " tokens generated\n";
+        ENGINE_LOG_INFO("gen", "decode complete: " << output_tokens.size() << " tokens generated");
+    }
+}
+
+bool AutoregressiveGenerator::emit_text(int32_t token, const GenerationConfig& config) {
+    if (config.stop_strings.empty() && !config.text_callback) {
+        return false;
+    }
+
+    text_chunk_.clear();
+    const bool matched = stop_strings_.feed(tokenizer_->token_piece(token), text_chunk_);
+
+    text_ += text_chunk_;
+    if (config.stream && config.text_callback && !text_chunk_.empty()) {
+        config.text_callback(text_chunk_);
+    }
+
+    if (matched && config.verbose) {
+        ENGINE_LOG_INFO("gen", "stop string matched");
+    }
+
+    return matched;
+}
+
+void AutoregressiveGenerator::flush_text(const GenerationConfig& config) {
+    if (config.stop_strings.empty() && !config.text_callback) {
+        return;
+    }
+
+    const std::string held = stop_strings_.held();
+    stop_strings_.reset();
+    if (held.empty()) return;
+
+    text_ += held;
+    if (config.stream && config.text_callback) {
+        config.text_callback(held);
     }
 }
 
+void AutoregressiveGenerator::mark_token_emitted() {
+    const auto now = std::chrono::steady_clock::now();
+
+    if (last_token_time_ == std::chrono::steady_clock::time_point{}) {
+        stats_.ttft_ms = std::chrono::duration<double, std::milli>(now - gen_start_).count();
+    } else {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_token_time_).count();
+        itl_ns_.record(static_cast<uint64_t>(ns));
+        generator_metrics().itl.observe(static_cast<double>(ns) / 1e9);
+    }
+
+    last_token_time_ = now;
+}
+
 // ============================================================================
 // STOPPING CRITERIA
 // ============================================================================
 
 bool AutoregressiveGenerator::should_stop(
     int32_t token,
-    int generated_count,
     float probability,
     const GenerationConfig& config
 ) const {
@@ -294,14 +529,24 @@ bool AutoregressiveGenerator::should_stop(
         return true;
     }
 
-    // 4. Max tokens
-    if (generated_count >= config.max_tokens - 1) {
-        const_cast<AutoregressiveGenerator*>(this)->stats_.stop_reason =
-            GenerationStats::MAX_TOKENS;
-        return true;
+    return false;
+}
+
+bool AutoregressiveGenerator::energy_budget_exhausted(
+    const GenerationConfig& config
+) const {
+    if (config.max_joules <= 0.0 || !energy_start_.has_value()) {
+        return false;
     }
 
-    return false;
+    // Total do ledger do amostrador: sem E/S de arquivo por token; a
+    // resolução é o intervalo de amostragem
+    const auto now = backend_->request_energy_joules();
+    if (!now.has_value()) {
+        return false;
+    }
+
+    return (*now - *energy_start_) >= config.max_joules;
 }
 
 // ============================================================================
@@ -324,7 +569,10 @@ std::vector<BatchGenerationResult> BatchGenerator::generate_batch(
     results.reserve(requests.size());
 
     for (const auto& req : requests) {
-        AutoregressiveGenerator gen(backend_, tokenizer_, nullptr);
+        // Stream próprio por request: os tokens não dependem de quem mais
+        // está no batch nem da ordem de execução
+        Sampler sampler(req.sampling, static_cast<uint64_t>(req.request_id));
+        AutoregressiveGenerator gen(backend_, tokenizer_, &sampler);
 
         std::string output = gen.generate(req.prompt, req.config);
 
@@ -5,11 +5,17 @@
 #include <string>
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <optional>
+
+#include "metrics/histogram.h"
+#include "model/grammar.h"
+#include "model/sampler.h"
+#include "model/stop_strings.h"
 
 namespace engine {
 
 class SimpleTokenizer;
-class Sampler;
 class Backend;
 
 // ============================================================================
@@ -18,16 +24,23 @@ class Backend;
 
 struct GenerationConfig {
     // Limites
-    int max_tokens = 512;
+    int max_tokens = 512;              // Gera no máximo exatamente max_tokens
     int max_context_length = 2048;
 
     // Stopping criteria
     std::vector<int32_t> stop_tokens;  // EOS, etc
+    std::vector<std::string> stop_strings;  // Texto; podem atravessar tokens
     float min_probability = 0.0f;      // Stop se prob < threshold
+    double max_joules = 0.0;           // Orçamento de energia do request (0 = sem limite)
+
+    // Decodificação restrita: só tokens que a gramática aceita (nullptr = livre)
+    std::shared_ptr<const Grammar> grammar;
 
     // Streaming
     bool stream = true;
     std::function<void(int32_t)> token_callback;  // Called for each token
+    // Texto liberado, já sem stop strings (o prefixo parcial fica retido)
+    std::function<void(const std::string&)> text_callback;
 
     // Performance
     bool use_kv_cache = true;
@@ -57,14 +70,24 @@ struct GenerationStats {
     double prefill_tokens_per_sec = 0.0;
     double decode_tokens_per_sec = 0.0;
 
+    // Latência: TTFT (início do prefill → primeiro token emitido)
+    // e inter-token latency entre tokens emitidos consecutivos
+    double ttft_ms = 0.0;
+    double itl_p50_ms = 0.0;
+    double itl_p90_ms = 0.0;
+    double itl_p99_ms = 0.0;
+    double itl_max_ms = 0.0;
+
     // Stopping reason
     enum StopReason {
         MAX_TOKENS,
         EOS_TOKEN,
         STOP_TOKEN,
+        STOP_STRING,
         MIN_PROBABILITY,
+        ENERGY_BUDGET,
         ERROR
-    } stop_reason;
+    } stop_reason = MAX_TOKENS;
 
     void print() const;
 };
@@ -75,10 +98,13 @@ struct GenerationStats {
 
 class AutoregressiveGenerator {
 public:
+    // n_vocab: tamanho dos logits produzidos pelo backend
+    // (0 = usa o vocabulário do tokenizer)
     AutoregressiveGenerator(
         Backend* backend,
         SimpleTokenizer* tokenizer,
-        Sampler* sampler
+        Sampler* sampler,
+        uint32_t n_vocab = 0
     );
 
     // Gera texto dado um prompt
@@ -96,12 +122,27 @@ public:
     // Estatísticas da última geração
     const GenerationStats& stats() const { return stats_; }
 
+    // Histograma de inter-token latency (ns) da última geração
+    const LogHistogram& itl_histogram() const { return itl_ns_; }
+
 private:
     Backend* backend_;
     SimpleTokenizer* tokenizer_;
     Sampler* sampler_;
+    uint32_t n_vocab_;
 
     GenerationStats stats_;
+    LogHistogram itl_ns_;
+
+    // Marcação de tempo dos tokens emitidos
+    std::chrono::steady_clock::time_point gen_start_;
+    std::chrono::steady_clock::time_point last_token_time_;
+    void mark_token_emitted();
+    void publish_metrics() const;
+
+    // Energia já atribuída ao request no início (quando o backend tem medidor)
+    std::optional<double> energy_start_;
+    bool energy_budget_exhausted(const GenerationConfig& config) const;
 
     // Internal phases
     void prefill_phase(
@@ -116,13 +157,26 @@ private:
 
     bool should_stop(
         int32_t token,
-        int generated_count,
         float probability,
         const GenerationConfig& config
     ) const;
 
     // Buffers
     std::vector<float> logits_buffer_;
+    std::vector<float> top_values_;     // lm_head fundido (forward_top_k)
+    std::vector<int32_t> top_indices_;
+
+    // Gramática: trie do vocabulário (uma vez) e estado + cache de máscaras,
+    // reaproveitados enquanto a mesma gramática for usada
+    std::shared_ptr<const VocabTrie> vocab_trie_;
+    std::unique_ptr<GrammarMatcher> grammar_;
+
+    // Texto gerado, cortado no stop string (usado quando há stop_strings)
+    StopStringMatcher stop_strings_;
+    std::string text_;
+    std::string text_chunk_;
+    bool emit_text(int32_t token, const GenerationConfig& config);
+    void flush_text(const GenerationConfig& config);
 };
 
 // ============================================================================
@@ -132,6 +186,7 @@ private:
 struct BatchGenerationRequest {
     std::string prompt;
     GenerationConfig config;
+    SamplingConfig sampling;  // RNG por contador com stream = request_id
     int request_id = 0;
 };
 
@@ -0,0 +1,68 @@
+#include "model/batch_sampler.h"
+#include "core/thread_pool.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace engine {
+
+BatchSampler::BatchSampler(ThreadPool* pool) : pool_(pool) {}
+
+void BatchSampler::add_sequence(uint64_t seq_id, const SamplingConfig& config) {
+    sequences_[seq_id] = std::make_unique<Sampler>(config, seq_id);
+}
+
+void BatchSampler::remove_sequence(uint64_t seq_id) {
+    sequences_.erase(seq_id);
+}
+
+bool BatchSampler::has_sequence(uint64_t seq_id) const {
+    return sequences_.count(seq_id) != 0;
+}
+
+Sampler& BatchSampler::sequence(uint64_t seq_id) {
+    auto it = sequences_.find(seq_id);
+    if (it == sequences_.end()) {
+        throw std::invalid_argument("[sampler] unknown sequence " + std::to_string(seq_id));
+    }
+    return *it->second;
+}
+
+void BatchSampler::sample(const float* logits, int batch, int vocab,
+                          const uint64_t* seq_ids, int32_t* out) {
+    // Resolve as linhas antes de paralelizar: cada Sampler só pode estar
+    // em uma linha (ele tem estado e scratch próprios)
+    rows_.resize(batch);
+    for (int b = 0; b < batch; ++b) {
+        Sampler* s = &sequence(seq_ids[b]);
+        for (int j = 0; j < b; ++j) {
+            if (rows_[j] == s) {
+                throw std::invalid_argument(
+                    "[sampler] sequence " + std::to_string(seq_ids[b]) + " repeated in batch");
+            }
+        }
+        rows_[b] = s;
+    }
+
+    auto run = [&](int begin, int end, int /*tid*/) {
+        for (int b = begin; b < end; ++b) {
+            out[b] = rows_[b]->sample(logits + static_cast<size_t>(b) * vocab, vocab);
+            rows_[b]->accept(out[b]);
+        }
+    };
+
+    if (pool_ && batch > 1) {
+        pool_->parallel_for(batch, run, 1);
+    } else {
+        run(0, batch, 0);
+    }
+}
+
+std::vector<int32_t> BatchSampler::sample(const float* logits, int vocab,
+                                          const std::vector<uint64_t>& seq_ids) {
+    std::vector<int32_t> out(seq_ids.size());
+    sample(logits, static_cast<int>(seq_ids.size()), vocab, seq_ids.data(), out.data());
+    return out;
+}
+
+} // namespace engine
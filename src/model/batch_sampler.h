@@ -0,0 +1,51 @@
+#pragma once
+
+#include "model/sampler.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+
+class ThreadPool;
+
+/**
+ * Sampling em lote: logits [batch, vocab] → um token por linha.
+ *
+ * - Cada sequência tem o próprio Sampler (config, histórico de
+ *   penalidades, scratch) e um stream Philox = seq_id. O token sorteado
+ *   depende só de (logits, config, seed, seq_id, passo da sequência), então
+ *   o resultado não muda com a composição, a ordem do batch ou as threads.
+ * - As linhas rodam em paralelo no pool (uma sequência por vez por linha).
+ */
+class BatchSampler {
+public:
+    // pool = nullptr → linhas em série na thread chamadora
+    explicit BatchSampler(ThreadPool* pool = nullptr);
+
+    // Registra (ou reinicia) a sequência com config própria
+    void add_sequence(uint64_t seq_id, const SamplingConfig& config);
+    void remove_sequence(uint64_t seq_id);
+    bool has_sequence(uint64_t seq_id) const;
+
+    // Acesso ao Sampler da sequência (ex.: histórico do prompt)
+    Sampler& sequence(uint64_t seq_id);
+
+    // logits: [batch, vocab] contíguo; a linha b é da sequência seq_ids[b].
+    // O token sorteado entra no histórico de penalidades da sequência.
+    // Lança std::invalid_argument para sequência desconhecida ou repetida.
+    void sample(const float* logits, int batch, int vocab,
+                const uint64_t* seq_ids, int32_t* out);
+
+    std::vector<int32_t> sample(const float* logits, int vocab,
+                                const std::vector<uint64_t>& seq_ids);
+
+private:
+    ThreadPool* pool_;
+    std::unordered_map<uint64_t, std::unique_ptr<Sampler>> sequences_;
+    std::vector<Sampler*> rows_;
+};
+
+} // namespace engine
@@ -1,7 +1,10 @@
 #include "gguf_inspector.h"
+#include "core/logger.h"
 
+#include <algorithm>
+#include <charconv>
 #include <fstream>
-#include <iostream>
+#include <map>
 #include <stdexcept>
 
 namespace engine {
@@ -56,6 +59,24 @@ private:
     std::ifstream in_;
 };
 
+// "llama.block_count" casa com "block_count"
+static bool key_is(const std::string& key, const std::string& name) {
+    if (key == name) return true;
+    return key.size() > name.size()
+        && key.compare(key.size() - name.size(), name.size(), name) == 0
+        && key[key.size() - name.size() - 1] == '.';
+}
+
+static bool is_int_type(gguf_type t) {
+    switch (t) {
+        case gguf_type::INT8:  case gguf_type::INT16:  case gguf_type::INT32:  case gguf_type::INT64:
+        case gguf_type::UINT8: case gguf_type::UINT16: case gguf_type::UINT32: case gguf_type::UINT64:
+            return true;
+        default:
+            return false;
+    }
+}
+
 static std::optional<std::string> map_file_type(int64_t ft) {
     switch (ft) {
         case 4:  return "Q8_0";
@@ -82,7 +103,7 @@ static int64_t read_int(BinReader& r, gguf_type t) {
 
 static void skip_value(BinReader& r, gguf_type t) {
     switch (t) {
-        case gguf_type::STRING: r.read_string(); break;
+        case gguf_type::STRING: r.skip(r.read_le<uint64_t>()); break;
         case gguf_type::ARRAY: {
             auto subtype = static_cast<gguf_type>(r.read_le<uint32_t>());
             uint64_t n = r.read_le<uint64_t>();
@@ -135,18 +156,126 @@ GgufInfo GgufInspector::inspect_metadata(const std::string& path) {
             continue;
         }
 
-        if ((key == "context_length" || key == "n_ctx_train")
-            && (type == gguf_type::UINT32 || type == gguf_type::INT32)) {
+        if ((key_is(key, "context_length") || key == "n_ctx_train") && is_int_type(type)) {
             info.context_length = static_cast<uint32_t>(read_int(r, type));
             continue;
         }
 
+        if (key_is(key, "embedding_length") && is_int_type(type)) {
+            info.embedding_length = static_cast<uint32_t>(read_int(r, type));
+            continue;
+        }
+
+        if (key_is(key, "block_count") && is_int_type(type)) {
+            info.block_count = static_cast<uint32_t>(read_int(r, type));
+            continue;
+        }
+
+        if (key == "tokenizer.ggml.tokens" && type == gguf_type::ARRAY) {
+            const auto subtype = static_cast<gguf_type>(r.read_le<uint32_t>());
+            const uint64_t n = r.read_le<uint64_t>();
+            info.vocab_size = static_cast<uint32_t>(n);
+            for (uint64_t j = 0; j < n; ++j) skip_value(r, subtype);
+            continue;
+        }
+
         skip_value(r, type);
     }
 
+    // Cabeçalhos dos tensores (os dados não são lidos)
+    info.tensors.reserve(info.tensor_count);
+    for (uint64_t i = 0; i < info.tensor_count; ++i) {
+        GgufTensorInfo t;
+        t.name = r.read_string();
+        t.n_dims = r.read_le<uint32_t>();
+        t.dims.resize(t.n_dims);
+        for (auto& d : t.dims) d = r.read_le<uint64_t>();
+        t.type = static_cast<GgmlType>(r.read_le<uint32_t>());
+        t.offset = r.read_le<uint64_t>();
+        info.tensors.push_back(std::move(t));
+    }
+
     return info;
 }
 
+GgufEstimate GgufInspector::estimate(const GgufInfo& info, const GgufEstimateOptions& options) {
+    GgufEstimate e;
+
+    const GgufTensorInfo* token_embd = nullptr;
+    uint32_t max_block = 0;
+
+    std::map<std::string, GgufEstimate::TypeBytes> by_type;
+
+    for (const auto& t : info.tensors) {
+        const uint64_t file_bytes = t.nbytes();
+        const uint64_t f32_bytes = t.numel() * sizeof(float);
+
+        auto& tb = by_type[ggml_type_name(t.type)];
+        tb.type = ggml_type_name(t.type);
+        ++tb.tensors;
+        tb.bytes += file_bytes;
+
+        e.weights_bytes += file_bytes;
+        if (t.type != GgmlType::F32) e.dequant_bytes += f32_bytes;
+
+        if (t.name == "token_embd.weight") {
+            token_embd = &t;
+            continue;  // o decode lê uma linha só
+        }
+
+        // Kernels leem a cópia F32 (ou o próprio mmap, se já for F32)
+        e.streamed_bytes_per_token += f32_bytes;
+
+        // blk.<n>.*: layers pelo maior índice; nome fora desse formato não conta
+        if (t.name.rfind("blk.", 0) == 0) {
+            const char* first = t.name.data() + 4;
+            const char* last = t.name.data() + t.name.size();
+            uint32_t block = 0;
+            const auto [end, ec] = std::from_chars(first, last, block);
+            if (ec == std::errc() && (end == last || *end == '.') && block < UINT32_MAX) {
+                max_block = std::max<uint32_t>(max_block, block + 1);
+            }
+        }
+    }
+
+    for (auto& [name, tb] : by_type) e.weights_by_type.push_back(tb);
+
+    e.n_layers = info.block_count.value_or(max_block);
+    e.n_embd = info.embedding_length.value_or(
+        token_embd && token_embd->n_dims >= 1 ? static_cast<uint32_t>(token_embd->dims[0]) : 0
+    );
+    e.n_vocab = info.vocab_size.value_or(
+        token_embd && token_embd->n_dims >= 2 ? static_cast<uint32_t>(token_embd->dims[1]) : 0
+    );
+    e.context = options.context > 0 ? options.context : info.context_length.value_or(0);
+    e.batch = std::max<uint32_t>(1, options.batch);
+
+    if (e.n_embd == 0) {
+        throw std::runtime_error("GGUF: embedding length not detected");
+    }
+    if (e.context == 0) {
+        throw std::runtime_error("GGUF: context length not detected (pass a context)");
+    }
+
+    e.streamed_bytes_per_token += uint64_t(e.n_embd) * sizeof(float);
+
+    e.kv_bytes = 2ull * e.n_layers * e.context * e.n_embd * sizeof(float) * e.batch;
+
+    // embed/hidden/logits + residual, Q/K/V, saída da atenção, gate/up (4·n_embd)
+    e.scratch_bytes = (uint64_t(e.n_embd) * (2 + 1 + 4 + 2 * 4) + e.n_vocab) * sizeof(float);
+
+    e.bandwidth_gbps = options.bandwidth_gbps;
+    if (e.bandwidth_gbps > 0.0 && e.streamed_bytes_per_token > 0) {
+        e.tokens_per_sec = e.bandwidth_gbps * 1e9 / double(e.streamed_bytes_per_token);
+    }
+
+    return e;
+}
+
+GgufEstimate GgufInspector::estimate(const std::string& gguf_path, const GgufEstimateOptions& options) {
+    return estimate(inspect_metadata(gguf_path), options);
+}
+
 GgufCapabilities GgufInspector::inspect_capabilities(
     const std::string& gguf_path
 ) {
@@ -187,12 +316,12 @@ std::string GgufInspector::validate_or_resolve_quant(
         " detected=" + caps.quant;
 
     if (policy == GgufMismatchPolicy::Warning) {
-        std::cerr << msg << "\n";
+        ENGINE_LOG_WARN("gguf", msg);
         return expected_quant;
     }
 
     if (policy == GgufMismatchPolicy::Fallback) {
-        std::cerr << msg << " (fallback)\n";
+        ENGINE_LOG_WARN("gguf", msg << " (fallback)");
         return caps.quant;
     }
 
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "model/gguf_loader.h"
+
 #include <string>
 #include <optional>
 #include <cstdint>
+#include <vector>
 
 namespace engine {
 
@@ -21,6 +24,54 @@ struct GgufInfo {
     std::optional<std::string> detected_quant;
     std::optional<std::string> general_arch;
     std::optional<uint32_t> context_length;
+    std::optional<uint32_t> embedding_length;
+    std::optional<uint32_t> block_count;
+    std::optional<uint32_t> vocab_size;     // tamanho de tokenizer.ggml.tokens
+
+    std::vector<GgufTensorInfo> tensors;    // só o cabeçalho (offset relativo)
+};
+
+struct GgufEstimateOptions {
+    uint32_t context = 0;         // 0 = contexto do modelo
+    uint32_t batch = 1;           // sequências simultâneas (KV por sequência)
+    double bandwidth_gbps = 0.0;  // banda de leitura do host; 0 = sem tokens/s
+};
+
+/**
+ * Estimativa de memória e throughput a partir só do cabeçalho do GGUF,
+ * seguindo o que o backend CPU faz no load:
+ *   - pesos: o arquivo fica em mmap; tensores não-F32 ganham cópia F32
+ *   - KV: K e V de n_layers × contexto × n_embd floats, por sequência
+ *   - scratch: buffers fixos + temporários de um layer
+ * tokens/s é o teto de decode memory-bound: banda / bytes lidos por token.
+ */
+struct GgufEstimate {
+    struct TypeBytes {
+        std::string type;
+        uint64_t tensors = 0;
+        uint64_t bytes = 0;
+    };
+
+    uint32_t n_layers = 0;
+    uint32_t n_embd = 0;
+    uint32_t n_vocab = 0;
+    uint32_t context = 0;
+    uint32_t batch = 1;
+
+    std::vector<TypeBytes> weights_by_type;
+    uint64_t weights_bytes = 0;   // mapeado (arquivo)
+    uint64_t dequant_bytes = 0;   // cópias F32 dos tensores quantizados
+    uint64_t kv_bytes = 0;
+    uint64_t scratch_bytes = 0;
+
+    uint64_t streamed_bytes_per_token = 0;
+    double bandwidth_gbps = 0.0;
+    double tokens_per_sec = 0.0;
+
+    // RAM necessária (conservador: conta o mapeamento inteiro como residente)
+    uint64_t total_bytes() const {
+        return weights_bytes + dequant_bytes + kv_bytes + scratch_bytes;
+    }
 };
 
 struct GgufCapabilities {
@@ -35,6 +86,9 @@ public:
 
     static GgufCapabilities inspect_capabilities(const std::string& gguf_path);
 
+    static GgufEstimate estimate(const GgufInfo& info, const GgufEstimateOptions& options);
+    static GgufEstimate estimate(const std::string& gguf_path, const GgufEstimateOptions& options);
+
     static std::string validate_or_resolve_quant(
         const std::string& gguf_path,
         const std::string& expected_quant,
@@ -1,8 +1,8 @@
 #include "model/gguf_loader.h"
+#include "core/logger.h"
 
 #include <cstring>
 #include <sstream>
-#include <iostream>
 #include <stdexcept>
 
 #ifdef __linux__
@@ -124,6 +124,72 @@ uint64_t GgufTensorInfo::numel() const {
     return n;
 }
 
+uint64_t GgufTensorInfo::nbytes() const {
+    const uint64_t per_block = ggml_type_block_elems(type);
+    return (numel() + per_block - 1) / per_block * ggml_type_block_bytes(type);
+}
+
+size_t ggml_type_block_bytes(GgmlType type) {
+    switch(type){
+        case GgmlType::F32:     return 4;
+        case GgmlType::F16:     return 2;
+        case GgmlType::Q4_0:    return 18;
+        case GgmlType::Q4_1:    return 20;
+        case GgmlType::Q5_0:    return 22;
+        case GgmlType::Q5_1:    return 24;
+        case GgmlType::Q8_0:    return 34;
+        case GgmlType::Q8_1:    return 36;
+        case GgmlType::Q2_K:    return 84;
+        case GgmlType::Q3_K:    return 110;
+        case GgmlType::Q4_K:    return 144;
+        case GgmlType::Q5_K:    return 176;
+        case GgmlType::Q6_K:    return 210;
+        case GgmlType::Q8_K:    return 292;
+        case GgmlType::IQ2_XXS: return 66;
+        case GgmlType::IQ2_XS:  return 74;
+    }
+    return 4;
+}
+
+size_t ggml_type_block_elems(GgmlType type) {
+    switch(type){
+        case GgmlType::F32:
+        case GgmlType::F16:
+            return 1;
+        case GgmlType::Q4_0:
+        case GgmlType::Q4_1:
+        case GgmlType::Q5_0:
+        case GgmlType::Q5_1:
+        case GgmlType::Q8_0:
+        case GgmlType::Q8_1:
+            return 32;
+        default:
+            return 256;  // K-quants e IQ2
+    }
+}
+
+const char* ggml_type_name(GgmlType type) {
+    switch(type){
+        case GgmlType::F32:     return "F32";
+        case GgmlType::F16:     return "F16";
+        case GgmlType::Q4_0:    return "Q4_0";
+        case GgmlType::Q4_1:    return "Q4_1";
+        case GgmlType::Q5_0:    return "Q5_0";
+        case GgmlType::Q5_1:    return "Q5_1";
+        case GgmlType::Q8_0:    return "Q8_0";
+        case GgmlType::Q8_1:    return "Q8_1";
+        case GgmlType::Q2_K:    return "Q2_K";
+        case GgmlType::Q3_K:    return "Q3_K";
+        case GgmlType::Q4_K:    return "Q4_K";
+        case GgmlType::Q5_K:    return "Q5_K";
+        case GgmlType::Q6_K:    return "Q6_K";
+        case GgmlType::Q8_K:    return "Q8_K";
+        case GgmlType::IQ2_XXS: return "IQ2_XXS";
+        case GgmlType::IQ2_XS:  return "IQ2_XS";
+    }
+    return "unknown";
+}
+
 const void* GgufModel::tensor_ptr(const std::string& name) const {
     auto it=tensors_.find(name);
     if(it==tensors_.end()) return nullptr;
@@ -276,8 +342,8 @@ GgufModel GgufLoader::load(const std::string& path){
         auto* emb_info = model.tensor_info("token_embd.weight");
         if (emb_info && emb_info->n_dims >= 2) {
             model.vocab_size_ = emb_info->dims[1];
-            std::cout << "[gguf] inferred vocab_size=" << model.vocab_size_
-                      << " from token_embd shape\n";
+            ENGINE_LOG_INFO("gguf", "inferred vocab_size=" << model.vocab_size_
+                            << " from token_embd shape");
         }
     }
 
@@ -287,7 +353,7 @@ GgufModel GgufLoader::load(const std::string& path){
             model.n_heads_ = model.embedding_dim_ / 64;
         }
         if (model.n_heads_ > 0) {
-            std::cout << "[gguf] inferred n_heads=" << model.n_heads_ << "\n";
+            ENGINE_LOG_INFO("gguf", "inferred n_heads=" << model.n_heads_);
         }
     }
 
@@ -296,7 +362,7 @@ GgufModel GgufLoader::load(const std::string& path){
         if (model.n_kv_heads_ == 0) {
             model.n_kv_heads_ = model.n_heads_;
         }
-        std::cout << "[gguf] inferred n_kv_heads=" << model.n_kv_heads_ << "\n";
+        ENGINE_LOG_INFO("gguf", "inferred n_kv_heads=" << model.n_kv_heads_);
     }
 
     return model;
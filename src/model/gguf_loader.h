@@ -29,6 +29,11 @@ enum class GgmlType : uint32_t {
     IQ2_XS  = 17,
 };
 
+// Bytes por bloco e elementos por bloco de cada tipo (layout GGML).
+size_t ggml_type_block_bytes(GgmlType type);
+size_t ggml_type_block_elems(GgmlType type);
+const char* ggml_type_name(GgmlType type);
+
 /* -----------------------------
  * Tensor metadata
  * ----------------------------- */
@@ -40,6 +45,7 @@ struct GgufTensorInfo {
     uint64_t offset = 0;
 
     uint64_t numel() const;
+    uint64_t nbytes() const;  // tamanho no arquivo (quantizado)
 };
 
 /* -----------------------------
@@ -62,6 +68,10 @@ public:
 
     std::string summary() const;
 
+    /* --- mapeamento do arquivo (mmap, somente leitura) --- */
+    const void* file_base() const { return file_base_; }
+    size_t file_size() const { return file_size_; }
+
     /* --- tokenizer (do GGUF) --- */
     const std::vector<std::string>& tokenizer_tokens() const { return tokenizer_tokens_; }
     const std::vector<float>& tokenizer_scores() const { return tokenizer_scores_; }
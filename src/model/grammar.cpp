@@ -0,0 +1,620 @@
+#include "model/grammar.h"
+#include "model/tokenizer.h"
+#include "backend/cpu/ops_simd.h"
+#include "metrics/metrics_registry.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace engine {
+
+// ============================================================================
+// Métricas exportadas (OpenMetrics)
+// ============================================================================
+
+namespace {
+
+struct GrammarMetrics {
+    Counter& mask_hits;
+    Counter& mask_misses;
+    Counter& rejected;
+};
+
+GrammarMetrics& grammar_metrics() {
+    auto& r = MetricsRegistry::global();
+    static GrammarMetrics m{
+        r.counter("engine_grammar_masks", "Token masks served per grammar state", {{"result", "hit"}}),
+        r.counter("engine_grammar_masks", "Token masks served per grammar state", {{"result", "miss"}}),
+        r.counter("engine_grammar_rejected_tokens", "Sampled tokens the grammar did not accept"),
+    };
+    return m;
+}
+
+// Máscaras em cache por matcher; passa disso, recomeça (estados raros)
+constexpr size_t MAX_CACHED_MASKS = 4096;
+
+} // namespace
+
+// ============================================================================
+// PARSER GBNF
+// ============================================================================
+
+class GrammarParser {
+public:
+    explicit GrammarParser(const std::string& text) : src_(text) {}
+
+    std::shared_ptr<const Grammar> parse() {
+        skip_space(true);
+        while (pos_ < src_.size()) {
+            parse_rule();
+            skip_space(true);
+        }
+
+        for (size_t i = 0; i < rules_.size(); ++i) {
+            if (!defined_[i]) fail("undefined rule: " + names_[i], 0);
+        }
+
+        auto root = symbols_.find("root");
+        if (root == symbols_.end()) fail("missing rule: root", 0);
+
+        check_left_recursion();
+
+        auto g = std::make_shared<Grammar>();
+        for (const auto& rule : rules_) {
+            g->rule_start_.push_back(static_cast<uint32_t>(g->elements_.size()));
+            g->elements_.insert(g->elements_.end(), rule.begin(), rule.end());
+        }
+        g->root_ = root->second;
+        return g;
+    }
+
+private:
+    using Rule = std::vector<GrammarElement>;
+
+    const std::string& src_;
+    size_t pos_ = 0;
+
+    std::unordered_map<std::string, uint32_t> symbols_;
+    std::vector<std::string> names_;
+    std::vector<Rule> rules_;
+    std::vector<bool> defined_;
+
+    [[noreturn]] void fail(const std::string& msg, size_t at) const {
+        size_t line = 1, col = 1;
+        for (size_t i = 0; i < at && i < src_.size(); ++i) {
+            if (src_[i] == '\n') { ++line; col = 1; } else { ++col; }
+        }
+        throw std::invalid_argument(
+            "[grammar] " + msg + (at ? " at " + std::to_string(line) + ":" + std::to_string(col) : "")
+        );
+    }
+
+    char peek(size_t off = 0) const {
+        return pos_ + off < src_.size() ? src_[pos_ + off] : '\0';
+    }
+
+    static bool is_word_char(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+    }
+
+    // Espaços e comentários; fora de parênteses a quebra de linha encerra a regra
+    void skip_space(bool newline_ok) {
+        while (pos_ < src_.size()) {
+            const char c = src_[pos_];
+            if (c == '#') {
+                while (pos_ < src_.size() && src_[pos_] != '\n') ++pos_;
+            } else if (c == ' ' || c == '\t' || c == '\r' || (newline_ok && c == '\n')) {
+                ++pos_;
+            } else {
+                break;
+            }
+        }
+    }
+
+    uint32_t symbol_id(const std::string& name) {
+        auto [it, inserted] = symbols_.emplace(name, static_cast<uint32_t>(rules_.size()));
+        if (inserted) {
+            names_.push_back(name);
+            rules_.emplace_back();
+            defined_.push_back(false);
+        }
+        return it->second;
+    }
+
+    // Regra gerada para grupos e repetições
+    uint32_t new_rule(const std::string& base) {
+        std::string name;
+        do {
+            name = base + "_" + std::to_string(rules_.size());
+        } while (symbols_.count(name));
+        const uint32_t id = symbol_id(name);
+        defined_[id] = true;
+        return id;
+    }
+
+    std::string parse_name() {
+        const size_t start = pos_;
+        while (pos_ < src_.size() && is_word_char(src_[pos_])) ++pos_;
+        if (pos_ == start) fail("expecting name", pos_);
+        return src_.substr(start, pos_ - start);
+    }
+
+    uint8_t parse_char() {
+        if (pos_ >= src_.size()) fail("unexpected end of input", pos_);
+
+        const char c = src_[pos_++];
+        if (c != '\\') return static_cast<uint8_t>(c);
+
+        if (pos_ >= src_.size()) fail("unexpected end of input", pos_);
+        const char e = src_[pos_++];
+        switch (e) {
+            case 'n': return '\n';
+            case 'r': return '\r';
+            case 't': return '\t';
+            case '0': return '\0';
+            case 'x': {
+                if (pos_ + 2 > src_.size()
+                    || !std::isxdigit(static_cast<unsigned char>(src_[pos_]))
+                    || !std::isxdigit(static_cast<unsigned char>(src_[pos_ + 1]))) {
+                    fail("expecting two hex digits after \\x", pos_);
+                }
+                const int v = std::stoi(src_.substr(pos_, 2), nullptr, 16);
+                pos_ += 2;
+                return static_cast<uint8_t>(v);
+            }
+            case '\\': case '"': case '\'': case '[': case ']': case '-': case '/': case '^':
+                return static_cast<uint8_t>(e);
+            default:
+                fail(std::string("unknown escape \\") + e, pos_ - 2);
+        }
+    }
+
+    void parse_rule() {
+        const size_t at = pos_;
+        const std::string name = parse_name();
+        skip_space(false);
+
+        if (src_.compare(pos_, 3, "::=") != 0) fail("expecting ::=", pos_);
+        pos_ += 3;
+        skip_space(true);
+
+        const uint32_t id = symbol_id(name);
+        if (defined_[id]) fail("rule defined twice: " + name, at);
+        defined_[id] = true;
+
+        Rule rule;
+        parse_alternatives(name, rule, false);
+        rule.push_back({GrammarElementType::END, 0});
+        rules_[id] = std::move(rule);
+
+        if (pos_ < src_.size() && peek() != '\n') fail("unexpected character", pos_);
+    }
+
+    void parse_alternatives(const std::string& name, Rule& out, bool nested) {
+        parse_sequence(name, out, nested);
+        while (peek() == '|') {
+            ++pos_;
+            skip_space(true);
+            out.push_back({GrammarElementType::ALT, 0});
+            parse_sequence(name, out, nested);
+        }
+    }
+
+    void parse_sequence(const std::string& name, Rule& out, bool nested) {
+        size_t last_start = out.size();
+
+        while (pos_ < src_.size()) {
+            const char c = peek();
+
+            if (c == '"') {
+                ++pos_;
+                last_start = out.size();
+                while (peek() != '"') {
+                    if (pos_ >= src_.size()) fail("unterminated literal", pos_);
+                    out.push_back({GrammarElementType::CHAR, parse_char()});
+                }
+                ++pos_;
+            } else if (c == '[') {
+                ++pos_;
+                last_start = out.size();
+                GrammarElementType type = GrammarElementType::CHAR;
+                if (peek() == '^') {
+                    ++pos_;
+                    type = GrammarElementType::CHAR_NOT;
+                }
+                while (peek() != ']') {
+                    if (pos_ >= src_.size()) fail("unterminated character class", pos_);
+                    const uint8_t lo = parse_char();
+                    out.push_back({type, lo});
+                    if (peek() == '-' && peek(1) != ']') {
+                        ++pos_;
+                        const uint8_t hi = parse_char();
+                        if (hi < lo) fail("inverted range in character class", pos_);
+                        out.push_back({GrammarElementType::CHAR_RNG_UPPER, hi});
+                    }
+                    type = GrammarElementType::CHAR_ALT;
+                }
+                if (out.size() == last_start) fail("empty character class", pos_);
+                ++pos_;
+            } else if (c == '.') {
+                ++pos_;
+                last_start = out.size();
+                out.push_back({GrammarElementType::CHAR_ANY, 0});
+            } else if (is_word_char(c)) {
+                const size_t at = pos_;
+                const std::string ref = parse_name();
+
+                // Início da próxima regra (quebra de linha já consumida em grupo)
+                size_t look = pos_;
+                while (look < src_.size() && (src_[look] == ' ' || src_[look] == '\t')) ++look;
+                if (src_.compare(look, 3, "::=") == 0) {
+                    pos_ = at;
+                    return;
+                }
+
+                last_start = out.size();
+                out.push_back({GrammarElementType::RULE_REF, symbol_id(ref)});
+            } else if (c == '(') {
+                ++pos_;
+                skip_space(true);
+                const uint32_t sub = new_rule(name);
+                Rule group;
+                parse_alternatives(name, group, true);
+                group.push_back({GrammarElementType::END, 0});
+                rules_[sub] = std::move(group);
+                if (peek() != ')') fail("expecting )", pos_);
+                ++pos_;
+                last_start = out.size();
+                out.push_back({GrammarElementType::RULE_REF, sub});
+            } else if (c == '*' || c == '+' || c == '?') {
+                if (last_start == out.size()) fail("expecting item before repetition", pos_);
+                ++pos_;
+
+                // X* → S ::= X S |   ;   X+ → X S   ;   X? → S ::= X |
+                const uint32_t sub = new_rule(name);
+                Rule rep(out.begin() + static_cast<long>(last_start), out.end());
+                if (c != '?') rep.push_back({GrammarElementType::RULE_REF, sub});
+                rep.push_back({GrammarElementType::ALT, 0});
+                rep.push_back({GrammarElementType::END, 0});
+                rules_[sub] = std::move(rep);
+
+                if (c != '+') out.resize(last_start);
+                last_start = out.size();
+                out.push_back({GrammarElementType::RULE_REF, sub});
+            } else {
+                break;
+            }
+
+            skip_space(nested);
+        }
+    }
+
+    // Regra que pode derivar a sentença vazia (ponto fixo)
+    std::vector<bool> nullable_rules() const {
+        std::vector<bool> nullable(rules_.size(), false);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t r = 0; r < rules_.size(); ++r) {
+                if (nullable[r]) continue;
+                bool alt_ok = true;
+                bool any_alt = false;
+                for (const auto& e : rules_[r]) {
+                    if (e.type == GrammarElementType::ALT || e.type == GrammarElementType::END) {
+                        if (alt_ok) {
+                            any_alt = true;
+                            break;
+                        }
+                        alt_ok = true;
+                        continue;
+                    }
+                    if (e.type != GrammarElementType::RULE_REF || !nullable[e.value]) alt_ok = false;
+                }
+                if (any_alt) {
+                    nullable[r] = true;
+                    changed = true;
+                }
+            }
+        }
+        return nullable;
+    }
+
+    // A expansão das pilhas não termina com recursão à esquerda
+    void check_left_recursion() const {
+        const std::vector<bool> nullable = nullable_rules();
+
+        // Arestas r → x quando x pode aparecer na primeira posição de r
+        std::vector<std::vector<uint32_t>> first(rules_.size());
+        for (size_t r = 0; r < rules_.size(); ++r) {
+            bool at_start = true;
+            for (const auto& e : rules_[r]) {
+                if (e.type == GrammarElementType::ALT || e.type == GrammarElementType::END) {
+                    at_start = true;
+                    continue;
+                }
+                if (!at_start) continue;
+                if (e.type == GrammarElementType::RULE_REF) {
+                    first[r].push_back(e.value);
+                    at_start = nullable[e.value];
+                } else if (e.type != GrammarElementType::CHAR_RNG_UPPER
+                           && e.type != GrammarElementType::CHAR_ALT) {
+                    at_start = false;
+                }
+            }
+        }
+
+        std::vector<int> color(rules_.size(), 0);  // 0 novo, 1 na pilha, 2 feito
+        auto visit = [&](auto&& self, uint32_t r) -> void {
+            color[r] = 1;
+            for (uint32_t x : first[r]) {
+                if (color[x] == 1) fail("left recursion in rule: " + names_[x], 0);
+                if (color[x] == 0) self(self, x);
+            }
+            color[r] = 2;
+        };
+        for (uint32_t r = 0; r < rules_.size(); ++r) {
+            if (color[r] == 0) visit(visit, r);
+        }
+    }
+};
+
+std::shared_ptr<const Grammar> Grammar::parse(const std::string& text) {
+    return GrammarParser(text).parse();
+}
+
+std::shared_ptr<const Grammar> Grammar::json() {
+    static const std::shared_ptr<const Grammar> g = parse(R"GBNF(
+root   ::= object
+value  ::= object | array | string | number | ("true" | "false" | "null") ws
+
+object ::= "{" ws ( string ":" ws value ( "," ws string ":" ws value )* )? "}" ws
+array  ::= "[" ws ( value ( "," ws value )* )? "]" ws
+
+string ::= "\"" ( [^"\\\x7F\x00-\x1F] | "\\" ( ["\\/bfnrt] | "u" hex hex hex hex ) )* "\"" ws
+hex    ::= [0-9a-fA-F]
+
+number ::= "-"? ( "0" | [1-9] [0-9]* ) ( "." [0-9]+ )? ( [eE] [-+]? [0-9]+ )? ws
+
+ws     ::= [ \t\n]*
+)GBNF");
+    return g;
+}
+
+// ============================================================================
+// TRIE DO VOCABULÁRIO
+// ============================================================================
+
+VocabTrie::VocabTrie(const SimpleTokenizer& tokenizer, uint32_t n_vocab) {
+    pieces_.resize(n_vocab);
+    nodes_.emplace_back();
+
+    for (uint32_t id = 0; id < n_vocab; ++id) {
+        pieces_[id] = tokenizer.token_piece(static_cast<int32_t>(id));
+        if (pieces_[id].empty()) continue;  // especiais: nunca pela gramática
+
+        uint32_t node = 0;
+        for (unsigned char c : pieces_[id]) {
+            auto& children = nodes_[node].children;
+            auto it = std::lower_bound(
+                children.begin(), children.end(), c,
+                [](const auto& edge, uint8_t b) { return edge.first < b; }
+            );
+            if (it != children.end() && it->first == c) {
+                node = it->second;
+            } else {
+                const uint32_t child = static_cast<uint32_t>(nodes_.size());
+                children.insert(it, {c, child});
+                nodes_.emplace_back();  // invalida `children`
+                node = child;
+            }
+        }
+        nodes_[node].tokens.push_back(static_cast<int32_t>(id));
+    }
+}
+
+// ============================================================================
+// MATCHER
+// ============================================================================
+
+GrammarMatcher::GrammarMatcher(std::shared_ptr<const Grammar> grammar,
+                               std::shared_ptr<const VocabTrie> trie,
+                               int32_t eos_token)
+    : grammar_(std::move(grammar)), trie_(std::move(trie)), eos_(eos_token) {
+    reset();
+}
+
+void GrammarMatcher::reset() {
+    stacks_.clear();
+
+    // Uma pilha por alternativa de root, expandida até terminais
+    const auto& el = grammar_->elements();
+    uint32_t p = grammar_->rule_start(grammar_->root());
+    while (true) {
+        Stack stack;
+        if (!end_of_sequence(p)) stack.push_back(p);
+        expand(stack, stacks_);
+
+        while (!end_of_sequence(p)) ++p;
+        if (el[p].type != GrammarElementType::ALT) break;
+        ++p;
+    }
+
+    std::sort(stacks_.begin(), stacks_.end());
+    stacks_.erase(std::unique(stacks_.begin(), stacks_.end()), stacks_.end());
+}
+
+bool GrammarMatcher::end_of_sequence(uint32_t pos) const {
+    const auto t = grammar_->elements()[pos].type;
+    return t == GrammarElementType::END || t == GrammarElementType::ALT;
+}
+
+// Resolve referências a regras no topo até cada pilha ter um terminal no
+// topo (ou ficar vazia: gramática pode terminar aqui)
+void GrammarMatcher::expand(const Stack& stack, Stacks& out) const {
+    if (stack.empty()) {
+        out.push_back(stack);
+        return;
+    }
+
+    const auto& el = grammar_->elements();
+    const uint32_t pos = stack.back();
+
+    if (el[pos].type != GrammarElementType::RULE_REF) {
+        out.push_back(stack);
+        return;
+    }
+
+    uint32_t p = grammar_->rule_start(el[pos].value);
+    while (true) {
+        Stack next(stack.begin(), stack.end() - 1);
+        if (!end_of_sequence(pos + 1)) next.push_back(pos + 1);
+        if (!end_of_sequence(p)) next.push_back(p);
+        expand(next, out);
+
+        while (!end_of_sequence(p)) ++p;
+        if (el[p].type != GrammarElementType::ALT) break;
+        ++p;
+    }
+}
+
+bool GrammarMatcher::match_char(uint32_t pos, uint8_t c, uint32_t& next) const {
+    const auto& el = grammar_->elements();
+
+    if (el[pos].type == GrammarElementType::CHAR_ANY) {
+        next = pos + 1;
+        return true;
+    }
+
+    const bool positive = el[pos].type == GrammarElementType::CHAR;
+    bool found = false;
+    uint32_t p = pos;
+    do {
+        if (el[p + 1].type == GrammarElementType::CHAR_RNG_UPPER) {
+            found = found || (el[p].value <= c && c <= el[p + 1].value);
+            p += 2;
+        } else {
+            found = found || el[p].value == c;
+            p += 1;
+        }
+    } while (el[p].type == GrammarElementType::CHAR_ALT);
+
+    next = p;
+    return found == positive;
+}
+
+void GrammarMatcher::advance(const Stacks& stacks, uint8_t c, Stacks& out) const {
+    out.clear();
+
+    for (const Stack& stack : stacks) {
+        if (stack.empty()) continue;
+
+        uint32_t next;
+        if (!match_char(stack.back(), c, next)) continue;
+
+        Stack rest(stack.begin(), stack.end() - 1);
+        if (!end_of_sequence(next)) rest.push_back(next);
+        expand(rest, out);
+    }
+
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+bool GrammarMatcher::complete() const {
+    return std::any_of(stacks_.begin(), stacks_.end(), [](const Stack& s) { return s.empty(); });
+}
+
+std::string GrammarMatcher::state_key(const Stacks& stacks) {
+    std::string key;
+    for (const Stack& s : stacks) {
+        key.append(reinterpret_cast<const char*>(s.data()), s.size() * sizeof(uint32_t));
+        key.append(sizeof(uint32_t), '\xff');  // separador (posição inválida)
+    }
+    return key;
+}
+
+// DFS na trie: o prefixo comum é avançado uma vez; subárvore sem pilhas
+// vivas é podada
+void GrammarMatcher::build_mask(const Stacks& stacks, uint32_t node, Mask& mask) const {
+    const auto& n = trie_->nodes()[node];
+
+    for (int32_t token : n.tokens) {
+        mask.bits[token >> 5] |= 1u << (token & 31);
+        ++mask.allowed;
+    }
+
+    Stacks next;
+    for (const auto& [c, child] : n.children) {
+        advance(stacks, c, next);
+        if (!next.empty()) build_mask(next, child, mask);
+    }
+}
+
+const GrammarMatcher::Mask& GrammarMatcher::mask_for_state() {
+    std::string key = state_key(stacks_);
+
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        ++cache_hits_;
+        grammar_metrics().mask_hits.inc();
+        return it->second;
+    }
+
+    ++cache_misses_;
+    grammar_metrics().mask_misses.inc();
+    if (cache_.size() >= MAX_CACHED_MASKS) cache_.clear();
+
+    Mask mask;
+    mask.bits.assign((trie_->n_vocab() + 31) / 32, 0u);
+    build_mask(stacks_, 0, mask);
+
+    if (complete() && eos_ >= 0 && static_cast<uint32_t>(eos_) < trie_->n_vocab()) {
+        mask.bits[eos_ >> 5] |= 1u << (eos_ & 31);
+        ++mask.allowed;
+    }
+
+    return cache_.emplace(std::move(key), std::move(mask)).first->second;
+}
+
+int GrammarMatcher::apply(float* logits, int n) {
+    const Mask& mask = mask_for_state();
+
+    const int covered = std::min(n, static_cast<int>(trie_->n_vocab()));
+    ops::simd::mask_f32(logits, mask.bits.data(), covered, -INFINITY);
+    std::fill(logits + covered, logits + n, -INFINITY);
+
+    return mask.allowed;
+}
+
+bool GrammarMatcher::accept(int32_t token) {
+    if (token == eos_) return complete();
+
+    if (token < 0 || static_cast<uint32_t>(token) >= trie_->n_vocab()) {
+        grammar_metrics().rejected.inc();
+        return false;
+    }
+
+    const std::string& piece = trie_->piece(token);
+    if (piece.empty()) {
+        grammar_metrics().rejected.inc();
+        return false;
+    }
+
+    Stacks cur = stacks_;
+    Stacks next;
+    for (unsigned char c : piece) {
+        advance(cur, c, next);
+        if (next.empty()) {
+            grammar_metrics().rejected.inc();
+            return false;
+        }
+        cur.swap(next);
+    }
+
+    stacks_ = std::move(cur);
+    return true;
+}
+
+} // namespace engine
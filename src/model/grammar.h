@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+
+class SimpleTokenizer;
+
+// ============================================================================
+// Gramática (GBNF)
+// ============================================================================
+
+enum class GrammarElementType : uint8_t {
+    END,            // fim da regra
+    ALT,            // separador de alternativas
+    RULE_REF,       // value = id da regra
+    CHAR,           // value = byte; seguido de CHAR_ALT / CHAR_RNG_UPPER
+    CHAR_NOT,       // classe negada [^...]
+    CHAR_RNG_UPPER, // limite superior de um intervalo (o anterior é o inferior)
+    CHAR_ALT,       // mais um byte/intervalo da mesma classe
+    CHAR_ANY        // '.'
+};
+
+struct GrammarElement {
+    GrammarElementType type;
+    uint32_t value;
+};
+
+/**
+ * Gramática GBNF (subconjunto do llama.cpp) compilada para um autômato de
+ * pilha sobre bytes.
+ *
+ *   regra ::= alternativa | alternativa ...
+ *   itens: "literal", [classe], [^classe], ., nome, ( grupo ), e os
+ *   sufixos *, + e ?. Comentários com #. A regra inicial é `root`.
+ *
+ * As classes casam bytes (não codepoints): [^"] aceita qualquer byte de
+ * UTF-8, o que basta para JSON. Recursão à esquerda é rejeitada.
+ */
+class Grammar {
+public:
+    // Lança std::invalid_argument com linha/coluna se o texto for inválido
+    static std::shared_ptr<const Grammar> parse(const std::string& text);
+
+    // JSON genérico (objeto na raiz)
+    static std::shared_ptr<const Grammar> json();
+
+    // Elementos de todas as regras, concatenados; cada regra termina em END
+    const std::vector<GrammarElement>& elements() const { return elements_; }
+    uint32_t rule_start(uint32_t rule) const { return rule_start_[rule]; }
+    uint32_t root() const { return root_; }
+
+private:
+    std::vector<GrammarElement> elements_;
+    std::vector<uint32_t> rule_start_;
+    uint32_t root_ = 0;
+
+    friend class GrammarParser;
+};
+
+// ============================================================================
+// Trie do vocabulário
+// ============================================================================
+
+/**
+ * Trie dos bytes que cada token produz (SimpleTokenizer::token_piece).
+ * Tokens com prefixo comum compartilham o caminho, então a máscara de um
+ * estado da gramática avança o autômato uma vez por nó, não por token.
+ */
+class VocabTrie {
+public:
+    struct Node {
+        std::vector<std::pair<uint8_t, uint32_t>> children;  // (byte, nó), por byte
+        std::vector<int32_t> tokens;                          // terminam aqui
+    };
+
+    VocabTrie(const SimpleTokenizer& tokenizer, uint32_t n_vocab);
+
+    const std::vector<Node>& nodes() const { return nodes_; }
+    const std::string& piece(int32_t token) const { return pieces_[token]; }
+    uint32_t n_vocab() const { return static_cast<uint32_t>(pieces_.size()); }
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<std::string> pieces_;
+};
+
+// ============================================================================
+// Estado da decodificação restrita
+// ============================================================================
+
+/**
+ * Estado da gramática durante a geração (conjunto de pilhas do autômato).
+ *
+ * - apply(): zera (-inf) os logits dos tokens que a gramática não aceita
+ *   no estado corrente. A máscara (1 bit por token) é calculada uma vez por
+ *   estado percorrendo a trie e fica em cache; o resto é um passo SIMD.
+ * - accept(): avança o estado pelos bytes do token sorteado.
+ * - EOS só é permitido quando a gramática pode terminar.
+ */
+class GrammarMatcher {
+public:
+    GrammarMatcher(std::shared_ptr<const Grammar> grammar,
+                   std::shared_ptr<const VocabTrie> trie,
+                   int32_t eos_token);
+
+    // Volta ao estado inicial (mantém o cache de máscaras)
+    void reset();
+
+    // logits[n]: tokens proibidos viram -inf. Retorna quantos são permitidos.
+    int apply(float* logits, int n);
+
+    // false se o token não é aceito (o estado não muda)
+    bool accept(int32_t token);
+
+    // A entrada consumida é uma sentença completa da gramática
+    bool complete() const;
+
+    const Grammar* grammar() const { return grammar_.get(); }
+
+    uint64_t cache_hits() const { return cache_hits_; }
+    uint64_t cache_misses() const { return cache_misses_; }
+
+private:
+    using Stack = std::vector<uint32_t>;  // posições em Grammar::elements()
+    using Stacks = std::vector<Stack>;
+
+    std::shared_ptr<const Grammar> grammar_;
+    std::shared_ptr<const VocabTrie> trie_;
+    int32_t eos_;
+
+    Stacks stacks_;
+
+    struct Mask {
+        std::vector<uint32_t> bits;
+        int allowed = 0;
+    };
+    std::unordered_map<std::string, Mask> cache_;
+    uint64_t cache_hits_ = 0;
+    uint64_t cache_misses_ = 0;
+
+    const Mask& mask_for_state();
+    void build_mask(const Stacks& stacks, uint32_t node, Mask& mask) const;
+
+    void expand(const Stack& stack, Stacks& out) const;
+    void advance(const Stacks& stacks, uint8_t c, Stacks& out) const;
+    bool match_char(uint32_t pos, uint8_t c, uint32_t& next) const;
+    bool end_of_sequence(uint32_t pos) const;
+    static std::string state_key(const Stacks& stacks);
+};
+
+} // namespace engine
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace engine {
+
+/**
+ * Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as
+ * 1, 2, 3"): gerador baseado em contador, sem estado.
+ *
+ * O bloco aleatório é função pura de (chave, contador): cada sequência usa
+ * a própria chave/stream e o contador do passo, então o número sorteado não
+ * depende da ordem de execução, da thread nem de quem mais está no batch.
+ */
+class Philox {
+public:
+    using Block = std::array<uint32_t, 4>;
+
+    static Block generate(uint64_t key, const Block& counter) {
+        uint32_t k0 = static_cast<uint32_t>(key);
+        uint32_t k1 = static_cast<uint32_t>(key >> 32);
+        Block c = counter;
+
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t p0 = uint64_t(M0) * c[0];
+            const uint64_t p1 = uint64_t(M1) * c[2];
+
+            c = {
+                static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0,
+                static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1,
+                static_cast<uint32_t>(p0)
+            };
+
+            k0 += W0;
+            k1 += W1;
+        }
+
+        return c;
+    }
+
+    // Uniforme em [0, 1) com 53 bits, para (seed, stream, passo)
+    static double uniform(uint32_t seed, uint64_t stream, uint64_t step) {
+        const Block r = generate(seed, {
+            static_cast<uint32_t>(step), static_cast<uint32_t>(step >> 32),
+            static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)
+        });
+
+        const uint64_t bits = (uint64_t(r[0]) << 21) ^ (r[1] >> 11);
+        return static_cast<double>(bits & ((uint64_t(1) << 53) - 1)) * 0x1.0p-53;
+    }
+
+private:
+    static constexpr uint32_t M0 = 0xD2511F53u;
+    static constexpr uint32_t M1 = 0xCD9E8D57u;
+    static constexpr uint32_t W0 = 0x9E3779B9u;
+    static constexpr uint32_t W1 = 0xBB67AE85u;
+};
+
+} // namespace engine
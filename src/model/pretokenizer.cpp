@@ -0,0 +1,291 @@
+#include "model/pretokenizer.h"
+#include "model/unicode_data.h"
+
+#include <array>
+#include <cstdint>
+
+namespace engine {
+
+const char* pre_tokenizer_name(PreTokenizerType type) {
+    switch (type) {
+        case PreTokenizerType::GPT2:   return "gpt2";
+        case PreTokenizerType::LLAMA3: return "llama3";
+        case PreTokenizerType::QWEN2:  return "qwen2";
+        case PreTokenizerType::TEKKEN: return "tekken";
+    }
+    return "unknown";
+}
+
+std::optional<PreTokenizerType> pre_tokenizer_from_name(const std::string& s) {
+    if (s == "default" || s == "gpt2" || s == "gpt-2" || s == "phi-2" ||
+        s == "roberta-bpe" || s == "mpt" || s == "olmo" || s == "jais") {
+        return PreTokenizerType::GPT2;
+    }
+    if (s == "llama3" || s == "llama-v3" || s == "llama-bpe" || s == "smaug-bpe" || s == "falcon3") {
+        return PreTokenizerType::LLAMA3;
+    }
+    if (s == "qwen2" || s == "deepseek-r1-qwen" || s == "stablelm2" || s == "megrez") {
+        return PreTokenizerType::QWEN2;
+    }
+    if (s == "tekken") return PreTokenizerType::TEKKEN;
+    return std::nullopt;
+}
+
+namespace {
+
+enum : uint8_t {
+    F_LETTER  = 1,   // \p{L}
+    F_NUMBER  = 2,   // \p{N}
+    F_SPACE   = 4,   // \s
+    F_UPPER   = 8,   // [\p{Lu}\p{Lt}\p{Lm}\p{Lo}\p{M}]
+    F_LOWER   = 16,  // [\p{Ll}\p{Lm}\p{Lo}\p{M}]
+    F_NEWLINE = 32   // [\r\n]
+};
+
+constexpr uint8_t class_flags(UnicodeClass c) {
+    switch (c) {
+        case UnicodeClass::UPPER:  return F_LETTER | F_UPPER;
+        case UnicodeClass::LOWER:  return F_LETTER | F_LOWER;
+        case UnicodeClass::LETTER: return F_LETTER | F_UPPER | F_LOWER;
+        case UnicodeClass::MARK:   return F_UPPER | F_LOWER;
+        case UnicodeClass::NUMBER: return F_NUMBER;
+        case UnicodeClass::OTHER:  return 0;
+    }
+    return 0;
+}
+
+constexpr std::array<uint8_t, 128> make_ascii_flags() {
+    std::array<uint8_t, 128> f{};
+    for (int c = 'A'; c <= 'Z'; ++c) f[c] = F_LETTER | F_UPPER;
+    for (int c = 'a'; c <= 'z'; ++c) f[c] = F_LETTER | F_LOWER;
+    for (int c = '0'; c <= '9'; ++c) f[c] = F_NUMBER;
+    for (int c = 0x09; c <= 0x0D; ++c) f[c] = F_SPACE;
+    f[' '] = F_SPACE;
+    f['\r'] |= F_NEWLINE;
+    f['\n'] |= F_NEWLINE;
+    return f;
+}
+
+constexpr std::array<uint8_t, 128> ASCII_FLAGS = make_ascii_flags();
+
+struct Char {
+    uint32_t len;    // 0 = fim do texto
+    uint8_t flags;
+    uint32_t cp;
+};
+
+// UTF-8 inválido vira um caractere de 1 byte sem classe (como U+FFFD):
+// o byte seguinte é decodificado de novo
+Char decode_utf8(std::string_view t, size_t pos) {
+    const uint8_t b = static_cast<uint8_t>(t[pos]);
+
+    uint32_t len, cp;
+    if ((b >> 5) == 0x6)       { len = 2; cp = b & 0x1F; }
+    else if ((b >> 4) == 0xE)  { len = 3; cp = b & 0x0F; }
+    else if ((b >> 3) == 0x1E) { len = 4; cp = b & 0x07; }
+    else return {1, 0, 0xFFFD};
+
+    if (pos + len > t.size()) return {1, 0, 0xFFFD};
+    for (uint32_t i = 1; i < len; ++i) {
+        const uint8_t c = static_cast<uint8_t>(t[pos + i]);
+        if ((c & 0xC0) != 0x80) return {1, 0, 0xFFFD};
+        cp = (cp << 6) | (c & 0x3F);
+    }
+
+    // Formas longas demais, surrogates e acima de U+10FFFF
+    static constexpr uint32_t MIN_CP[5] = {0, 0, 0x80, 0x800, 0x10000};
+    if (cp < MIN_CP[len] || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) return {1, 0, 0xFFFD};
+
+    const uint8_t space = unicode_is_space(cp) ? F_SPACE : 0;
+    return {len, static_cast<uint8_t>(class_flags(unicode_class(cp)) | space), cp};
+}
+
+inline Char char_at(std::string_view t, size_t pos) {
+    if (pos >= t.size()) return {0, 0, 0};
+    const uint8_t b = static_cast<uint8_t>(t[pos]);
+    if (b < 0x80) return {1, ASCII_FLAGS[b], b};
+    return decode_utf8(t, pos);
+}
+
+// Avança enquanto (flags & mask) != 0 for igual a want; ASCII byte a byte
+inline size_t run_while(std::string_view t, size_t p, uint8_t mask, bool want) {
+    const size_t n = t.size();
+    while (p < n) {
+        const uint8_t b = static_cast<uint8_t>(t[p]);
+        if (b < 0x80) {
+            if (((ASCII_FLAGS[b] & mask) != 0) != want) break;
+            ++p;
+            continue;
+        }
+        const Char c = decode_utf8(t, p);
+        if (((c.flags & mask) != 0) != want) break;
+        p += c.len;
+    }
+    return p;
+}
+
+// Avança enquanto o caractere tem alguma das flags de mask
+inline size_t run(std::string_view t, size_t p, uint8_t mask) {
+    return run_while(t, p, mask, true);
+}
+
+// [^\s\p{L}\p{N}]+
+inline size_t run_other(std::string_view t, size_t p) {
+    return run_while(t, p, F_SPACE | F_LETTER | F_NUMBER, false);
+}
+
+inline bool is_other(const Char& c) {
+    return c.len && !(c.flags & (F_SPACE | F_LETTER | F_NUMBER));
+}
+
+// 's|'t|'re|'ve|'m|'ll|'d depois do apóstrofo em p; bytes casados (0 = não)
+inline size_t contraction(std::string_view t, size_t p, bool ignore_case) {
+    auto at = [&](size_t i) -> char {
+        if (p + i >= t.size()) return 0;
+        const char c = t[p + i];
+        return ignore_case && c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c;
+    };
+
+    const char a = at(0);
+    if (a == 's' || a == 't' || a == 'm' || a == 'd') return 1;
+    const char b = at(1);
+    if ((a == 'r' && b == 'e') || (a == 'v' && b == 'e') || (a == 'l' && b == 'l')) return 2;
+    return 0;
+}
+
+// Espaços em pos: \s*[\r\n]+ (se newlines), \s+(?!\S), \s+
+inline size_t whitespace(std::string_view t, size_t pos, bool newlines) {
+    size_t p = pos;
+    size_t last = pos;          // início do último caractere da sequência
+    size_t after_newline = 0;   // fim do último \r ou \n
+
+    for (Char c = char_at(t, p); c.len && (c.flags & F_SPACE); c = char_at(t, p)) {
+        if (c.flags & F_NEWLINE) after_newline = p + c.len;
+        last = p;
+        p += c.len;
+    }
+
+    if (newlines && after_newline) return after_newline;
+    if (p >= t.size()) return p;   // até o fim: nada de \S depois
+    if (last > pos) return last;   // devolve o último para o próximo pedaço
+    return p;
+}
+
+} // namespace
+
+size_t PreTokenizer::next(std::string_view text, size_t pos) const {
+    switch (type_) {
+        case PreTokenizerType::GPT2:   return next_gpt2(text, pos);
+        case PreTokenizerType::LLAMA3: return next_llama3(text, pos, 3);
+        case PreTokenizerType::QWEN2:  return next_llama3(text, pos, 1);
+        case PreTokenizerType::TEKKEN: return next_tekken(text, pos);
+    }
+    return text.size();
+}
+
+size_t PreTokenizer::next_gpt2(std::string_view t, size_t pos) const {
+    const Char c = char_at(t, pos);
+
+    if (c.cp == '\'') {
+        if (const size_t n = contraction(t, pos + 1, false)) return pos + 1 + n;
+    }
+
+    // " ?" seguido de letras, números ou outros
+    size_t p = pos;
+    Char d = c;
+    if (c.cp == ' ') {
+        const Char e = char_at(t, pos + 1);
+        if (e.len && !(e.flags & F_SPACE)) {
+            p = pos + 1;
+            d = e;
+        }
+    }
+
+    if (d.flags & F_LETTER) return run(t, p, F_LETTER);
+    if (d.flags & F_NUMBER) return run(t, p, F_NUMBER);
+    if (!(d.flags & F_SPACE)) return run_other(t, p);
+
+    return whitespace(t, pos, false);
+}
+
+size_t PreTokenizer::next_llama3(std::string_view t, size_t pos, size_t max_digits) const {
+    const Char c = char_at(t, pos);
+
+    if (c.cp == '\'') {
+        if (const size_t n = contraction(t, pos + 1, true)) return pos + 1 + n;
+    }
+
+    // [^\r\n\p{L}\p{N}]?\p{L}+
+    if (c.flags & F_LETTER) return run(t, pos, F_LETTER);
+    if (!(c.flags & (F_NEWLINE | F_NUMBER))) {
+        if (char_at(t, pos + c.len).flags & F_LETTER) return run(t, pos + c.len, F_LETTER);
+    }
+
+    // \p{N}{1,max_digits}
+    if (c.flags & F_NUMBER) {
+        size_t p = pos;
+        for (size_t k = 0; k < max_digits; ++k) {
+            const Char d = char_at(t, p);
+            if (!(d.flags & F_NUMBER)) break;
+            p += d.len;
+        }
+        return p;
+    }
+
+    //  ?[^\s\p{L}\p{N}]+[\r\n]*
+    if (is_other(c)) return run(t, run_other(t, pos), F_NEWLINE);
+    if (c.cp == ' ' && is_other(char_at(t, pos + 1))) return run(t, run_other(t, pos + 1), F_NEWLINE);
+
+    return whitespace(t, pos, true);
+}
+
+size_t PreTokenizer::next_tekken(std::string_view t, size_t pos) const {
+    const Char c = char_at(t, pos);
+
+    // [\p{Lu}\p{Lt}\p{Lm}\p{Lo}\p{M}]*[\p{Ll}\p{Lm}\p{Lo}\p{M}]+ com o
+    // backtracking do *: se o que segue a sequência de "maiúsculas" não é
+    // minúscula, o + termina no último caractere dela que também é (Lm/Lo/M)
+    auto upper_lower = [&](size_t p) -> size_t {
+        size_t k = p;
+        size_t last_lower = 0;
+        for (Char d = char_at(t, k); d.len && (d.flags & F_UPPER); d = char_at(t, k)) {
+            k += d.len;
+            if (d.flags & F_LOWER) last_lower = k;
+        }
+        if (char_at(t, k).flags & F_LOWER) return run(t, k, F_LOWER);
+        return last_lower;
+    };
+
+    // [\p{Lu}\p{Lt}\p{Lm}\p{Lo}\p{M}]+[\p{Ll}\p{Lm}\p{Lo}\p{M}]*
+    auto upper_then_lower = [&](size_t p) -> size_t {
+        const size_t k = run(t, p, F_UPPER);
+        return k == p ? 0 : run(t, k, F_LOWER);
+    };
+
+    // Prefixo opcional [^\r\n\p{L}\p{N}] (guloso: tenta com ele primeiro)
+    const bool prefix = c.len && !(c.flags & (F_NEWLINE | F_LETTER | F_NUMBER));
+
+    if (prefix) {
+        if (const size_t e = upper_lower(pos + c.len)) return e;
+    }
+    if (const size_t e = upper_lower(pos)) return e;
+    if (prefix) {
+        if (const size_t e = upper_then_lower(pos + c.len)) return e;
+    }
+    if (const size_t e = upper_then_lower(pos)) return e;
+
+    // \p{N}
+    if (c.flags & F_NUMBER) return pos + c.len;
+
+    //  ?[^\s\p{L}\p{N}]+[\r\n/]*
+    auto tail = [&](size_t p) {
+        while (p < t.size() && (t[p] == '\r' || t[p] == '\n' || t[p] == '/')) ++p;
+        return p;
+    };
+    if (is_other(c)) return tail(run_other(t, pos));
+    if (c.cp == ' ' && is_other(char_at(t, pos + 1))) return tail(run_other(t, pos + 1));
+
+    return whitespace(t, pos, true);
+}
+
+} // namespace engine
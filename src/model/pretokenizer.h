@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace engine {
+
+/**
+ * Regras de pré-tokenização dos vocabulários byte-level: o texto é cortado
+ * em pedaços e os merges do BPE nunca atravessam um corte.
+ *
+ *   GPT2:   's|'t|'re|'ve|'m|'ll|'d| ?\p{L}+| ?\p{N}+| ?[^\s\p{L}\p{N}]+
+ *           |\s+(?!\S)|\s+
+ *   LLAMA3: (?i:'s|'t|'re|'ve|'m|'ll|'d)|[^\r\n\p{L}\p{N}]?\p{L}+|\p{N}{1,3}
+ *           | ?[^\s\p{L}\p{N}]+[\r\n]*|\s*[\r\n]+|\s+(?!\S)|\s+
+ *   QWEN2:  LLAMA3 com \p{N} (um dígito por pedaço)
+ *   TEKKEN: (Mistral Nemo) letras agrupadas por caixa
+ *           [^\r\n\p{L}\p{N}]?[\p{Lu}\p{Lt}\p{Lm}\p{Lo}\p{M}]*[\p{Ll}\p{Lm}\p{Lo}\p{M}]+
+ *           |[^\r\n\p{L}\p{N}]?[\p{Lu}\p{Lt}\p{Lm}\p{Lo}\p{M}]+[\p{Ll}\p{Lm}\p{Lo}\p{M}]*
+ *           |\p{N}| ?[^\s\p{L}\p{N}]+[\r\n/]*|\s*[\r\n]+|\s+(?!\S)|\s+
+ */
+enum class PreTokenizerType {
+    GPT2,
+    LLAMA3,
+    QWEN2,
+    TEKKEN
+};
+
+const char* pre_tokenizer_name(PreTokenizerType type);
+
+// Nomes de tokenizer.ggml.pre (os do llama.cpp)
+std::optional<PreTokenizerType> pre_tokenizer_from_name(const std::string& s);
+
+/**
+ * Scanner UTF-8 escrito à mão para as regras acima (sem std::regex): cada
+ * alternativa vira um laço sobre classes de caractere, com o backtracking
+ * das expressões reproduzido explicitamente. ASCII usa uma tabela de 128
+ * entradas; o resto, busca binária numa tabela de intervalos do Unicode.
+ * \s é a propriedade White_Space.
+ */
+class PreTokenizer {
+public:
+    explicit PreTokenizer(PreTokenizerType type) : type_(type) {}
+
+    PreTokenizerType type() const { return type_; }
+
+    // Fim (exclusivo) do pedaço que começa em pos (pos < text.size())
+    size_t next(std::string_view text, size_t pos) const;
+
+private:
+    PreTokenizerType type_;
+
+    size_t next_gpt2(std::string_view text, size_t pos) const;
+    size_t next_llama3(std::string_view text, size_t pos, size_t max_digits) const;
+    size_t next_tekken(std::string_view text, size_t pos) const;
+};
+
+} // namespace engine
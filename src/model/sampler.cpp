@@ -1,53 +1,228 @@
 #include "model/sampler.h"
+#include "model/philox.h"
+
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <sstream>
 
 namespace engine {
 
+namespace {
+
+// Ordem total dos candidatos: valor decrescente, empate pelo menor índice
+bool before(const ops::simd::ScoredToken& a, const ops::simd::ScoredToken& b) {
+    return a.val > b.val || (a.val == b.val && a.idx < b.idx);
+}
+
+} // namespace
+
+const char* sampler_stage_name(SamplerStage stage) {
+    switch (stage) {
+        case SamplerStage::PENALTIES:   return "penalties";
+        case SamplerStage::LOGIT_BIAS:  return "logit_bias";
+        case SamplerStage::TOP_K:       return "top_k";
+        case SamplerStage::MIN_P:       return "min_p";
+        case SamplerStage::TOP_P:       return "top_p";
+        case SamplerStage::TEMPERATURE: return "temperature";
+    }
+    return "unknown";
+}
+
+std::optional<SamplerStage> sampler_stage_from_name(const std::string& s) {
+    if (s == "penalties")   return SamplerStage::PENALTIES;
+    if (s == "logit_bias")  return SamplerStage::LOGIT_BIAS;
+    if (s == "top_k")       return SamplerStage::TOP_K;
+    if (s == "min_p")       return SamplerStage::MIN_P;
+    if (s == "top_p")       return SamplerStage::TOP_P;
+    if (s == "temperature") return SamplerStage::TEMPERATURE;
+    return std::nullopt;
+}
+
+std::optional<std::vector<SamplerStage>> parse_sampler_chain(const std::string& list) {
+    std::vector<SamplerStage> chain;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        const auto stage = sampler_stage_from_name(item);
+        if (!stage) return std::nullopt;
+        chain.push_back(*stage);
+    }
+    return chain;
+}
+
 Sampler::Sampler(const SamplingConfig& config)
-    : config_(config), rng_(config.seed) {}
+    : config_(config), rng_(config.seed) {
+    // Bias ordenado por token (duplicatas somadas) para busca binária
+    bias_ = config_.logit_bias;
+    std::sort(bias_.begin(), bias_.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    size_t out = 0;
+    for (size_t i = 0; i < bias_.size(); ++i) {
+        if (out > 0 && bias_[out - 1].first == bias_[i].first) {
+            bias_[out - 1].second += bias_[i].second;
+        } else {
+            bias_[out++] = bias_[i];
+        }
+    }
+    bias_.resize(out);
+}
+
+Sampler::Sampler(const SamplingConfig& config, uint64_t stream)
+    : Sampler(config) {
+    counter_rng_ = true;
+    stream_ = stream;
+}
 
 int32_t Sampler::sample(const float* logits, int vocab_size) {
+    int32_t token;
+
     switch (config_.strategy) {
-        case SamplingStrategy::GREEDY:
-            return sample_greedy(logits, vocab_size);
-        
         case SamplingStrategy::TEMPERATURE:
-            return sample_temperature(logits, vocab_size);
-        
+            token = sample_temperature(logits, vocab_size);
+            break;
+
         case SamplingStrategy::TOP_K:
-            return sample_top_k(logits, vocab_size);
-        
+            token = sample_top_k(logits, vocab_size);
+            break;
+
         case SamplingStrategy::TOP_P:
-            return sample_top_p(logits, vocab_size);
-        
+            token = sample_top_p(logits, vocab_size);
+            break;
+
+        case SamplingStrategy::CHAIN:
+            token = sample_chain(logits, vocab_size);
+            break;
+
+        case SamplingStrategy::GREEDY:
         default:
-            return sample_greedy(logits, vocab_size);
+            token = sample_greedy(logits, vocab_size);
+            break;
     }
+
+    ++step_;
+    return token;
 }
 
 int32_t Sampler::sample(const std::vector<float>& logits) {
     return sample(logits.data(), static_cast<int>(logits.size()));
 }
 
+int Sampler::top_logits_needed() const {
+    switch (config_.strategy) {
+        case SamplingStrategy::GREEDY:
+            return 1;
+
+        case SamplingStrategy::TOP_K:
+            return std::max(1, config_.top_k);
+
+        case SamplingStrategy::CHAIN:
+            // Só se todo estágio antes do top-k for neutro
+            for (SamplerStage stage : config_.chain) {
+                switch (stage) {
+                    case SamplerStage::PENALTIES: {
+                        const bool neutral = config_.repeat_penalty == 1.0f
+                                          && config_.frequency_penalty == 0.0f
+                                          && config_.presence_penalty == 0.0f;
+                        if (!neutral && !history_.empty()) return 0;
+                        break;
+                    }
+                    case SamplerStage::LOGIT_BIAS:
+                        if (!bias_.empty()) return 0;
+                        break;
+                    case SamplerStage::TOP_K:
+                        if (config_.top_k > 0) return config_.top_k;
+                        break;
+                    case SamplerStage::MIN_P:
+                        if (config_.min_p > 0.0f) return 0;
+                        break;
+                    case SamplerStage::TOP_P:
+                        if (config_.top_p < 1.0f) return 0;
+                        break;
+                    case SamplerStage::TEMPERATURE:
+                        if (config_.temperature <= 0.0f) return 1;
+                        if (config_.temperature != 1.0f) return 0;
+                        break;
+                }
+            }
+            return 0;
+
+        default:
+            return 0;
+    }
+}
+
+int32_t Sampler::sample_top(const float* values, const int32_t* indices, int k, int vocab_size) {
+    candidates_.resize(k);
+    for (int i = 0; i < k; ++i) candidates_[i] = {values[i], indices[i]};
+
+    int32_t token;
+
+    switch (config_.strategy) {
+        case SamplingStrategy::TOP_K:
+            token = draw_candidates(k);
+            break;
+
+        case SamplingStrategy::CHAIN:
+            full_ = nullptr;
+            vocab_ = vocab_size;
+            n_ = k;
+            sorted_ = true;
+            token = run_chain();
+            break;
+
+        default:
+            token = candidates_[0].idx;
+            break;
+    }
+
+    ++step_;
+    return token;
+}
+
+void Sampler::reset_history() {
+    history_.clear();
+}
+
+void Sampler::accept(int32_t token) {
+    if (config_.penalty_last_n <= 0) return;
+
+    history_.push_back(token);
+    while (static_cast<int>(history_.size()) > config_.penalty_last_n) {
+        history_.pop_front();
+    }
+}
+
+// ============================================================================
+// SORTEIO CATEGÓRICO
+// ============================================================================
+
+int Sampler::draw(const float* weights, int n, double total) {
+    const double u = (counter_rng_ ? Philox::uniform(config_.seed, stream_, step_)
+                                   : std::generate_canonical<double, 53>(rng_)) * total;
+
+    double cum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        cum += weights[i];
+        if (u < cum) return i;
+    }
+
+    // Arredondamento: último peso não nulo
+    for (int i = n - 1; i > 0; --i) {
+        if (weights[i] > 0.0f) return i;
+    }
+    return 0;
+}
+
 // ============================================================================
 // GREEDY SAMPLING
 // ============================================================================
 
 int32_t Sampler::sample_greedy(const float* logits, int vocab_size) {
-    // Retorna índice do maior logit
-    int32_t max_idx = 0;
-    float max_val = logits[0];
-    
-    for (int i = 1; i < vocab_size; ++i) {
-        if (logits[i] > max_val) {
-            max_val = logits[i];
-            max_idx = i;
-        }
-    }
-    
-    return max_idx;
+    // Índice do maior logit (AVX2)
+    return ops::simd::argmax_f32(logits, vocab_size);
 }
 
 // ============================================================================
@@ -55,12 +230,19 @@ int32_t Sampler::sample_greedy(const float* logits, int vocab_size) {
 // ============================================================================
 
 int32_t Sampler::sample_temperature(const float* logits, int vocab_size) {
-    std::vector<float> probs(vocab_size);
-    softmax_with_temperature(probs, logits, vocab_size);
-    
-    // Sampling categórico
-    std::discrete_distribution<int32_t> dist(probs.begin(), probs.end());
-    return dist(rng_);
+    probs_.resize(vocab_size);
+
+    const float inv_temp = 1.0f / config_.temperature;
+    const float max_logit = ops::simd::max_f32(logits, vocab_size);
+
+    // Pesos não normalizados: o sorteio usa o total direto
+    double total = 0.0;
+    for (int i = 0; i < vocab_size; ++i) {
+        probs_[i] = std::exp((logits[i] - max_logit) * inv_temp);
+        total += probs_[i];
+    }
+
+    return draw(probs_.data(), vocab_size, total);
 }
 
 // ============================================================================
@@ -68,40 +250,28 @@ int32_t Sampler::sample_temperature(const float* logits, int vocab_size) {
 // ============================================================================
 
 int32_t Sampler::sample_top_k(const float* logits, int vocab_size) {
-    // Cria pares (logit, índice)
-    std::vector<std::pair<float, int32_t>> logit_pairs;
-    logit_pairs.reserve(vocab_size);
-    
-    for (int i = 0; i < vocab_size; ++i) {
-        logit_pairs.emplace_back(logits[i], i);
-    }
-    
-    // Ordena por logit (decrescente)
-    std::partial_sort(
-        logit_pairs.begin(),
-        logit_pairs.begin() + std::min(config_.top_k, vocab_size),
-        logit_pairs.end(),
-        [](const auto& a, const auto& b) { return a.first > b.first; }
-    );
-    
-    // Mantém apenas top-k
-    int k = std::min(config_.top_k, vocab_size);
-    logit_pairs.resize(k);
-    
-    // Softmax nos top-k
-    std::vector<float> top_k_logits(k);
+    const int k = std::clamp(config_.top_k, 1, vocab_size);
+
+    // Pré-filtro SIMD + heap de k: só os candidatos saem do vocabulário
+    candidates_.resize(k);
+    ops::simd::top_k_f32(logits, vocab_size, k, candidates_.data());
+
+    return draw_candidates(k);
+}
+
+int32_t Sampler::draw_candidates(int k) {
+    probs_.resize(k);
+
+    const float inv_temp = 1.0f / config_.temperature;
+    const float max_logit = candidates_[0].val;
+
+    double total = 0.0;
     for (int i = 0; i < k; ++i) {
-        top_k_logits[i] = logit_pairs[i].first;
+        probs_[i] = std::exp((candidates_[i].val - max_logit) * inv_temp);
+        total += probs_[i];
     }
-    
-    std::vector<float> probs(k);
-    softmax_with_temperature(probs, top_k_logits.data(), k);
-    
-    // Sampling
-    std::discrete_distribution<int32_t> dist(probs.begin(), probs.end());
-    int sampled_idx = dist(rng_);
-    
-    return logit_pairs[sampled_idx].second;
+
+    return candidates_[draw(probs_.data(), k, total)].idx;
 }
 
 // ============================================================================
@@ -109,85 +279,383 @@ int32_t Sampler::sample_top_k(const float* logits, int vocab_size) {
 // ============================================================================
 
 int32_t Sampler::sample_top_p(const float* logits, int vocab_size) {
-    // Cria pares (probabilidade, índice)
-    std::vector<float> probs(vocab_size);
-    softmax_with_temperature(probs, logits, vocab_size);
-    
-    std::vector<std::pair<float, int32_t>> prob_pairs;
-    prob_pairs.reserve(vocab_size);
-    
-    for (int i = 0; i < vocab_size; ++i) {
-        prob_pairs.emplace_back(probs[i], i);
-    }
-    
-    // Ordena por probabilidade (decrescente)
-    std::sort(
-        prob_pairs.begin(),
-        prob_pairs.end(),
-        [](const auto& a, const auto& b) { return a.first > b.first; }
-    );
-    
-    // Acumula probabilidades até atingir top_p
+    softmax_with_temperature(logits, vocab_size);
+
+    // Ordem total (before): o prefixo ordenado é único, então a soma
+    // acumulada (em float, na mesma ordem) e o núcleo são idênticos aos de
+    // uma ordenação completa.
+
+    // Pré-filtro: abaixo de (1 - top_p) / V a massa excluída é < 1 - top_p,
+    // logo o núcleo está entre os candidatos (se não fechar, usa todos)
+    const float threshold = config_.top_p < 1.0f
+        ? (1.0f - config_.top_p) / static_cast<float>(vocab_size)
+        : 0.0f;
+
     float cumsum = 0.0f;
     int nucleus_size = 0;
-    
-    for (const auto& [prob, idx] : prob_pairs) {
-        cumsum += prob;
-        nucleus_size++;
-        
-        if (cumsum >= config_.top_p) {
-            break;
+
+    for (float t : {threshold, 0.0f}) {
+        candidates_.clear();
+        for (int i = 0; i < vocab_size; ++i) {
+            if (probs_[i] >= t) candidates_.push_back({probs_[i], i});
         }
+
+        // Ordenação parcial incremental: blocos crescentes até fechar top_p
+        const int n = static_cast<int>(candidates_.size());
+        cumsum = 0.0f;
+        nucleus_size = 0;
+        bool closed = false;
+
+        for (int begin = 0, block = 64; begin < n && !closed; begin += block, block *= 4) {
+            const int end = std::min(n, begin + block);
+            if (end < n) {
+                std::nth_element(candidates_.begin() + begin, candidates_.begin() + end,
+                                 candidates_.end(), before);
+            }
+            std::sort(candidates_.begin() + begin, candidates_.begin() + end, before);
+
+            for (int i = begin; i < end; ++i) {
+                cumsum += candidates_[i].val;
+                nucleus_size++;
+
+                if (cumsum >= config_.top_p) {
+                    closed = true;
+                    break;
+                }
+            }
+        }
+
+        if (closed || n == vocab_size) break;
     }
-    
-    // Renormaliza núcleo
-    prob_pairs.resize(nucleus_size);
-    
-    std::vector<float> nucleus_probs;
-    nucleus_probs.reserve(nucleus_size);
-    
-    for (const auto& [prob, idx] : prob_pairs) {
-        nucleus_probs.push_back(prob);
+
+    // Sorteio no núcleo (renormalização implícita pelo total)
+    double total = 0.0;
+    for (int i = 0; i < nucleus_size; ++i) {
+        probs_[i] = candidates_[i].val;
+        total += probs_[i];
     }
-    
-    // Sampling
-    std::discrete_distribution<int32_t> dist(nucleus_probs.begin(), nucleus_probs.end());
-    int sampled_idx = dist(rng_);
-    
-    return prob_pairs[sampled_idx].second;
+
+    return candidates_[draw(probs_.data(), nucleus_size, total)].idx;
+}
+
+// ============================================================================
+// CADEIA DE ESTÁGIOS
+// ============================================================================
+
+int32_t Sampler::sample_chain(const float* logits, int vocab_size) {
+    full_ = logits;
+    vocab_ = vocab_size;
+    n_ = vocab_size;
+    sorted_ = false;
+
+    return run_chain();
+}
+
+int32_t Sampler::run_chain() {
+    for (SamplerStage stage : config_.chain) {
+        switch (stage) {
+            case SamplerStage::PENALTIES:   stage_penalties();   break;
+            case SamplerStage::LOGIT_BIAS:  stage_logit_bias();  break;
+            case SamplerStage::TOP_K:       stage_top_k();       break;
+            case SamplerStage::MIN_P:       stage_min_p();       break;
+            case SamplerStage::TOP_P:       stage_top_p();       break;
+            case SamplerStage::TEMPERATURE: stage_temperature(); break;
+        }
+    }
+
+    // Sorteio final: softmax (T = 1) dos valores restantes
+    if (full_) {
+        probs_.resize(vocab_);
+
+        const float max_val = ops::simd::max_f32(full_, vocab_);
+
+        double total = 0.0;
+        for (int i = 0; i < vocab_; ++i) {
+            probs_[i] = std::exp(full_[i] - max_val);
+            total += probs_[i];
+        }
+
+        return draw(probs_.data(), vocab_, total);
+    }
+
+    if (n_ == 1) return candidates_[0].idx;
+
+    probs_.resize(n_);
+
+    const float max_val = candidates_max();
+
+    double total = 0.0;
+    for (int i = 0; i < n_; ++i) {
+        probs_[i] = std::exp(candidates_[i].val - max_val);
+        total += probs_[i];
+    }
+
+    return candidates_[draw(probs_.data(), n_, total)].idx;
+}
+
+float* Sampler::writable_full() {
+    if (full_ != logits_.data()) {
+        logits_.assign(full_, full_ + vocab_);
+        full_ = logits_.data();
+    }
+    return logits_.data();
+}
+
+float Sampler::candidates_max() const {
+    if (sorted_) return candidates_[0].val;
+
+    float m = candidates_[0].val;
+    for (int i = 1; i < n_; ++i) m = std::max(m, candidates_[i].val);
+    return m;
+}
+
+void Sampler::stage_penalties() {
+    const bool neutral = config_.repeat_penalty == 1.0f
+                      && config_.frequency_penalty == 0.0f
+                      && config_.presence_penalty == 0.0f;
+    if (neutral || history_.empty()) return;
+
+    // Contagem por token da janela (ordenada por token)
+    seen_.clear();
+    for (int32_t t : history_) seen_.push_back({t, 1});
+    std::sort(seen_.begin(), seen_.end());
+
+    size_t out = 0;
+    for (size_t i = 0; i < seen_.size(); ++i) {
+        if (out > 0 && seen_[out - 1].first == seen_[i].first) {
+            seen_[out - 1].second++;
+        } else {
+            seen_[out++] = seen_[i];
+        }
+    }
+    seen_.resize(out);
+
+    auto penalize = [this](float v, int count) {
+        if (config_.repeat_penalty != 1.0f) {
+            v = v > 0.0f ? v / config_.repeat_penalty : v * config_.repeat_penalty;
+        }
+        return v - count * config_.frequency_penalty - config_.presence_penalty;
+    };
+
+    if (full_) {
+        float* w = writable_full();
+        for (const auto& [token, count] : seen_) {
+            if (token >= 0 && token < vocab_) w[token] = penalize(w[token], count);
+        }
+        return;
+    }
+
+    for (int i = 0; i < n_; ++i) {
+        auto it = std::lower_bound(seen_.begin(), seen_.end(), std::pair<int32_t, int>{candidates_[i].idx, 0});
+        if (it != seen_.end() && it->first == candidates_[i].idx) {
+            candidates_[i].val = penalize(candidates_[i].val, it->second);
+            sorted_ = false;
+        }
+    }
+}
+
+void Sampler::stage_logit_bias() {
+    if (bias_.empty()) return;
+
+    if (full_) {
+        float* w = writable_full();
+        for (const auto& [token, bias] : bias_) {
+            if (token >= 0 && token < vocab_) w[token] += bias;
+        }
+        return;
+    }
+
+    for (int i = 0; i < n_; ++i) {
+        auto it = std::lower_bound(
+            bias_.begin(), bias_.end(), candidates_[i].idx,
+            [](const auto& b, int32_t idx) { return b.first < idx; }
+        );
+        if (it != bias_.end() && it->first == candidates_[i].idx) {
+            candidates_[i].val += it->second;
+            sorted_ = false;
+        }
+    }
+}
+
+void Sampler::stage_top_k() {
+    if (config_.top_k <= 0 || config_.top_k >= n_) return;
+
+    const int k = config_.top_k;
+
+    if (full_) {
+        // Pré-filtro SIMD + heap de k direto sobre o vocabulário
+        candidates_.resize(k);
+        ops::simd::top_k_f32(full_, vocab_, k, candidates_.data());
+        full_ = nullptr;
+    } else if (!sorted_) {
+        std::nth_element(candidates_.begin(), candidates_.begin() + k,
+                         candidates_.begin() + n_, before);
+        std::sort(candidates_.begin(), candidates_.begin() + k, before);
+    }
+
+    n_ = k;
+    sorted_ = true;
+}
+
+void Sampler::stage_min_p() {
+    if (config_.min_p <= 0.0f) return;
+
+    // p_i >= min_p * p_max  <=>  v_i >= v_max + ln(min_p)
+    const float log_min_p = std::log(std::min(config_.min_p, 1.0f));
+
+    if (full_) {
+        const float threshold = ops::simd::max_f32(full_, vocab_) + log_min_p;
+
+        candidates_.clear();
+        for (int i = 0; i < vocab_; ++i) {
+            if (full_[i] >= threshold) candidates_.push_back({full_[i], i});
+        }
+
+        full_ = nullptr;
+        n_ = static_cast<int>(candidates_.size());
+        sorted_ = false;
+        return;
+    }
+
+    // Compactação estável (preserva a ordem, se houver)
+    const float threshold = candidates_max() + log_min_p;
+
+    int out = 0;
+    for (int i = 0; i < n_; ++i) {
+        if (candidates_[i].val >= threshold) candidates_[out++] = candidates_[i];
+    }
+    n_ = out;
+}
+
+int Sampler::nucleus_size(float max_val, double sum) {
+    // Ordenação parcial incremental: blocos crescentes até fechar top_p.
+    // Retorna -1 se a massa dos candidatos não alcança top_p.
+    const double target = config_.top_p * sum;
+    double cumsum = 0.0;
+
+    for (int begin = 0, block = 64; begin < n_; begin += block, block *= 4) {
+        const int end = std::min(n_, begin + block);
+        if (!sorted_) {
+            if (end < n_) {
+                std::nth_element(candidates_.begin() + begin, candidates_.begin() + end,
+                                 candidates_.begin() + n_, before);
+            }
+            std::sort(candidates_.begin() + begin, candidates_.begin() + end, before);
+        }
+
+        for (int i = begin; i < end; ++i) {
+            cumsum += std::exp(candidates_[i].val - max_val);
+            if (cumsum >= target) return i + 1;
+        }
+    }
+
+    return -1;
+}
+
+void Sampler::stage_top_p() {
+    if (config_.top_p >= 1.0f || n_ <= 1) return;
+
+    if (full_) {
+        const float max_val = ops::simd::max_f32(full_, vocab_);
+
+        double sum = 0.0;
+        for (int i = 0; i < vocab_; ++i) sum += std::exp(full_[i] - max_val);
+
+        // Pré-filtro: tokens com p < (1 - top_p) / V somam menos que
+        // 1 - top_p, logo o núcleo está entre os demais (se não fechar, todos)
+        const double min_prob = (1.0 - config_.top_p) / vocab_;
+        const float threshold = max_val + static_cast<float>(std::log(min_prob * sum));
+
+        for (float t : {threshold, -INFINITY}) {
+            candidates_.clear();
+            for (int i = 0; i < vocab_; ++i) {
+                if (full_[i] >= t) candidates_.push_back({full_[i], i});
+            }
+
+            n_ = static_cast<int>(candidates_.size());
+            sorted_ = false;
+
+            const int size = nucleus_size(max_val, sum);
+            if (size > 0) {
+                n_ = size;
+                sorted_ = true;
+                break;
+            }
+            if (n_ == vocab_) break;  // arredondamento: mantém todos
+        }
+
+        full_ = nullptr;
+        return;
+    }
+
+    const float max_val = candidates_max();
+
+    double sum = 0.0;
+    for (int i = 0; i < n_; ++i) sum += std::exp(candidates_[i].val - max_val);
+
+    const int size = nucleus_size(max_val, sum);
+    if (size > 0) {
+        n_ = size;
+        sorted_ = true;
+    }
+}
+
+void Sampler::stage_temperature() {
+    const float t = config_.temperature;
+
+    if (t <= 0.0f) {
+        // Temperatura zero: reduz ao argmax
+        if (full_) {
+            const int idx = ops::simd::argmax_f32(full_, vocab_);
+            candidates_.assign(1, {full_[idx], idx});
+            full_ = nullptr;
+        } else if (!sorted_) {
+            const auto best = std::min_element(candidates_.begin(), candidates_.begin() + n_, before);
+            candidates_[0] = *best;
+        }
+        n_ = 1;
+        sorted_ = true;
+        return;
+    }
+
+    if (t == 1.0f) return;
+
+    // Escala positiva preserva a ordem
+    const float inv_temp = 1.0f / t;
+
+    if (full_) {
+        float* w = writable_full();
+        for (int i = 0; i < vocab_; ++i) w[i] *= inv_temp;
+        return;
+    }
+
+    for (int i = 0; i < n_; ++i) candidates_[i].val *= inv_temp;
 }
 
 // ============================================================================
 // SOFTMAX COM TEMPERATURA
 // ============================================================================
 
-void Sampler::softmax_with_temperature(
-    std::vector<float>& probs,
-    const float* logits,
-    int vocab_size
-) {
-    probs.resize(vocab_size);
+void Sampler::softmax_with_temperature(const float* logits, int vocab_size) {
+    probs_.resize(vocab_size);
     
     // Divide por temperatura
     float inv_temp = 1.0f / config_.temperature;
     
     // Encontra max (estabilidade numérica)
-    float max_logit = logits[0];
-    for (int i = 1; i < vocab_size; ++i) {
-        max_logit = std::max(max_logit, logits[i]);
-    }
+    const float max_logit = ops::simd::max_f32(logits, vocab_size);
     
     // exp((logit - max) / T)
     float sum = 0.0f;
     for (int i = 0; i < vocab_size; ++i) {
-        probs[i] = std::exp((logits[i] - max_logit) * inv_temp);
-        sum += probs[i];
+        probs_[i] = std::exp((logits[i] - max_logit) * inv_temp);
+        sum += probs_[i];
     }
     
     // Normaliza
     float inv_sum = 1.0f / sum;
     for (int i = 0; i < vocab_size; ++i) {
-        probs[i] *= inv_sum;
+        probs_[i] *= inv_sum;
     }
 }
 
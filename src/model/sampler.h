@@ -1,8 +1,14 @@
 #pragma once
 
+#include "backend/cpu/ops_simd.h"
+
 #include <vector>
 #include <cstdint>
+#include <deque>
+#include <optional>
 #include <random>
+#include <string>
+#include <utility>
 
 namespace engine {
 
@@ -11,21 +17,56 @@ namespace engine {
         GREEDY,       // Escolhe token com maior probabilidade
         TEMPERATURE,  // Sampling com temperatura
         TOP_K,        // Sampling top-k
-        TOP_P         // Nucleus sampling (top-p)
+        TOP_P,        // Nucleus sampling (top-p)
+        CHAIN         // Cadeia de estágios (SamplingConfig::chain)
+    };
+
+    // Estágios da cadeia. Cada um opera sobre o conjunto de candidatos
+    // deixado pelo anterior; só o primeiro que reduz o conjunto varre o
+    // vocabulário inteiro. Estágio com parâmetro neutro é pulado.
+    enum class SamplerStage {
+        PENALTIES,    // repetição/frequência/presença, só nos tokens vistos
+        LOGIT_BIAS,   // soma bias por token (-inf bane o token)
+        TOP_K,
+        MIN_P,        // p >= min_p * p_max
+        TOP_P,
+        TEMPERATURE   // escala os logits; <= 0 reduz ao argmax
     };
 
+    const char* sampler_stage_name(SamplerStage stage);
+    std::optional<SamplerStage> sampler_stage_from_name(const std::string& s);
+
+    // "penalties,logit_bias,top_k,..." → estágios (nullopt se nome inválido)
+    std::optional<std::vector<SamplerStage>> parse_sampler_chain(const std::string& list);
+
     struct SamplingConfig {
         SamplingStrategy strategy = SamplingStrategy::GREEDY;
         float temperature = 1.0f;
         int top_k = 40;
         float top_p = 0.95f;
         uint32_t seed = 42;
+
+        // Só em CHAIN
+        std::vector<SamplerStage> chain = {
+            SamplerStage::PENALTIES, SamplerStage::LOGIT_BIAS, SamplerStage::TOP_K,
+            SamplerStage::MIN_P, SamplerStage::TOP_P, SamplerStage::TEMPERATURE
+        };
+        float min_p = 0.0f;
+        float repeat_penalty = 1.0f;     // > 1 penaliza (divide logit positivo)
+        float frequency_penalty = 0.0f;  // subtrai count * valor
+        float presence_penalty = 0.0f;   // subtrai valor se visto
+        int penalty_last_n = 64;         // janela de histórico das penalidades
+        std::vector<std::pair<int32_t, float>> logit_bias;
     };
 
     class Sampler {
     public:
         explicit Sampler(const SamplingConfig& config = {});
 
+        // RNG por contador (Philox): o sorteio do passo t depende só de
+        // (seed, stream, t). Para amostragem em lote reprodutível.
+        Sampler(const SamplingConfig& config, uint64_t stream);
+
         // Escolhe próximo token baseado em logits
         // logits: [vocab_size]
         int32_t sample(const float* logits, int vocab_size);
@@ -33,22 +74,74 @@ namespace engine {
         // Variante com vector
         int32_t sample(const std::vector<float>& logits);
 
+        // Quantos dos maiores logits bastam para o próximo sorteio (greedy,
+        // top-k, cadeia que começa em top-k): o backend pode fundir o lm_head
+        // com a seleção e chamar sample_top(). 0 = precisa dos logits inteiros.
+        int top_logits_needed() const;
+
+        // Mesmo resultado de sample() quando values/indices são os k maiores
+        // logits em ordem (valor desc, empate pelo menor índice)
+        int32_t sample_top(const float* values, const int32_t* indices, int k, int vocab_size);
+
+        // Histórico para as penalidades: limpa e registra tokens aceitos
+        // (prompt e gerados). Guarda só os últimos penalty_last_n.
+        void reset_history();
+        void accept(int32_t token);
+
     private:
         SamplingConfig config_;
         std::mt19937 rng_;
 
+        bool counter_rng_ = false;
+        uint64_t stream_ = 0;
+        uint64_t step_ = 0;  // chamadas de sample() (contador do Philox)
+
+        // Scratch reaproveitado entre tokens (sem alocação no caminho quente)
+        std::vector<float> probs_;
+        std::vector<ops::simd::ScoredToken> candidates_;
+
+        // Estado da cadeia: enquanto full_ != nullptr o conjunto é o
+        // vocabulário inteiro (logits de entrada, ou cópia em logits_ depois
+        // do primeiro estágio que altera valores); senão, candidates_[0..n_)
+        const float* full_ = nullptr;
+        int vocab_ = 0;
+        int n_ = 0;
+        bool sorted_ = false;  // candidates_ em (val desc, idx asc)
+        std::vector<float> logits_;
+
+        std::deque<int32_t> history_;
+        std::vector<std::pair<int32_t, int>> seen_;       // (token, count) por token
+        std::vector<std::pair<int32_t, float>> bias_;     // ordenado por token
+
         // Implementações de sampling
         int32_t sample_greedy(const float* logits, int vocab_size);
         int32_t sample_temperature(const float* logits, int vocab_size);
         int32_t sample_top_k(const float* logits, int vocab_size);
         int32_t sample_top_p(const float* logits, int vocab_size);
+        int32_t sample_chain(const float* logits, int vocab_size);
+        int32_t run_chain();
+
+        // Sorteio com temperatura entre candidates_[0..k), já ordenados
+        int32_t draw_candidates(int k);
+
+        // Estágios da cadeia
+        void stage_penalties();
+        void stage_logit_bias();
+        void stage_top_k();
+        void stage_min_p();
+        void stage_top_p();
+        void stage_temperature();
+
+        float* writable_full();
+        float candidates_max() const;
+        int nucleus_size(float max_val, double sum);
+
+        // Sorteio categórico direto da soma acumulada de pesos não
+        // normalizados (total = soma de weights[0..n))
+        int draw(const float* weights, int n, double total);
 
-        // Converte logits → probabilidades com temperatura
-        void softmax_with_temperature(
-            std::vector<float>& probs,
-            const float* logits,
-            int vocab_size
-        );
+        // Converte logits → probabilidades com temperatura (em probs_)
+        void softmax_with_temperature(const float* logits, int vocab_size);
     };
 
-} // namespace engine
\ No newline at end of file
+} // namespace engine
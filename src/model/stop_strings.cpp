@@ -0,0 +1,102 @@
+#include "model/stop_strings.h"
+
+#include <limits>
+
+namespace engine {
+
+namespace {
+constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+}
+
+StopStringMatcher::StopStringMatcher(const std::vector<std::string>& patterns) {
+    nodes_.emplace_back();
+    nodes_[0].next.fill(NONE);
+
+    // 1. Trie dos padrões
+    for (const std::string& p : patterns) {
+        if (p.empty()) continue;
+        ++patterns_;
+
+        uint32_t s = 0;
+        for (unsigned char c : p) {
+            if (nodes_[s].next[c] == NONE) {
+                Node node;
+                node.next.fill(NONE);
+                node.depth = nodes_[s].depth + 1;
+                nodes_.push_back(node);
+                nodes_[s].next[c] = static_cast<uint32_t>(nodes_.size() - 1);
+            }
+            s = nodes_[s].next[c];
+        }
+        nodes_[s].match_len = nodes_[s].depth;
+    }
+
+    // 2. BFS: links de falha embutidos nas transições (DFA completo).
+    // O estado de falha tem profundidade menor, então já está pronto.
+    std::vector<uint32_t> fail(nodes_.size(), 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(nodes_.size());
+
+    for (int c = 0; c < 256; ++c) {
+        uint32_t& t = nodes_[0].next[c];
+        if (t == NONE) {
+            t = 0;
+        } else {
+            queue.push_back(t);
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t s = queue[head];
+        if (nodes_[s].match_len == 0) {
+            nodes_[s].match_len = nodes_[fail[s]].match_len;
+        }
+
+        for (int c = 0; c < 256; ++c) {
+            uint32_t& t = nodes_[s].next[c];
+            const uint32_t via_fail = nodes_[fail[s]].next[c];
+            if (t == NONE) {
+                t = via_fail;
+            } else {
+                fail[t] = via_fail;
+                queue.push_back(t);
+            }
+        }
+    }
+}
+
+void StopStringMatcher::reset() {
+    state_ = 0;
+    held_.clear();
+}
+
+bool StopStringMatcher::feed(std::string_view text, std::string& out) {
+    if (patterns_ == 0) {
+        out.append(text);
+        return false;
+    }
+
+    // O retido é exatamente o prefixo representado por state_
+    pending_.assign(held_);
+    pending_.append(text);
+
+    uint32_t s = state_;
+    for (size_t i = held_.size(); i < pending_.size(); ++i) {
+        s = nodes_[s].next[static_cast<unsigned char>(pending_[i])];
+
+        if (const uint32_t len = nodes_[s].match_len; len > 0) {
+            out.append(pending_, 0, i + 1 - len);
+            reset();
+            return true;
+        }
+    }
+
+    // Libera tudo que não pode mais iniciar uma ocorrência
+    const size_t keep = nodes_[s].depth;
+    out.append(pending_, 0, pending_.size() - keep);
+    held_.assign(pending_, pending_.size() - keep, keep);
+    state_ = s;
+    return false;
+}
+
+} // namespace engine
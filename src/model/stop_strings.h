@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine {
+
+/**
+ * Stop strings sobre o texto gerado (Aho–Corasick, um byte por passo).
+ *
+ * O texto de cada token entra com feed(). O que não pode mais fazer parte
+ * de uma ocorrência sai na hora; o sufixo que ainda é prefixo de algum
+ * padrão fica retido até ser confirmado ou descartado. Assim o stop string
+ * é achado mesmo quando atravessa tokens e nunca chega ao cliente.
+ *
+ * Os padrões são compilados num DFA completo (256 transições por estado):
+ * cada byte custa uma leitura de tabela, sem seguir links de falha.
+ */
+class StopStringMatcher {
+public:
+    // Padrões vazios são ignorados; sem padrões, feed() só repassa o texto
+    explicit StopStringMatcher(const std::vector<std::string>& patterns = {});
+
+    // Início de um novo texto (descarta o retido)
+    void reset();
+
+    // Acrescenta a `out` o texto liberado. true = um stop string terminou
+    // neste trecho: `out` recebe só o texto anterior à ocorrência (a que
+    // termina primeiro; em empate, a mais longa) e o resto é descartado.
+    bool feed(std::string_view text, std::string& out);
+
+    // Texto retido por ser prefixo parcial (emitir ao terminar sem match)
+    const std::string& held() const { return held_; }
+
+    bool empty() const { return patterns_ == 0; }
+
+private:
+    struct Node {
+        std::array<uint32_t, 256> next{};
+        uint32_t depth = 0;      // bytes do prefixo que o estado representa
+        uint32_t match_len = 0;  // maior padrão que termina aqui (0 = nenhum)
+    };
+
+    std::vector<Node> nodes_;
+    size_t patterns_ = 0;
+
+    uint32_t state_ = 0;
+    std::string held_;
+    std::string pending_;  // scratch de feed()
+};
+
+} // namespace engine
@@ -1,11 +1,18 @@
 #include "model/tokenizer.h"
 #include "model/gguf_loader.h"
+#include "model/pretokenizer.h"
+#include "core/logger.h"
 
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <optional>
+#include <string_view>
 #include <unordered_map>
-#include <iostream>
+#include <cctype>
 #include <cstring>
 
 #ifdef __linux__
@@ -27,6 +34,227 @@ struct BPEToken {
     float score;
 };
 
+/**
+ * Double-array trie sobre os bytes dos tokens (Aoe, 1989).
+ *
+ * O filho de s pelo byte c fica em t = base[s] + c + 1 e só existe se
+ * check[t] == s; value[t] é o token que termina ali (-1 se nenhum). A busca
+ * do maior prefixo é uma leitura de array por byte, sem alocar nem hashear.
+ */
+class DoubleArrayTrie {
+public:
+    void build(std::vector<std::pair<std::string, int32_t>> keys);
+
+    // Maior token que é prefixo de text[pos..]; len = bytes consumidos
+    int32_t longest_match(const std::string& text, size_t pos, size_t& len) const {
+        int32_t best = -1;
+        len = 0;
+
+        const Unit* units = units_.data();
+        const size_t n = units_.size();
+
+        int32_t s = 0;
+        for (size_t i = pos; i < text.size(); ++i) {
+            const size_t t = static_cast<size_t>(units[s].base) + static_cast<uint8_t>(text[i]) + 1;
+            if (t >= n || units[t].check != s) break;
+
+            s = static_cast<int32_t>(t);
+            if (units[s].value >= 0) {
+                best = units[s].value;
+                len = i - pos + 1;
+            }
+        }
+
+        return best;
+    }
+
+    // Token com exatamente os bytes p[0..n) (-1 se não existe)
+    int32_t exact(const char* p, size_t n) const {
+        int32_t s = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const size_t t = static_cast<size_t>(units_[s].base) + static_cast<uint8_t>(p[i]) + 1;
+            if (t >= units_.size() || units_[t].check != s) return -1;
+            s = static_cast<int32_t>(t);
+        }
+        return n > 0 ? units_[s].value : -1;
+    }
+
+    size_t states() const { return units_.size(); }
+
+private:
+    // base/check/value juntos: um acesso à memória por byte
+    struct Unit {
+        int32_t base = 0;
+        int32_t check = -1;
+        int32_t value = -1;
+    };
+
+    std::vector<Unit> units_;
+};
+
+void DoubleArrayTrie::build(std::vector<std::pair<std::string, int32_t>> keys) {
+    // Ordenadas, as chaves de um nó de profundidade d formam um intervalo
+    // contíguo e os filhos são os grupos de mesmo byte keys[i][d]. Em
+    // duplicatas fica o menor id (vem primeiro).
+    std::sort(keys.begin(), keys.end());
+
+    units_.assign(1, Unit{});
+
+    // Células ocupadas (bitmap) e, por palavra de 64, a próxima palavra com
+    // célula livre (union-find): a busca de base pula a região cheia.
+    std::vector<uint64_t> used(1, 1);  // célula 0 = raiz
+    std::vector<uint32_t> open_next(1, 0);
+
+    auto grow = [&](size_t words) {
+        while (used.size() < words) {
+            open_next.push_back(static_cast<uint32_t>(used.size()));
+            used.push_back(0);
+        }
+    };
+    auto open_word = [&](size_t w) {
+        while (w < open_next.size() && open_next[w] != w) {
+            const uint32_t next = open_next[w];
+            if (next < open_next.size()) open_next[w] = open_next[next];
+            w = next;
+        }
+        return w;
+    };
+    auto is_used = [&](size_t t) {
+        return t / 64 < used.size() && ((used[t / 64] >> (t % 64)) & 1);
+    };
+    auto mark = [&](size_t t) {
+        grow(t / 64 + 1);
+        used[t / 64] |= uint64_t(1) << (t % 64);
+        if (used[t / 64] == ~uint64_t(0)) open_next[t / 64] = static_cast<uint32_t>(t / 64 + 1);
+    };
+
+    struct Range {
+        size_t lo, hi, depth;
+        int32_t state;
+    };
+    struct Child {
+        uint8_t c;
+        size_t lo, hi;
+    };
+
+    std::vector<Range> queue{{0, keys.size(), 0, 0}};
+    std::vector<Child> children;
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const Range r = queue[head];
+
+        // 1. Filhos: grupos de keys[lo..hi) pelo byte na profundidade d
+        children.clear();
+        for (size_t i = r.lo; i < r.hi; ++i) {
+            const std::string& k = keys[i].first;
+            if (k.size() <= r.depth) continue;  // termina neste nó
+
+            const uint8_t c = static_cast<uint8_t>(k[r.depth]);
+            if (children.empty() || children.back().c != c) {
+                children.push_back({c, i, i + 1});
+            } else {
+                children.back().hi = i + 1;
+            }
+        }
+        if (children.empty()) continue;
+
+        // 2. Menor base cujas células para todos os filhos estão livres
+        const size_t first = children.front().c + 1u;
+        size_t b = 0;
+
+        for (size_t w = open_word(0); !b; w = open_word(w + 1)) {
+            uint64_t free_bits = w < used.size() ? ~used[w] : ~uint64_t(0);
+            while (free_bits) {
+                const size_t e = w * 64 + static_cast<size_t>(std::countr_zero(free_bits));
+                free_bits &= free_bits - 1;
+                if (e <= first) continue;  // base >= 1
+
+                bool fits = true;
+                for (size_t k = 1; k < children.size(); ++k) {
+                    if (is_used(e - first + children[k].c + 1)) { fits = false; break; }
+                }
+                if (fits) { b = e - first; break; }
+            }
+        }
+
+        const size_t top = b + children.back().c + 2;
+        if (top > units_.size()) units_.resize(top);
+
+        units_[r.state].base = static_cast<int32_t>(b);
+        for (const Child& ch : children) {
+            const size_t t = b + ch.c + 1;
+            mark(t);
+            units_[t].check = r.state;
+            if (keys[ch.lo].first.size() == r.depth + 1) {
+                units_[t].value = keys[ch.lo].second;
+            }
+            queue.push_back({ch.lo, ch.hi, r.depth + 1, static_cast<int32_t>(t)});
+        }
+    }
+}
+
+// Tabela bytes → unicode do GPT-2: bytes imprimíveis ficam como estão, os
+// demais viram U+0100.. (espaço = "Ġ"). Os tokens byte-level são escritos
+// nesse alfabeto.
+struct ByteUnicode {
+    std::array<std::string, 256> encode;
+    std::array<int16_t, 512> decode;  // codepoint → byte (-1 = fora da tabela)
+
+    ByteUnicode() {
+        decode.fill(-1);
+        int extra = 0;
+        for (int b = 0; b < 256; ++b) {
+            const bool printable = (b >= 33 && b <= 126) || (b >= 161 && b <= 172) || (b >= 174 && b <= 255);
+            const int cp = printable ? b : 256 + extra++;
+
+            if (cp < 0x80) {
+                encode[b] = std::string(1, static_cast<char>(cp));
+            } else {
+                encode[b] = {static_cast<char>(0xC0 | (cp >> 6)), static_cast<char>(0x80 | (cp & 0x3F))};
+            }
+            decode[cp] = static_cast<int16_t>(b);
+        }
+    }
+
+    static const ByteUnicode& get() {
+        static const ByteUnicode table;
+        return table;
+    }
+};
+
+// Bytes do caractere UTF-8 que começa em c (byte inválido conta como 1)
+inline size_t utf8_len(uint8_t c) {
+    if (c < 0x80) return 1;
+    if ((c >> 5) == 0x6) return 2;
+    if ((c >> 4) == 0xE) return 3;
+    if ((c >> 3) == 0x1E) return 4;
+    return 1;
+}
+
+// Hash de chaves curtas (o cache de segmentos), inline: palavra de 8 bytes
+// por vez e o resto num único passo de mistura
+inline uint64_t hash_short(std::string_view key) {
+    uint64_t h = key.size() * 0x9E3779B97F4A7C15ull;
+    size_t i = 0;
+    for (; i + 8 <= key.size(); i += 8) {
+        uint64_t w;
+        std::memcpy(&w, key.data() + i, 8);
+        h = (h ^ w) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
+    }
+    uint64_t tail = 0;
+    for (; i < key.size(); ++i) tail = (tail << 8) | static_cast<uint8_t>(key[i]);
+    h = (h ^ tail) * 0x94D049BB133111EBull;
+    return h ^ (h >> 29);
+}
+
+// Algoritmo de tokenização, escolhido por tokenizer.ggml.model
+enum class TokenizerMode {
+    LONGEST_MATCH,   // sem scores nem merges: maior token em cada posição
+    SPM,             // "llama": merges pelo score do token resultante
+    BYTE_LEVEL_BPE   // "gpt2": merges pelo rank, alfabeto byte-level
+};
+
 class BPETokenizer {
 public:
     void add_token(int32_t id, const std::string& text, float score) {
@@ -34,6 +262,11 @@ public:
         token_to_id_[text] = id;
     }
 
+    void set_score(int32_t id, float score) {
+        auto it = id_to_token_.find(id);
+        if (it != id_to_token_.end()) it->second.score = score;
+    }
+
     bool has_token(const std::string& text) const {
         return token_to_id_.find(text) != token_to_id_.end();
     }
@@ -53,54 +286,355 @@ public:
         return id_to_token_.size();
     }
 
-    // Encode usando BPE
-    std::vector<int32_t> encode_bpe(const std::string& text) const {
-        std::vector<int32_t> result;
+    TokenizerMode mode() const { return mode_; }
 
-        // Fallback: tokenização character-level se não tiver merge rules
-        std::string current;
-        for (char c : text) {
-            current += c;
-            int32_t id = get_id(current);
+    // Compila o vocabulário (após o load). Tokens especiais/controle e os de
+    // byte (<0xNN>) ficam fora da trie: o texto do usuário não os produz, e
+    // os de byte viram o fallback por byte. merges: "esq dir", em ordem de
+    // prioridade (só no modo BYTE_LEVEL_BPE).
+    void compile(TokenizerMode mode,
+                 const std::vector<int32_t>& special,
+                 const std::vector<int32_t>& token_types,
+                 const std::vector<std::string>& merges,
+                 int32_t unk) {
+        static std::atomic<uint64_t> next_vocab_id{1};
+        vocab_id_ = next_vocab_id++;
 
-            if (id >= 0) {
-                continue; // Tenta estender o match
-            } else {
-                // Não encontrou match maior, volta um char
-                if (current.size() > 1) {
-                    current.pop_back();
-                    id = get_id(current);
-                    if (id >= 0) {
-                        result.push_back(id);
-                    }
-                    current = std::string(1, c);
-                } else {
-                    // Single char - usa fallback
-                    result.push_back(static_cast<uint8_t>(c) + 3);
-                    current.clear();
-                }
+        mode_ = mode;
+        unk_ = unk;
+        byte_fallback_.fill(-1);
+
+        int32_t max_id = -1;
+        for (const auto& [id, tok] : id_to_token_) max_id = std::max(max_id, id);
+        scores_.assign(static_cast<size_t>(max_id + 1), 0.0f);
+
+        std::vector<std::pair<std::string, int32_t>> keys;
+        keys.reserve(id_to_token_.size());
+
+        for (const auto& [id, tok] : id_to_token_) {
+            scores_[id] = tok.score;
+
+            if (std::find(special.begin(), special.end(), id) != special.end()) continue;
+            if (tok.text.empty()) continue;
+
+            // Tipos do GGUF: 2 UNKNOWN, 3 CONTROL, 5 UNUSED não casam com texto
+            const int32_t type = static_cast<size_t>(id) < token_types.size() ? token_types[id] : 1;
+            if (type == 2 || type == 3 || type == 5) continue;
+
+            if (const int b = byte_token_value(tok.text); b >= 0) {
+                byte_fallback_[b] = id;
+                continue;
+            }
+            keys.emplace_back(tok.text, id);
+        }
+
+        // Pares de bytes vizinhos dentro de algum token (qualquer tipo)
+        inner_pairs_.assign(65536 / 64, 0);
+        for (const auto& [id, tok] : id_to_token_) {
+            for (size_t i = 1; i < tok.text.size(); ++i) {
+                const size_t pair = static_cast<uint8_t>(tok.text[i - 1]) * 256u + static_cast<uint8_t>(tok.text[i]);
+                inner_pairs_[pair / 64] |= uint64_t(1) << (pair % 64);
             }
         }
 
-        // Flush remaining
-        if (!current.empty()) {
-            int32_t id = get_id(current);
+        const size_t n_keys = keys.size();
+        trie_.build(std::move(keys));
+
+        // Merges → (id esq, id dir) → (rank, id resultante)
+        pair_rank_.clear();
+        if (mode_ == TokenizerMode::BYTE_LEVEL_BPE) {
+            pair_rank_.reserve(merges.size());
+            for (size_t rank = 0; rank < merges.size(); ++rank) {
+                const std::string& m = merges[rank];
+                const size_t sp = m.find(' ', 1);
+                if (sp == std::string::npos) continue;
+
+                const int32_t l = get_id(m.substr(0, sp));
+                const int32_t r = get_id(m.substr(sp + 1));
+                const int32_t merged = get_id(m.substr(0, sp) + m.substr(sp + 1));
+                if (l < 0 || r < 0 || merged < 0) continue;
+
+                pair_rank_.emplace(pair_key(l, r), std::make_pair(static_cast<int32_t>(rank), merged));
+            }
+        }
+
+        ENGINE_LOG_DEBUG("tokenizer", "vocab trie: " << n_keys << " tokens, "
+                         << trie_.states() << " states, " << pair_rank_.size() << " merges");
+    }
+
+    // "<0xNN>" → NN; -1 se não for token de byte
+    static int byte_token_value(const std::string& text) {
+        if (text.size() != 6 || text.compare(0, 3, "<0x") != 0 || text[5] != '>') return -1;
+        if (!std::isxdigit(static_cast<unsigned char>(text[3])) ||
+            !std::isxdigit(static_cast<unsigned char>(text[4]))) return -1;
+        return std::stoi(text.substr(3, 2), nullptr, 16);
+    }
+
+    // Maior token que casa em cada posição; sem match, um token de byte
+    std::vector<int32_t> encode_bpe(const std::string& text) const {
+        std::vector<int32_t> result;
+        result.reserve(text.size() / 3 + 1);
+
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t len = 0;
+            const int32_t id = trie_.longest_match(text, pos, len);
+
             if (id >= 0) {
                 result.push_back(id);
+                pos += len;
             } else {
-                // Character fallback
-                for (char c : current) {
-                    result.push_back(static_cast<uint8_t>(c) + 3);
-                }
+                push_bytes(text.data() + pos, 1, result);
+                ++pos;
             }
         }
 
         return result;
     }
 
+    /**
+     * Merges com fila de prioridade (SentencePiece BPE / GPT-2 BPE).
+     *
+     * O texto (já normalizado) começa como uma lista duplamente ligada de
+     * caracteres UTF-8. Cada par vizinho que forma um token entra num heap
+     * com a prioridade do merge (score do token no SPM, -rank no GPT-2;
+     * empate: o mais à esquerda). A cada pop o par é fundido no símbolo da
+     * esquerda e só os dois novos pares vizinhos são avaliados: O(n log n).
+     * Entradas obsoletas (um dos lados já mudou) são descartadas no pop.
+     *
+     * Todo símbolo fundido é um token; então entre dois bytes vizinhos que
+     * não aparecem juntos em nenhum token nenhum merge atravessa, e o texto
+     * é processado em segmentos independentes com o mesmo resultado (heaps
+     * pequenos, que cabem no cache).
+     */
+    void encode_merges(const std::string& text, std::vector<int32_t>& out) const {
+        split_segments(text, [&](size_t begin, size_t end) {
+            const std::string_view key(text.data() + begin, end - begin);
+            cached(key, out, [&] { merge_segment(text, begin, end, out); });
+        });
+    }
+
+    // Byte-level (GPT-2): cada pedaço do pré-tokenizador é mapeado para o
+    // alfabeto byte-level e passa pelos merges; nenhum merge atravessa um
+    // pedaço. O cache é pelos bytes crus do pedaço.
+    void encode_byte_level(const std::string& text, const PreTokenizer& pre, std::vector<int32_t>& out) const {
+        const auto& table = ByteUnicode::get();
+        thread_local std::string mapped;
+
+        for (size_t pos = 0; pos < text.size(); ) {
+            const size_t end = pre.next(text, pos);
+            const std::string_view piece(text.data() + pos, end - pos);
+
+            cached(piece, out, [&] {
+                mapped.clear();
+                for (char c : piece) mapped += table.encode[static_cast<uint8_t>(c)];
+                split_segments(mapped, [&](size_t b, size_t e) { merge_segment(mapped, b, e, out); });
+            });
+            pos = end;
+        }
+    }
+
 private:
+    // Chama fn(início, fim) para cada segmento entre pares de bytes que não
+    // aparecem juntos em nenhum token
+    template <typename Fn>
+    void split_segments(const std::string& text, Fn&& fn) const {
+        size_t begin = 0;
+        for (size_t i = 1; i < text.size(); ++i) {
+            const uint8_t c = static_cast<uint8_t>(text[i]);
+            if ((c & 0xC0) == 0x80) continue;  // meio de caractere UTF-8
+
+            const size_t pair = static_cast<uint8_t>(text[i - 1]) * 256u + c;
+            if (!((inner_pairs_[pair / 64] >> (pair % 64)) & 1)) {
+                fn(begin, i);
+                begin = i;
+            }
+        }
+        if (begin < text.size()) fn(begin, text.size());
+    }
+
+    // Segmentos/pedaços se repetem muito em texto natural (são ~palavras):
+    // cache por thread de texto → ids, ligado ao vocabulário compilado
+    // (vocab_id_). Um vocabulário usa um só modo, então as chaves não se
+    // misturam.
+    static constexpr size_t MAX_CACHED_SEGMENT = 64;
+    static constexpr size_t MAX_CACHED_SEGMENTS = 1 << 16;
+
+    // Endereçamento aberto (sondagem linear). Chave e ids ficam juntos numa
+    // arena de int32 (chave com padding até múltiplo de 4 bytes): um acerto
+    // custa o hash, um slot e uma linha da arena, sem nós alocados.
+    struct SegmentCache {
+        struct Slot {
+            uint64_t hash = 0;   // 0 = vazio
+            uint32_t data = 0;   // início em data
+            uint16_t key_len = 0;
+            uint16_t count = 0;
+        };
+
+        uint64_t vocab_id = 0;
+        size_t size = 0;
+        std::vector<Slot> slots;  // 2 * MAX_CACHED_SEGMENTS (potência de 2)
+        std::vector<int32_t> data;
+    };
+
+    // Ids de key em out: do cache ou de compute(), que os acrescenta a out
+    template <typename Compute>
+    void cached(std::string_view key, std::vector<int32_t>& out, Compute&& compute) const {
+        if (key.size() > MAX_CACHED_SEGMENT) {
+            compute();
+            return;
+        }
+
+        thread_local SegmentCache cache;
+        if (cache.vocab_id != vocab_id_ || cache.size >= MAX_CACHED_SEGMENTS) {
+            cache.vocab_id = vocab_id_;
+            cache.size = 0;
+            cache.slots.assign(2 * MAX_CACHED_SEGMENTS, {});
+            cache.data.clear();
+        }
+
+        const size_t key_words = (key.size() + 3) / 4;
+        const uint64_t hash = hash_short(key) | 1;
+        const size_t mask = cache.slots.size() - 1;
+        size_t i = hash & mask;
+        for (; cache.slots[i].hash != 0; i = (i + 1) & mask) {
+            const auto& slot = cache.slots[i];
+            const int32_t* entry = cache.data.data() + slot.data;
+            if (slot.hash == hash && slot.key_len == key.size() &&
+                std::equal(key.begin(), key.end(), reinterpret_cast<const char*>(entry))) {
+                out.insert(out.end(), entry + key_words, entry + key_words + slot.count);
+                return;
+            }
+        }
+
+        const size_t before = out.size();
+        compute();
+
+        auto& slot = cache.slots[i];
+        slot.hash = hash;
+        slot.data = static_cast<uint32_t>(cache.data.size());
+        slot.key_len = static_cast<uint16_t>(key.size());
+        slot.count = static_cast<uint16_t>(out.size() - before);
+        cache.data.resize(cache.data.size() + key_words, 0);
+        std::memcpy(cache.data.data() + slot.data, key.data(), key.size());
+        cache.data.insert(cache.data.end(), out.begin() + before, out.end());
+        ++cache.size;
+    }
+
+    void merge_segment(const std::string& text, size_t begin, size_t end, std::vector<int32_t>& out) const {
+        struct Symbol {
+            uint32_t start;
+            uint32_t len;
+            int32_t prev;
+            int32_t next;
+            int32_t id;
+        };
+        struct Bigram {
+            float priority;
+            int32_t left;
+            uint32_t len;
+            int32_t id;
+
+            bool operator<(const Bigram& o) const {
+                return priority < o.priority || (priority == o.priority && left > o.left);
+            }
+        };
+
+        // Scratch por thread: sem alocação por segmento
+        thread_local std::vector<Symbol> symbols;
+        thread_local std::vector<Bigram> heap;
+        symbols.clear();
+        heap.clear();
+
+        for (size_t pos = begin; pos < end; ) {
+            const size_t len = std::min(utf8_len(static_cast<uint8_t>(text[pos])), end - pos);
+            const int32_t i = static_cast<int32_t>(symbols.size());
+            symbols.push_back({static_cast<uint32_t>(pos), static_cast<uint32_t>(len), i - 1, i + 1,
+                               trie_.exact(text.data() + pos, len)});
+            pos += len;
+        }
+        if (symbols.empty()) return;
+        symbols.back().next = -1;
+
+        auto try_pair = [&](int32_t l, int32_t r) {
+            if (l < 0 || r < 0) return;
+            const Symbol& a = symbols[l];
+            const Symbol& b = symbols[r];
+
+            if (mode_ == TokenizerMode::SPM) {
+                const int32_t id = trie_.exact(text.data() + a.start, a.len + b.len);
+                if (id < 0) return;
+                heap.push_back({scores_[id], l, a.len + b.len, id});
+            } else {
+                if (a.id < 0 || b.id < 0) return;
+                auto it = pair_rank_.find(pair_key(a.id, b.id));
+                if (it == pair_rank_.end()) return;
+                heap.push_back({-static_cast<float>(it->second.first), l, a.len + b.len, it->second.second});
+            }
+            std::push_heap(heap.begin(), heap.end());
+        };
+
+        for (int32_t i = 1; i < static_cast<int32_t>(symbols.size()); ++i) {
+            try_pair(i - 1, i);
+        }
+
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end());
+            const Bigram top = heap.back();
+            heap.pop_back();
+
+            Symbol& left = symbols[top.left];
+            if (left.len == 0 || left.next < 0) continue;
+            Symbol& right = symbols[left.next];
+            if (left.len + right.len != top.len) continue;  // obsoleto
+
+            left.len += right.len;
+            left.id = top.id;
+            left.next = right.next;
+            if (right.next >= 0) symbols[right.next].prev = top.left;
+            right.len = 0;
+
+            try_pair(left.prev, top.left);
+            try_pair(top.left, left.next);
+        }
+
+        for (int32_t i = 0; i >= 0; i = symbols[i].next) {
+            const Symbol& sym = symbols[i];
+            if (sym.id >= 0) {
+                out.push_back(sym.id);
+            } else {
+                push_bytes(text.data() + sym.start, sym.len, out);
+            }
+        }
+    }
+
     std::unordered_map<int32_t, BPEToken> id_to_token_;
     std::unordered_map<std::string, int32_t> token_to_id_;
+
+    TokenizerMode mode_ = TokenizerMode::LONGEST_MATCH;
+    DoubleArrayTrie trie_;
+    std::vector<float> scores_;
+    std::array<int32_t, 256> byte_fallback_{};
+    int32_t unk_ = -1;
+    std::unordered_map<uint64_t, std::pair<int32_t, int32_t>> pair_rank_;
+    std::vector<uint64_t> inner_pairs_;  // bitset 256x256
+    uint64_t vocab_id_ = 0;              // muda a cada compile()
+
+    static uint64_t pair_key(int32_t l, int32_t r) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(l)) << 32) | static_cast<uint32_t>(r);
+    }
+
+    // Bytes sem token: <0xNN> do vocabulário ou, sem ele, <unk>
+    void push_bytes(const char* p, size_t n, std::vector<int32_t>& out) const {
+        for (size_t i = 0; i < n; ++i) {
+            const int32_t id = byte_fallback_[static_cast<uint8_t>(p[i])];
+            if (id >= 0) {
+                out.push_back(id);
+            } else if (unk_ >= 0) {
+                out.push_back(unk_);
+            }
+        }
+    }
 };
 
 // ============================================================================
@@ -114,8 +648,48 @@ struct TokenizerImpl {
     int32_t pad = 0;
     int32_t unk = 3;
     bool loaded = false;
+
+    // Metadados do GGUF que escolhem o algoritmo (aplicados em compile_vocab)
+    std::string model;                  // tokenizer.ggml.model
+    std::string pre;                    // tokenizer.ggml.pre
+    std::vector<float> scores;
+    std::vector<int32_t> token_types;
+    std::vector<std::string> merges;
+    bool add_space_prefix = true;
+    std::optional<bool> add_bos;
+    std::optional<bool> add_eos;
+
+    PreTokenizer pre_tokenizer{PreTokenizerType::GPT2};
 };
 
+namespace {
+
+// Cabeçalho de um array GGUF; não consome nada se o tipo não for `want`
+bool read_array_header(const uint8_t*& p, const uint8_t* end, uint32_t want, uint64_t& n) {
+    if (p + 12 > end) return false;
+
+    uint32_t elem_type;
+    std::memcpy(&elem_type, p, 4);
+    if (elem_type != want) return false;
+
+    std::memcpy(&n, p + 4, 8);
+    p += 12;
+    return true;
+}
+
+bool read_string(const uint8_t*& p, const uint8_t* end, std::string& out) {
+    if (p + 8 > end) return false;
+    uint64_t len;
+    std::memcpy(&len, p, 8);
+    if (len > static_cast<uint64_t>(end - p - 8)) return false;
+
+    out.assign(reinterpret_cast<const char*>(p + 8), len);
+    p += 8 + len;
+    return true;
+}
+
+} // namespace
+
 SimpleTokenizer::SimpleTokenizer()
     : impl_(std::make_unique<TokenizerImpl>()) {
 }
@@ -123,15 +697,15 @@ SimpleTokenizer::SimpleTokenizer()
 SimpleTokenizer::~SimpleTokenizer() = default;
 
 bool SimpleTokenizer::load_from_gguf(const std::string& model_path) {
-    std::cout << "[tokenizer] loading vocabulary from GGUF...\n";
+    ENGINE_LOG_DEBUG("tokenizer", "loading vocabulary from GGUF...");
 
 #ifndef __linux__
-    std::cerr << "[tokenizer] mmap only on Linux\n";
+    ENGINE_LOG_WARN("tokenizer", "mmap only on Linux");
     return load_fallback();
 #else
     int fd = ::open(model_path.c_str(), O_RDONLY);
     if (fd < 0) {
-        std::cerr << "[tokenizer] cannot open file\n";
+        ENGINE_LOG_ERROR("tokenizer", "cannot open file: " << model_path);
         return load_fallback();
     }
 
@@ -152,12 +726,14 @@ bool SimpleTokenizer::load_from_gguf(const std::string& model_path) {
     ::munmap(base, st.st_size);
 
     if (!success) {
-        std::cerr << "[tokenizer] failed to parse GGUF vocab\n";
+        ENGINE_LOG_ERROR("tokenizer", "failed to parse GGUF vocab");
         return load_fallback();
     }
 
+    compile_vocab();
     impl_->loaded = true;
-    std::cout << "[tokenizer] loaded " << impl_->bpe.vocab_size() << " tokens\n";
+    ENGINE_LOG_INFO("tokenizer", "loaded " << impl_->bpe.vocab_size() << " tokens ("
+                    << (impl_->model.empty() ? "?" : impl_->model) << ")");
     return true;
 #endif
 }
@@ -217,8 +793,51 @@ bool SimpleTokenizer::parse_gguf_vocab(void* base, size_t size) {
         }
         // Process tokenizer.ggml.scores (array of floats)
         else if (key == "tokenizer.ggml.scores" && vtype == 9) {
-            // TODO: parse scores
-            skip_value(p, end, vtype);
+            uint64_t n = 0;
+            if (read_array_header(p, end, 6, n) && n <= static_cast<uint64_t>(end - p) / 4) {
+                impl_->scores.resize(n);
+                std::memcpy(impl_->scores.data(), p, n * 4);
+                p += n * 4;
+            } else {
+                skip_value(p, end, vtype);
+            }
+        }
+        else if (key == "tokenizer.ggml.token_type" && vtype == 9) {
+            uint64_t n = 0;
+            if (read_array_header(p, end, 5, n) && n <= static_cast<uint64_t>(end - p) / 4) {
+                impl_->token_types.resize(n);
+                std::memcpy(impl_->token_types.data(), p, n * 4);
+                p += n * 4;
+            } else {
+                skip_value(p, end, vtype);
+            }
+        }
+        else if (key == "tokenizer.ggml.merges" && vtype == 9) {
+            uint64_t n = 0;
+            if (read_array_header(p, end, 8, n)) {
+                impl_->merges.reserve(std::min<uint64_t>(n, static_cast<uint64_t>(end - p) / 8));
+                std::string merge;
+                for (uint64_t m = 0; m < n && read_string(p, end, merge); ++m) {
+                    impl_->merges.push_back(merge);
+                }
+            } else {
+                skip_value(p, end, vtype);
+            }
+        }
+        else if (key == "tokenizer.ggml.model" && vtype == 8) {
+            read_string(p, end, impl_->model);
+        }
+        else if (key == "tokenizer.ggml.pre" && vtype == 8) {
+            read_string(p, end, impl_->pre);
+        }
+        else if (key == "tokenizer.ggml.add_space_prefix" && vtype == 7) {
+            impl_->add_space_prefix = p < end && *p++ != 0;
+        }
+        else if (key == "tokenizer.ggml.add_bos_token" && vtype == 7) {
+            impl_->add_bos = p < end && *p++ != 0;
+        }
+        else if (key == "tokenizer.ggml.add_eos_token" && vtype == 7) {
+            impl_->add_eos = p < end && *p++ != 0;
         }
         // Special tokens
         else if (key == "tokenizer.ggml.bos_token_id" && vtype == 4) {
@@ -262,7 +881,7 @@ bool SimpleTokenizer::parse_token_array(const uint8_t*& p, const uint8_t* end) {
     std::memcpy(&n_tokens, p, 8);
     p += 8;
 
-    std::cout << "[tokenizer] found " << n_tokens << " tokens in GGUF\n";
+    ENGINE_LOG_DEBUG("tokenizer", "found " << n_tokens << " tokens in GGUF");
 
     // Read each token string
     for (uint64_t i = 0; i < n_tokens && p < end; ++i) {
@@ -323,7 +942,7 @@ void SimpleTokenizer::skip_value(const uint8_t*& p, const uint8_t* end, uint32_t
 }
 
 bool SimpleTokenizer::load_fallback() {
-    std::cout << "[tokenizer] using fallback vocabulary\n";
+    ENGINE_LOG_WARN("tokenizer", "using fallback vocabulary");
 
     // Tokens especiais
     impl_->bpe.add_token(0, "<pad>", 0.0f);
@@ -346,6 +965,7 @@ bool SimpleTokenizer::load_fallback() {
         impl_->bpe.add_token(id++, word, 0.0f);
     }
 
+    compile_vocab();
     impl_->loaded = true;
     return true;
 }
@@ -354,19 +974,89 @@ bool SimpleTokenizer::load_fallback() {
 // ENCODE / DECODE
 // ============================================================================
 
+void SimpleTokenizer::compile_vocab() {
+    TokenizerMode mode = TokenizerMode::LONGEST_MATCH;
+    if (impl_->model == "llama" && !impl_->scores.empty()) {
+        mode = TokenizerMode::SPM;
+    } else if (impl_->model == "gpt2" && !impl_->merges.empty()) {
+        mode = TokenizerMode::BYTE_LEVEL_BPE;
+    } else if (!impl_->model.empty()) {
+        ENGINE_LOG_WARN("tokenizer", "model '" << impl_->model
+                        << "' without scores/merges: using longest-match encoding");
+    }
+
+    for (size_t id = 0; id < impl_->scores.size(); ++id) {
+        impl_->bpe.set_score(static_cast<int32_t>(id), impl_->scores[id]);
+    }
+
+    // Com token_type no GGUF, só os tipos dizem o que é especial: os ids de
+    // bos/eos/pad/unk (que num vocabulário GPT-2 podem ser texto) continuam
+    // casáveis no texto. Sem token_type, esses quatro viram especiais.
+    const auto& types = impl_->token_types;
+    std::vector<int32_t> special;
+    if (types.empty()) {
+        special = {impl_->bos, impl_->eos, impl_->pad, impl_->unk};
+    }
+    const bool unk_valid = impl_->unk >= 0 && (types.empty() ||
+        (static_cast<size_t>(impl_->unk) < types.size() && types[impl_->unk] == 2));
+
+    impl_->bpe.compile(mode, special, types, impl_->merges, unk_valid ? impl_->unk : -1);
+
+    // Regras de pré-tokenização do byte-level; sem tokenizer.ggml.pre, as do GPT-2
+    if (mode == TokenizerMode::BYTE_LEVEL_BPE) {
+        std::optional<PreTokenizerType> type = PreTokenizerType::GPT2;
+        if (!impl_->pre.empty()) type = pre_tokenizer_from_name(impl_->pre);
+        if (!type) {
+            ENGINE_LOG_WARN("tokenizer", "unknown pre-tokenizer '" << impl_->pre << "': using gpt2");
+            type = PreTokenizerType::GPT2;
+        }
+        impl_->pre_tokenizer = PreTokenizer(*type);
+        ENGINE_LOG_DEBUG("tokenizer", "pre-tokenizer: " << pre_tokenizer_name(*type));
+    }
+
+    // Padrões do llama.cpp: BOS só no SentencePiece, EOS nunca
+    if (!impl_->add_bos) impl_->add_bos = mode != TokenizerMode::BYTE_LEVEL_BPE;
+    if (!impl_->add_eos) impl_->add_eos = false;
+
+    impl_->scores = {};
+    impl_->merges = {};
+}
+
 std::vector<int32_t> SimpleTokenizer::encode(const std::string& text) const {
     if (!impl_->loaded) {
         return encode_whitespace(text);
     }
 
     std::vector<int32_t> tokens;
-    tokens.push_back(impl_->bos);
-
-    // Usa BPE
-    auto bpe_tokens = impl_->bpe.encode_bpe(text);
-    tokens.insert(tokens.end(), bpe_tokens.begin(), bpe_tokens.end());
+    tokens.reserve(text.size() / 3 + 2);
+    if (*impl_->add_bos) tokens.push_back(impl_->bos);
+
+    switch (impl_->bpe.mode()) {
+        case TokenizerMode::SPM: {
+            // Espaço vira "▁" e o texto ganha um "▁" inicial
+            static const std::string space_marker = "\xE2\x96\x81";
+            std::string normalized;
+            normalized.reserve(text.size() + text.size() / 4 + 3);
+            if (impl_->add_space_prefix && !text.empty()) normalized += space_marker;
+            for (char c : text) {
+                if (c == ' ') normalized += space_marker;
+                else normalized += c;
+            }
+            impl_->bpe.encode_merges(normalized, tokens);
+            break;
+        }
+        case TokenizerMode::BYTE_LEVEL_BPE: {
+            impl_->bpe.encode_byte_level(text, impl_->pre_tokenizer, tokens);
+            break;
+        }
+        case TokenizerMode::LONGEST_MATCH: {
+            auto bpe_tokens = impl_->bpe.encode_bpe(text);
+            tokens.insert(tokens.end(), bpe_tokens.begin(), bpe_tokens.end());
+            break;
+        }
+    }
 
-    tokens.push_back(impl_->eos);
+    if (*impl_->add_eos) tokens.push_back(impl_->eos);
     return tokens;
 }
 
@@ -378,27 +1068,26 @@ std::string SimpleTokenizer::decode(const std::vector<int32_t>& tokens) const {
         if (token_id == impl_->bos ||
             token_id == impl_->eos ||
             token_id == impl_->pad) {
-            std::cout << "[tokenizer] skipping special token: " << token_id << "\n";
+            ENGINE_LOG_TRACE("tokenizer", "skipping special token: " << token_id);
             continue;
         }
 
         // Verifica bounds
         if (token_id < 0 || static_cast<size_t>(token_id) >= impl_->bpe.vocab_size()) {
-            std::cout << "[tokenizer] WARNING: token_id " << token_id
-                      << " out of range (vocab=" << impl_->bpe.vocab_size() << ")\n";
+            ENGINE_LOG_WARN("tokenizer", "token_id " << token_id
+                            << " out of range (vocab=" << impl_->bpe.vocab_size() << ")");
             result += "<unk>";
             continue;
         }
 
-        const std::string& text = impl_->bpe.get_text(token_id);
+        const std::string piece = token_piece(token_id);
 
-        // DEBUG: Mostrar o que está sendo decodificado
-        std::cout << "[tokenizer] token " << token_id << " -> '" << text << "'\n";
+        ENGINE_LOG_TRACE("tokenizer", "token " << token_id << " -> '" << piece << "'");
 
-        if (!text.empty()) {
-            result += text;
+        if (!piece.empty()) {
+            result += piece;
         } else {
-            std::cout << "[tokenizer] WARNING: empty text for token " << token_id << "\n";
+            ENGINE_LOG_TRACE("tokenizer", "empty text for token " << token_id);
             result += "<unk>";
         }
     }
@@ -406,6 +1095,51 @@ std::string SimpleTokenizer::decode(const std::vector<int32_t>& tokens) const {
     return result;
 }
 
+std::string SimpleTokenizer::token_piece(int32_t id) const {
+    if (id == impl_->bos || id == impl_->eos || id == impl_->pad) return {};
+    if (id < 0 || static_cast<size_t>(id) >= impl_->bpe.vocab_size()) return {};
+
+    const std::string& text = impl_->bpe.get_text(id);
+
+    // Byte fallback do SentencePiece: <0xNN>
+    if (const int b = BPETokenizer::byte_token_value(text); b >= 0) {
+        return std::string(1, static_cast<char>(b));
+    }
+
+    // Byte-level (GPT-2): cada caractere do texto do token é um byte
+    if (impl_->bpe.mode() == TokenizerMode::BYTE_LEVEL_BPE) {
+        const auto& table = ByteUnicode::get();
+        std::string piece;
+        piece.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ) {
+            const uint8_t c = static_cast<uint8_t>(text[i]);
+            const size_t len = std::min(utf8_len(c), text.size() - i);
+            const int cp = len == 1 ? c : len == 2 ? ((c & 0x1F) << 6) | (text[i + 1] & 0x3F) : -1;
+            if (cp >= 0 && cp < 512 && table.decode[cp] >= 0) {
+                piece += static_cast<char>(table.decode[cp]);
+            } else {
+                piece.append(text, i, len);
+            }
+            i += len;
+        }
+        return piece;
+    }
+
+    // "▁" (U+2581) marca espaço
+    static const std::string space_marker = "\xE2\x96\x81";
+    std::string piece;
+    piece.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ) {
+        if (text.compare(i, space_marker.size(), space_marker) == 0) {
+            piece += ' ';
+            i += space_marker.size();
+        } else {
+            piece += text[i++];
+        }
+    }
+    return piece;
+}
+
 std::vector<int32_t> SimpleTokenizer::encode_whitespace(const std::string& text) const {
     std::vector<int32_t> tokens;
     tokens.push_back(impl_->bos);
@@ -28,6 +28,10 @@ public:
     // Detokeniza IDs → texto
     std::string decode(const std::vector<int32_t>& tokens) const;
 
+    // Bytes que o token produz na saída ("▁" → espaço, <0xNN> → byte).
+    // Vazio para tokens especiais e ids fora do vocabulário.
+    std::string token_piece(int32_t id) const;
+
     // Tokens especiais
     int32_t bos_token() const;
     int32_t eos_token() const;
@@ -44,6 +48,7 @@ private:
     bool parse_token_array(const uint8_t*& p, const uint8_t* end);
     void skip_value(const uint8_t*& p, const uint8_t* end, uint32_t type);
     bool load_fallback();
+    void compile_vocab();  // escolhe o algoritmo e compila o vocabulário
 
     // Fallback: tokenização por espaço
     std::vector<int32_t> encode_whitespace(const std::string& text) const;
@@ -0,0 +1,372 @@
+#include "model/unicode_data.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace engine {
+
+namespace {
+
+// Gerado de UnicodeData.txt (14.0) a partir de U+0080 (o ASCII é tratado
+// em unicode_class). Cada entrada vale até o início da seguinte.
+// 3059 intervalos: (primeiro codepoint << 3) | classe
+const uint32_t UNICODE_RANGES[] = {
+    0x000400, 0x000553, 0x000558, 0x000595, 0x0005A0, 0x0005AA, 0x0005B0, 0x0005CD, 0x0005D3,
+    0x0005D8, 0x0005E5, 0x0005F8, 0x000601, 0x0006B8, 0x0006C1, 0x0006FA, 0x0007B8, 0x0007C2,
+    0x000801, 0x00080A, 0x000811, 0x00081A, 0x000821, 0x00082A, 0x000831, 0x00083A, 0x000841,
+    0x00084A, 0x000851, 0x00085A, 0x000861, 0x00086A, 0x000871, 0x00087A, 0x000881, 0x00088A,
+    0x000891, 0x00089A, 0x0008A1, 0x0008AA, 0x0008B1, 0x0008BA, 0x0008C1, 0x0008CA, 0x0008D1,
+    0x0008DA, 0x0008E1, 0x0008EA, 0x0008F1, 0x0008FA, 0x000901, 0x00090A, 0x000911, 0x00091A,
+    0x000921, 0x00092A, 0x000931, 0x00093A, 0x000941, 0x00094A, 0x000951, 0x00095A, 0x000961,
+    0x00096A, 0x000971, 0x00097A, 0x000981, 0x00098A, 0x000991, 0x00099A, 0x0009A1, 0x0009AA,
+    0x0009B1, 0x0009BA, 0x0009C9, 0x0009D2, 0x0009D9, 0x0009E2, 0x0009E9, 0x0009F2, 0x0009F9,
+    0x000A02, 0x000A09, 0x000A12, 0x000A19, 0x000A22, 0x000A29, 0x000A32, 0x000A39, 0x000A42,
+    0x000A51, 0x000A5A, 0x000A61, 0x000A6A, 0x000A71, 0x000A7A, 0x000A81, 0x000A8A, 0x000A91,
+    0x000A9A, 0x000AA1, 0x000AAA, 0x000AB1, 0x000ABA, 0x000AC1, 0x000ACA, 0x000AD1, 0x000ADA,
+    0x000AE1, 0x000AEA, 0x000AF1, 0x000AFA, 0x000B01, 0x000B0A, 0x000B11, 0x000B1A, 0x000B21,
+    0x000B2A, 0x000B31, 0x000B3A, 0x000B41, 0x000B4A, 0x000B51, 0x000B5A, 0x000B61, 0x000B6A,
+    0x000B71, 0x000B7A, 0x000B81, 0x000B8A, 0x000B91, 0x000B9A, 0x000BA1, 0x000BAA, 0x000BB1,
+    0x000BBA, 0x000BC1, 0x000BD2, 0x000BD9, 0x000BE2, 0x000BE9, 0x000BF2, 0x000C09, 0x000C1A,
+    0x000C21, 0x000C2A, 0x000C31, 0x000C42, 0x000C49, 0x000C62, 0x000C71, 0x000C92, 0x000C99,
+    0x000CAA, 0x000CB1, 0x000CCA, 0x000CE1, 0x000CF2, 0x000CF9, 0x000D0A, 0x000D11, 0x000D1A,
+    0x000D21, 0x000D2A, 0x000D31, 0x000D42, 0x000D49, 0x000D52, 0x000D61, 0x000D6A, 0x000D71,
+    0x000D82, 0x000D89, 0x000DA2, 0x000DA9, 0x000DB2, 0x000DB9, 0x000DCA, 0x000DDB, 0x000DE1,
+    0x000DEA, 0x000E03, 0x000E21, 0x000E32, 0x000E39, 0x000E4A, 0x000E51, 0x000E62, 0x000E69,
+    0x000E72, 0x000E79, 0x000E82, 0x000E89, 0x000E92, 0x000E99, 0x000EA2, 0x000EA9, 0x000EB2,
+    0x000EB9, 0x000EC2, 0x000EC9, 0x000ED2, 0x000ED9, 0x000EE2, 0x000EF1, 0x000EFA, 0x000F01,
+    0x000F0A, 0x000F11, 0x000F1A, 0x000F21, 0x000F2A, 0x000F31, 0x000F3A, 0x000F41, 0x000F4A,
+    0x000F51, 0x000F5A, 0x000F61, 0x000F6A, 0x000F71, 0x000F7A, 0x000F89, 0x000F9A, 0x000FA1,
+    0x000FAA, 0x000FB1, 0x000FCA, 0x000FD1, 0x000FDA, 0x000FE1, 0x000FEA, 0x000FF1, 0x000FFA,
+    0x001001, 0x00100A, 0x001011, 0x00101A, 0x001021, 0x00102A, 0x001031, 0x00103A, 0x001041,
+    0x00104A, 0x001051, 0x00105A, 0x001061, 0x00106A, 0x001071, 0x00107A, 0x001081, 0x00108A,
+    0x001091, 0x00109A, 0x0010A1, 0x0010AA, 0x0010B1, 0x0010BA, 0x0010C1, 0x0010CA, 0x0010D1,
+    0x0010DA, 0x0010E1, 0x0010EA, 0x0010F1, 0x0010FA, 0x001101, 0x00110A, 0x001111, 0x00111A,
+    0x001121, 0x00112A, 0x001131, 0x00113A, 0x001141, 0x00114A, 0x001151, 0x00115A, 0x001161,
+    0x00116A, 0x001171, 0x00117A, 0x001181, 0x00118A, 0x001191, 0x00119A, 0x0011D1, 0x0011E2,
+    0x0011E9, 0x0011FA, 0x001209, 0x001212, 0x001219, 0x00123A, 0x001241, 0x00124A, 0x001251,
+    0x00125A, 0x001261, 0x00126A, 0x001271, 0x00127A, 0x0014A3, 0x0014AA, 0x001583, 0x001610,
+    0x001633, 0x001690, 0x001703, 0x001728, 0x001763, 0x001768, 0x001773, 0x001778, 0x001804,
+    0x001B81, 0x001B8A, 0x001B91, 0x001B9A, 0x001BA3, 0x001BA8, 0x001BB1, 0x001BBA, 0x001BC0,
+    0x001BD3, 0x001BDA, 0x001BF0, 0x001BF9, 0x001C00, 0x001C31, 0x001C38, 0x001C41, 0x001C58,
+    0x001C61, 0x001C68, 0x001C71, 0x001C82, 0x001C89, 0x001D10, 0x001D19, 0x001D62, 0x001E79,
+    0x001E82, 0x001E91, 0x001EAA, 0x001EC1, 0x001ECA, 0x001ED1, 0x001EDA, 0x001EE1, 0x001EEA,
+    0x001EF1, 0x001EFA, 0x001F01, 0x001F0A, 0x001F11, 0x001F1A, 0x001F21, 0x001F2A, 0x001F31,
+    0x001F3A, 0x001F41, 0x001F4A, 0x001F51, 0x001F5A, 0x001F61, 0x001F6A, 0x001F71, 0x001F7A,
+    0x001FA1, 0x001FAA, 0x001FB0, 0x001FB9, 0x001FC2, 0x001FC9, 0x001FDA, 0x001FE9, 0x002182,
+    0x002301, 0x00230A, 0x002311, 0x00231A, 0x002321, 0x00232A, 0x002331, 0x00233A, 0x002341,
+    0x00234A, 0x002351, 0x00235A, 0x002361, 0x00236A, 0x002371, 0x00237A, 0x002381, 0x00238A,
+    0x002391, 0x00239A, 0x0023A1, 0x0023AA, 0x0023B1, 0x0023BA, 0x0023C1, 0x0023CA, 0x0023D1,
+    0x0023DA, 0x0023E1, 0x0023EA, 0x0023F1, 0x0023FA, 0x002401, 0x00240A, 0x002410, 0x00241C,
+    0x002451, 0x00245A, 0x002461, 0x00246A, 0x002471, 0x00247A, 0x002481, 0x00248A, 0x002491,
+    0x00249A, 0x0024A1, 0x0024AA, 0x0024B1, 0x0024BA, 0x0024C1, 0x0024CA, 0x0024D1, 0x0024DA,
+    0x0024E1, 0x0024EA, 0x0024F1, 0x0024FA, 0x002501, 0x00250A, 0x002511, 0x00251A, 0x002521,
+    0x00252A, 0x002531, 0x00253A, 0x002541, 0x00254A, 0x002551, 0x00255A, 0x002561, 0x00256A,
+    0x002571, 0x00257A, 0x002581, 0x00258A, 0x002591, 0x00259A, 0x0025A1, 0x0025AA, 0x0025B1,
+    0x0025BA, 0x0025C1, 0x0025CA, 0x0025D1, 0x0025DA, 0x0025E1, 0x0025EA, 0x0025F1, 0x0025FA,
+    0x002601, 0x002612, 0x002619, 0x002622, 0x002629, 0x002632, 0x002639, 0x002642, 0x002649,
+    0x002652, 0x002659, 0x002662, 0x002669, 0x002672, 0x002681, 0x00268A, 0x002691, 0x00269A,
+    0x0026A1, 0x0026AA, 0x0026B1, 0x0026BA, 0x0026C1, 0x0026CA, 0x0026D1, 0x0026DA, 0x0026E1,
+    0x0026EA, 0x0026F1, 0x0026FA, 0x002701, 0x00270A, 0x002711, 0x00271A, 0x002721, 0x00272A,
+    0x002731, 0x00273A, 0x002741, 0x00274A, 0x002751, 0x00275A, 0x002761, 0x00276A, 0x002771,
+    0x00277A, 0x002781, 0x00278A, 0x002791, 0x00279A, 0x0027A1, 0x0027AA, 0x0027B1, 0x0027BA,
+    0x0027C1, 0x0027CA, 0x0027D1, 0x0027DA, 0x0027E1, 0x0027EA, 0x0027F1, 0x0027FA, 0x002801,
+    0x00280A, 0x002811, 0x00281A, 0x002821, 0x00282A, 0x002831, 0x00283A, 0x002841, 0x00284A,
+    0x002851, 0x00285A, 0x002861, 0x00286A, 0x002871, 0x00287A, 0x002881, 0x00288A, 0x002891,
+    0x00289A, 0x0028A1, 0x0028AA, 0x0028B1, 0x0028BA, 0x0028C1, 0x0028CA, 0x0028D1, 0x0028DA,
+    0x0028E1, 0x0028EA, 0x0028F1, 0x0028FA, 0x002901, 0x00290A, 0x002911, 0x00291A, 0x002921,
+    0x00292A, 0x002931, 0x00293A, 0x002941, 0x00294A, 0x002951, 0x00295A, 0x002961, 0x00296A,
+    0x002971, 0x00297A, 0x002980, 0x002989, 0x002AB8, 0x002ACB, 0x002AD0, 0x002B02, 0x002C48,
+    0x002C8C, 0x002DF0, 0x002DFC, 0x002E00, 0x002E0C, 0x002E18, 0x002E24, 0x002E30, 0x002E3C,
+    0x002E40, 0x002E83, 0x002F58, 0x002F7B, 0x002F98, 0x003084, 0x0030D8, 0x003103, 0x00325C,
+    0x003305, 0x003350, 0x003373, 0x003384, 0x00338B, 0x0036A0, 0x0036AB, 0x0036B4, 0x0036E8,
+    0x0036FC, 0x00372B, 0x00373C, 0x003748, 0x003754, 0x003773, 0x003785, 0x0037D3, 0x0037E8,
+    0x0037FB, 0x003800, 0x003883, 0x00388C, 0x003893, 0x003984, 0x003A58, 0x003A6B, 0x003D34,
+    0x003D8B, 0x003D90, 0x003E05, 0x003E53, 0x003F5C, 0x003FA3, 0x003FB0, 0x003FD3, 0x003FD8,
+    0x003FEC, 0x003FF0, 0x004003, 0x0040B4, 0x0040D3, 0x0040DC, 0x004123, 0x00412C, 0x004143,
+    0x00414C, 0x004170, 0x004203, 0x0042CC, 0x0042E0, 0x004303, 0x004358, 0x004383, 0x004440,
+    0x00444B, 0x004478, 0x0044C4, 0x004503, 0x004654, 0x004710, 0x00471C, 0x004823, 0x0049D4,
+    0x0049EB, 0x0049F4, 0x004A83, 0x004A8C, 0x004AC3, 0x004B14, 0x004B20, 0x004B35, 0x004B80,
+    0x004B8B, 0x004C0C, 0x004C20, 0x004C2B, 0x004C68, 0x004C7B, 0x004C88, 0x004C9B, 0x004D48,
+    0x004D53, 0x004D88, 0x004D93, 0x004D98, 0x004DB3, 0x004DD0, 0x004DE4, 0x004DEB, 0x004DF4,
+    0x004E28, 0x004E3C, 0x004E48, 0x004E5C, 0x004E73, 0x004E78, 0x004EBC, 0x004EC0, 0x004EE3,
+    0x004EF0, 0x004EFB, 0x004F14, 0x004F20, 0x004F35, 0x004F83, 0x004F90, 0x004FA5, 0x004FD0,
+    0x004FE3, 0x004FE8, 0x004FF4, 0x004FF8, 0x00500C, 0x005020, 0x00502B, 0x005058, 0x00507B,
+    0x005088, 0x00509B, 0x005148, 0x005153, 0x005188, 0x005193, 0x0051A0, 0x0051AB, 0x0051B8,
+    0x0051C3, 0x0051D0, 0x0051E4, 0x0051E8, 0x0051F4, 0x005218, 0x00523C, 0x005248, 0x00525C,
+    0x005270, 0x00528C, 0x005290, 0x0052CB, 0x0052E8, 0x0052F3, 0x0052F8, 0x005335, 0x005384,
+    0x005393, 0x0053AC, 0x0053B0, 0x00540C, 0x005420, 0x00542B, 0x005470, 0x00547B, 0x005490,
+    0x00549B, 0x005548, 0x005553, 0x005588, 0x005593, 0x0055A0, 0x0055AB, 0x0055D0, 0x0055E4,
+    0x0055EB, 0x0055F4, 0x005630, 0x00563C, 0x005650, 0x00565C, 0x005670, 0x005683, 0x005688,
+    0x005703, 0x005714, 0x005720, 0x005735, 0x005780, 0x0057CB, 0x0057D4, 0x005800, 0x00580C,
+    0x005820, 0x00582B, 0x005868, 0x00587B, 0x005888, 0x00589B, 0x005948, 0x005953, 0x005988,
+    0x005993, 0x0059A0, 0x0059AB, 0x0059D0, 0x0059E4, 0x0059EB, 0x0059F4, 0x005A28, 0x005A3C,
+    0x005A48, 0x005A5C, 0x005A70, 0x005AAC, 0x005AC0, 0x005AE3, 0x005AF0, 0x005AFB, 0x005B14,
+    0x005B20, 0x005B35, 0x005B80, 0x005B8B, 0x005B95, 0x005BC0, 0x005C14, 0x005C1B, 0x005C20,
+    0x005C2B, 0x005C58, 0x005C73, 0x005C88, 0x005C93, 0x005CB0, 0x005CCB, 0x005CD8, 0x005CE3,
+    0x005CE8, 0x005CF3, 0x005D00, 0x005D1B, 0x005D28, 0x005D43, 0x005D58, 0x005D73, 0x005DD0,
+    0x005DF4, 0x005E18, 0x005E34, 0x005E48, 0x005E54, 0x005E70, 0x005E83, 0x005E88, 0x005EBC,
+    0x005EC0, 0x005F35, 0x005F98, 0x006004, 0x00602B, 0x006068, 0x006073, 0x006088, 0x006093,
+    0x006148, 0x006153, 0x0061D0, 0x0061E4, 0x0061EB, 0x0061F4, 0x006228, 0x006234, 0x006248,
+    0x006254, 0x006270, 0x0062AC, 0x0062B8, 0x0062C3, 0x0062D8, 0x0062EB, 0x0062F0, 0x006303,
+    0x006314, 0x006320, 0x006335, 0x006380, 0x0063C5, 0x0063F8, 0x006403, 0x00640C, 0x006420,
+    0x00642B, 0x006468, 0x006473, 0x006488, 0x006493, 0x006548, 0x006553, 0x0065A0, 0x0065AB,
+    0x0065D0, 0x0065E4, 0x0065EB, 0x0065F4, 0x006628, 0x006634, 0x006648, 0x006654, 0x006670,
+    0x0066AC, 0x0066B8, 0x0066EB, 0x0066F8, 0x006703, 0x006714, 0x006720, 0x006735, 0x006780,
+    0x00678B, 0x006798, 0x006804, 0x006823, 0x006868, 0x006873, 0x006888, 0x006893, 0x0069DC,
+    0x0069EB, 0x0069F4, 0x006A28, 0x006A34, 0x006A48, 0x006A54, 0x006A73, 0x006A78, 0x006AA3,
+    0x006ABC, 0x006AC5, 0x006AFB, 0x006B14, 0x006B20, 0x006B35, 0x006BC8, 0x006BD3, 0x006C00,
+    0x006C0C, 0x006C20, 0x006C2B, 0x006CB8, 0x006CD3, 0x006D90, 0x006D9B, 0x006DE0, 0x006DEB,
+    0x006DF0, 0x006E03, 0x006E38, 0x006E54, 0x006E58, 0x006E7C, 0x006EA8, 0x006EB4, 0x006EB8,
+    0x006EC4, 0x006F00, 0x006F35, 0x006F80, 0x006F94, 0x006FA0, 0x00700B, 0x00718C, 0x007193,
+    0x0071A4, 0x0071D8, 0x007203, 0x00723C, 0x007278, 0x007285, 0x0072D0, 0x00740B, 0x007418,
+    0x007423, 0x007428, 0x007433, 0x007458, 0x007463, 0x007520, 0x00752B, 0x007530, 0x00753B,
+    0x00758C, 0x007593, 0x0075A4, 0x0075EB, 0x0075F0, 0x007603, 0x007628, 0x007633, 0x007638,
+    0x007644, 0x007670, 0x007685, 0x0076D0, 0x0076E3, 0x007700, 0x007803, 0x007808, 0x0078C4,
+    0x0078D0, 0x007905, 0x0079A0, 0x0079AC, 0x0079B0, 0x0079BC, 0x0079C0, 0x0079CC, 0x0079D0,
+    0x0079F4, 0x007A03, 0x007A40, 0x007A4B, 0x007B68, 0x007B8C, 0x007C28, 0x007C34, 0x007C43,
+    0x007C6C, 0x007CC0, 0x007CCC, 0x007DE8, 0x007E34, 0x007E38, 0x008003, 0x00815C, 0x0081FB,
+    0x008205, 0x008250, 0x008283, 0x0082B4, 0x0082D3, 0x0082F4, 0x00830B, 0x008314, 0x00832B,
+    0x00833C, 0x008373, 0x00838C, 0x0083AB, 0x008414, 0x008473, 0x00847C, 0x008485, 0x0084D4,
+    0x0084F0, 0x008501, 0x008630, 0x008639, 0x008640, 0x008669, 0x008670, 0x008682, 0x0087D8,
+    0x0087E3, 0x0087EA, 0x008803, 0x009248, 0x009253, 0x009270, 0x009283, 0x0092B8, 0x0092C3,
+    0x0092C8, 0x0092D3, 0x0092F0, 0x009303, 0x009448, 0x009453, 0x009470, 0x009483, 0x009588,
+    0x009593, 0x0095B0, 0x0095C3, 0x0095F8, 0x009603, 0x009608, 0x009613, 0x009630, 0x009643,
+    0x0096B8, 0x0096C3, 0x009888, 0x009893, 0x0098B0, 0x0098C3, 0x009AD8, 0x009AEC, 0x009B00,
+    0x009B4D, 0x009BE8, 0x009C03, 0x009C80, 0x009D01, 0x009FB0, 0x009FC2, 0x009FF0, 0x00A00B,
+    0x00B368, 0x00B37B, 0x00B400, 0x00B40B, 0x00B4D8, 0x00B503, 0x00B758, 0x00B775, 0x00B78B,
+    0x00B7C8, 0x00B803, 0x00B894, 0x00B8B0, 0x00B8FB, 0x00B994, 0x00B9A8, 0x00BA03, 0x00BA94,
+    0x00BAA0, 0x00BB03, 0x00BB68, 0x00BB73, 0x00BB88, 0x00BB94, 0x00BBA0, 0x00BC03, 0x00BDA4,
+    0x00BEA0, 0x00BEBB, 0x00BEC0, 0x00BEE3, 0x00BEEC, 0x00BEF0, 0x00BF05, 0x00BF50, 0x00BF85,
+    0x00BFD0, 0x00C05C, 0x00C070, 0x00C07C, 0x00C085, 0x00C0D0, 0x00C103, 0x00C3C8, 0x00C403,
+    0x00C42C, 0x00C43B, 0x00C54C, 0x00C553, 0x00C558, 0x00C583, 0x00C7B0, 0x00C803, 0x00C8F8,
+    0x00C904, 0x00C960, 0x00C984, 0x00C9E0, 0x00CA35, 0x00CA83, 0x00CB70, 0x00CB83, 0x00CBA8,
+    0x00CC03, 0x00CD60, 0x00CD83, 0x00CE50, 0x00CE85, 0x00CED8, 0x00D003, 0x00D0BC, 0x00D0E0,
+    0x00D103, 0x00D2AC, 0x00D2F8, 0x00D304, 0x00D3E8, 0x00D3FC, 0x00D405, 0x00D450, 0x00D485,
+    0x00D4D0, 0x00D53B, 0x00D540, 0x00D584, 0x00D678, 0x00D804, 0x00D82B, 0x00D9A4, 0x00DA2B,
+    0x00DA68, 0x00DA85, 0x00DAD0, 0x00DB5C, 0x00DBA0, 0x00DC04, 0x00DC1B, 0x00DD0C, 0x00DD73,
+    0x00DD85, 0x00DDD3, 0x00DF34, 0x00DFA0, 0x00E003, 0x00E124, 0x00E1C0, 0x00E205, 0x00E250,
+    0x00E26B, 0x00E285, 0x00E2D3, 0x00E3F0, 0x00E402, 0x00E448, 0x00E481, 0x00E5D8, 0x00E5E9,
+    0x00E600, 0x00E684, 0x00E698, 0x00E6A4, 0x00E74B, 0x00E76C, 0x00E773, 0x00E7A4, 0x00E7AB,
+    0x00E7BC, 0x00E7D3, 0x00E7D8, 0x00E802, 0x00E963, 0x00EB5A, 0x00EBC3, 0x00EBCA, 0x00ECDB,
+    0x00EE04, 0x00F001, 0x00F00A, 0x00F011, 0x00F01A, 0x00F021, 0x00F02A, 0x00F031, 0x00F03A,
+    0x00F041, 0x00F04A, 0x00F051, 0x00F05A, 0x00F061, 0x00F06A, 0x00F071, 0x00F07A, 0x00F081,
+    0x00F08A, 0x00F091, 0x00F09A, 0x00F0A1, 0x00F0AA, 0x00F0B1, 0x00F0BA, 0x00F0C1, 0x00F0CA,
+    0x00F0D1, 0x00F0DA, 0x00F0E1, 0x00F0EA, 0x00F0F1, 0x00F0FA, 0x00F101, 0x00F10A, 0x00F111,
+    0x00F11A, 0x00F121, 0x00F12A, 0x00F131, 0x00F13A, 0x00F141, 0x00F14A, 0x00F151, 0x00F15A,
+    0x00F161, 0x00F16A, 0x00F171, 0x00F17A, 0x00F181, 0x00F18A, 0x00F191, 0x00F19A, 0x00F1A1,
+    0x00F1AA, 0x00F1B1, 0x00F1BA, 0x00F1C1, 0x00F1CA, 0x00F1D1, 0x00F1DA, 0x00F1E1, 0x00F1EA,
+    0x00F1F1, 0x00F1FA, 0x00F201, 0x00F20A, 0x00F211, 0x00F21A, 0x00F221, 0x00F22A, 0x00F231,
+    0x00F23A, 0x00F241, 0x00F24A, 0x00F251, 0x00F25A, 0x00F261, 0x00F26A, 0x00F271, 0x00F27A,
+    0x00F281, 0x00F28A, 0x00F291, 0x00F29A, 0x00F2A1, 0x00F2AA, 0x00F2B1, 0x00F2BA, 0x00F2C1,
+    0x00F2CA, 0x00F2D1, 0x00F2DA, 0x00F2E1, 0x00F2EA, 0x00F2F1, 0x00F2FA, 0x00F301, 0x00F30A,
+    0x00F311, 0x00F31A, 0x00F321, 0x00F32A, 0x00F331, 0x00F33A, 0x00F341, 0x00F34A, 0x00F351,
+    0x00F35A, 0x00F361, 0x00F36A, 0x00F371, 0x00F37A, 0x00F381, 0x00F38A, 0x00F391, 0x00F39A,
+    0x00F3A1, 0x00F3AA, 0x00F3B1, 0x00F3BA, 0x00F3C1, 0x00F3CA, 0x00F3D1, 0x00F3DA, 0x00F3E1,
+    0x00F3EA, 0x00F3F1, 0x00F3FA, 0x00F401, 0x00F40A, 0x00F411, 0x00F41A, 0x00F421, 0x00F42A,
+    0x00F431, 0x00F43A, 0x00F441, 0x00F44A, 0x00F451, 0x00F45A, 0x00F461, 0x00F46A, 0x00F471,
+    0x00F47A, 0x00F481, 0x00F48A, 0x00F491, 0x00F49A, 0x00F4A1, 0x00F4AA, 0x00F4F1, 0x00F4FA,
+    0x00F501, 0x00F50A, 0x00F511, 0x00F51A, 0x00F521, 0x00F52A, 0x00F531, 0x00F53A, 0x00F541,
+    0x00F54A, 0x00F551, 0x00F55A, 0x00F561, 0x00F56A, 0x00F571, 0x00F57A, 0x00F581, 0x00F58A,
+    0x00F591, 0x00F59A, 0x00F5A1, 0x00F5AA, 0x00F5B1, 0x00F5BA, 0x00F5C1, 0x00F5CA, 0x00F5D1,
+    0x00F5DA, 0x00F5E1, 0x00F5EA, 0x00F5F1, 0x00F5FA, 0x00F601, 0x00F60A, 0x00F611, 0x00F61A,
+    0x00F621, 0x00F62A, 0x00F631, 0x00F63A, 0x00F641, 0x00F64A, 0x00F651, 0x00F65A, 0x00F661,
+    0x00F66A, 0x00F671, 0x00F67A, 0x00F681, 0x00F68A, 0x00F691, 0x00F69A, 0x00F6A1, 0x00F6AA,
+    0x00F6B1, 0x00F6BA, 0x00F6C1, 0x00F6CA, 0x00F6D1, 0x00F6DA, 0x00F6E1, 0x00F6EA, 0x00F6F1,
+    0x00F6FA, 0x00F701, 0x00F70A, 0x00F711, 0x00F71A, 0x00F721, 0x00F72A, 0x00F731, 0x00F73A,
+    0x00F741, 0x00F74A, 0x00F751, 0x00F75A, 0x00F761, 0x00F76A, 0x00F771, 0x00F77A, 0x00F781,
+    0x00F78A, 0x00F791, 0x00F79A, 0x00F7A1, 0x00F7AA, 0x00F7B1, 0x00F7BA, 0x00F7C1, 0x00F7CA,
+    0x00F7D1, 0x00F7DA, 0x00F7E1, 0x00F7EA, 0x00F7F1, 0x00F7FA, 0x00F841, 0x00F882, 0x00F8B0,
+    0x00F8C1, 0x00F8F0, 0x00F902, 0x00F941, 0x00F982, 0x00F9C1, 0x00FA02, 0x00FA30, 0x00FA41,
+    0x00FA70, 0x00FA82, 0x00FAC0, 0x00FAC9, 0x00FAD0, 0x00FAD9, 0x00FAE0, 0x00FAE9, 0x00FAF0,
+    0x00FAF9, 0x00FB02, 0x00FB41, 0x00FB82, 0x00FBF0, 0x00FC02, 0x00FC41, 0x00FC82, 0x00FCC1,
+    0x00FD02, 0x00FD41, 0x00FD82, 0x00FDA8, 0x00FDB2, 0x00FDC1, 0x00FDE8, 0x00FDF2, 0x00FDF8,
+    0x00FE12, 0x00FE28, 0x00FE32, 0x00FE41, 0x00FE68, 0x00FE82, 0x00FEA0, 0x00FEB2, 0x00FEC1,
+    0x00FEE0, 0x00FF02, 0x00FF41, 0x00FF68, 0x00FF92, 0x00FFA8, 0x00FFB2, 0x00FFC1, 0x00FFE8,
+    0x010385, 0x01038B, 0x010390, 0x0103A5, 0x0103D0, 0x0103FB, 0x010405, 0x010450, 0x010483,
+    0x0104E8, 0x010684, 0x010788, 0x010811, 0x010818, 0x010839, 0x010840, 0x010852, 0x010859,
+    0x010872, 0x010881, 0x01089A, 0x0108A0, 0x0108A9, 0x0108B0, 0x0108C9, 0x0108F0, 0x010921,
+    0x010928, 0x010931, 0x010938, 0x010941, 0x010948, 0x010951, 0x010970, 0x01097A, 0x010981,
+    0x0109A2, 0x0109AB, 0x0109CA, 0x0109D0, 0x0109E2, 0x0109F1, 0x010A00, 0x010A29, 0x010A32,
+    0x010A50, 0x010A72, 0x010A78, 0x010A85, 0x010C19, 0x010C22, 0x010C2D, 0x010C50, 0x012305,
+    0x0124E0, 0x012755, 0x012800, 0x013BB5, 0x013CA0, 0x016001, 0x016182, 0x016301, 0x01630A,
+    0x016311, 0x01632A, 0x016339, 0x016342, 0x016349, 0x016352, 0x016359, 0x016362, 0x016369,
+    0x01638A, 0x016391, 0x01639A, 0x0163A9, 0x0163B2, 0x0163E3, 0x0163F1, 0x01640A, 0x016411,
+    0x01641A, 0x016421, 0x01642A, 0x016431, 0x01643A, 0x016441, 0x01644A, 0x016451, 0x01645A,
+    0x016461, 0x01646A, 0x016471, 0x01647A, 0x016481, 0x01648A, 0x016491, 0x01649A, 0x0164A1,
+    0x0164AA, 0x0164B1, 0x0164BA, 0x0164C1, 0x0164CA, 0x0164D1, 0x0164DA, 0x0164E1, 0x0164EA,
+    0x0164F1, 0x0164FA, 0x016501, 0x01650A, 0x016511, 0x01651A, 0x016521, 0x01652A, 0x016531,
+    0x01653A, 0x016541, 0x01654A, 0x016551, 0x01655A, 0x016561, 0x01656A, 0x016571, 0x01657A,
+    0x016581, 0x01658A, 0x016591, 0x01659A, 0x0165A1, 0x0165AA, 0x0165B1, 0x0165BA, 0x0165C1,
+    0x0165CA, 0x0165D1, 0x0165DA, 0x0165E1, 0x0165EA, 0x0165F1, 0x0165FA, 0x016601, 0x01660A,
+    0x016611, 0x01661A, 0x016621, 0x01662A, 0x016631, 0x01663A, 0x016641, 0x01664A, 0x016651,
+    0x01665A, 0x016661, 0x01666A, 0x016671, 0x01667A, 0x016681, 0x01668A, 0x016691, 0x01669A,
+    0x0166A1, 0x0166AA, 0x0166B1, 0x0166BA, 0x0166C1, 0x0166CA, 0x0166D1, 0x0166DA, 0x0166E1,
+    0x0166EA, 0x0166F1, 0x0166FA, 0x016701, 0x01670A, 0x016711, 0x01671A, 0x016728, 0x016759,
+    0x016762, 0x016769, 0x016772, 0x01677C, 0x016791, 0x01679A, 0x0167A0, 0x0167ED, 0x0167F0,
+    0x016802, 0x016930, 0x01693A, 0x016940, 0x01696A, 0x016970, 0x016983, 0x016B40, 0x016B7B,
+    0x016B80, 0x016BFC, 0x016C03, 0x016CB8, 0x016D03, 0x016D38, 0x016D43, 0x016D78, 0x016D83,
+    0x016DB8, 0x016DC3, 0x016DF8, 0x016E03, 0x016E38, 0x016E43, 0x016E78, 0x016E83, 0x016EB8,
+    0x016EC3, 0x016EF8, 0x016F04, 0x017000, 0x01717B, 0x017180, 0x01802B, 0x01803D, 0x018040,
+    0x01810D, 0x018154, 0x018180, 0x01818B, 0x0181B0, 0x0181C5, 0x0181DB, 0x0181E8, 0x01820B,
+    0x0184B8, 0x0184CC, 0x0184D8, 0x0184EB, 0x018500, 0x01850B, 0x0187D8, 0x0187E3, 0x018800,
+    0x01882B, 0x018980, 0x01898B, 0x018C78, 0x018C95, 0x018CB0, 0x018D03, 0x018E00, 0x018F83,
+    0x019000, 0x019105, 0x019150, 0x019245, 0x019280, 0x01928D, 0x019300, 0x019405, 0x019450,
+    0x01958D, 0x019600, 0x01A003, 0x026E00, 0x027003, 0x052468, 0x052683, 0x0527F0, 0x052803,
+    0x053068, 0x053083, 0x053105, 0x053153, 0x053160, 0x053201, 0x05320A, 0x053211, 0x05321A,
+    0x053221, 0x05322A, 0x053231, 0x05323A, 0x053241, 0x05324A, 0x053251, 0x05325A, 0x053261,
+    0x05326A, 0x053271, 0x05327A, 0x053281, 0x05328A, 0x053291, 0x05329A, 0x0532A1, 0x0532AA,
+    0x0532B1, 0x0532BA, 0x0532C1, 0x0532CA, 0x0532D1, 0x0532DA, 0x0532E1, 0x0532EA, 0x0532F1,
+    0x0532FA, 0x053301, 0x05330A, 0x053311, 0x05331A, 0x053321, 0x05332A, 0x053331, 0x05333A,
+    0x053341, 0x05334A, 0x053351, 0x05335A, 0x053361, 0x05336A, 0x053373, 0x05337C, 0x053398,
+    0x0533A4, 0x0533F0, 0x0533FB, 0x053401, 0x05340A, 0x053411, 0x05341A, 0x053421, 0x05342A,
+    0x053431, 0x05343A, 0x053441, 0x05344A, 0x053451, 0x05345A, 0x053461, 0x05346A, 0x053471,
+    0x05347A, 0x053481, 0x05348A, 0x053491, 0x05349A, 0x0534A1, 0x0534AA, 0x0534B1, 0x0534BA,
+    0x0534C1, 0x0534CA, 0x0534D1, 0x0534DA, 0x0534E3, 0x0534F4, 0x053503, 0x053735, 0x053784,
+    0x053790, 0x0538BB, 0x053900, 0x053911, 0x05391A, 0x053921, 0x05392A, 0x053931, 0x05393A,
+    0x053941, 0x05394A, 0x053951, 0x05395A, 0x053961, 0x05396A, 0x053971, 0x05397A, 0x053991,
+    0x05399A, 0x0539A1, 0x0539AA, 0x0539B1, 0x0539BA, 0x0539C1, 0x0539CA, 0x0539D1, 0x0539DA,
+    0x0539E1, 0x0539EA, 0x0539F1, 0x0539FA, 0x053A01, 0x053A0A, 0x053A11, 0x053A1A, 0x053A21,
+    0x053A2A, 0x053A31, 0x053A3A, 0x053A41, 0x053A4A, 0x053A51, 0x053A5A, 0x053A61, 0x053A6A,
+    0x053A71, 0x053A7A, 0x053A81, 0x053A8A, 0x053A91, 0x053A9A, 0x053AA1, 0x053AAA, 0x053AB1,
+    0x053ABA, 0x053AC1, 0x053ACA, 0x053AD1, 0x053ADA, 0x053AE1, 0x053AEA, 0x053AF1, 0x053AFA,
+    0x053B01, 0x053B0A, 0x053B11, 0x053B1A, 0x053B21, 0x053B2A, 0x053B31, 0x053B3A, 0x053B41,
+    0x053B4A, 0x053B51, 0x053B5A, 0x053B61, 0x053B6A, 0x053B71, 0x053B7A, 0x053B83, 0x053B8A,
+    0x053BC9, 0x053BD2, 0x053BD9, 0x053BE2, 0x053BE9, 0x053BFA, 0x053C01, 0x053C0A, 0x053C11,
+    0x053C1A, 0x053C21, 0x053C2A, 0x053C31, 0x053C3A, 0x053C43, 0x053C48, 0x053C59, 0x053C62,
+    0x053C69, 0x053C72, 0x053C7B, 0x053C81, 0x053C8A, 0x053C91, 0x053C9A, 0x053CB1, 0x053CBA,
+    0x053CC1, 0x053CCA, 0x053CD1, 0x053CDA, 0x053CE1, 0x053CEA, 0x053CF1, 0x053CFA, 0x053D01,
+    0x053D0A, 0x053D11, 0x053D1A, 0x053D21, 0x053D2A, 0x053D31, 0x053D3A, 0x053D41, 0x053D4A,
+    0x053D51, 0x053D7A, 0x053D81, 0x053DAA, 0x053DB1, 0x053DBA, 0x053DC1, 0x053DCA, 0x053DD1,
+    0x053DDA, 0x053DE1, 0x053DEA, 0x053DF1, 0x053DFA, 0x053E01, 0x053E0A, 0x053E11, 0x053E1A,
+    0x053E21, 0x053E42, 0x053E49, 0x053E52, 0x053E58, 0x053E81, 0x053E8A, 0x053E90, 0x053E9A,
+    0x053EA0, 0x053EAA, 0x053EB1, 0x053EBA, 0x053EC1, 0x053ECA, 0x053ED0, 0x053F93, 0x053FA9,
+    0x053FB2, 0x053FBB, 0x053FD2, 0x053FDB, 0x054014, 0x05401B, 0x054034, 0x05403B, 0x05405C,
+    0x054063, 0x05411C, 0x054140, 0x054164, 0x054168, 0x054185, 0x0541B0, 0x054203, 0x0543A0,
+    0x054404, 0x054413, 0x0545A4, 0x054630, 0x054685, 0x0546D0, 0x054704, 0x054793, 0x0547C0,
+    0x0547DB, 0x0547E0, 0x0547EB, 0x0547FC, 0x054805, 0x054853, 0x054934, 0x054970, 0x054983,
+    0x054A3C, 0x054AA0, 0x054B03, 0x054BE8, 0x054C04, 0x054C23, 0x054D9C, 0x054E08, 0x054E7B,
+    0x054E85, 0x054ED0, 0x054F03, 0x054F2C, 0x054F33, 0x054F85, 0x054FD3, 0x054FF8, 0x055003,
+    0x05514C, 0x0551B8, 0x055203, 0x05521C, 0x055223, 0x055264, 0x055270, 0x055285, 0x0552D0,
+    0x055303, 0x0553B8, 0x0553D3, 0x0553DC, 0x0553F3, 0x055584, 0x05558B, 0x055594, 0x0555AB,
+    0x0555BC, 0x0555CB, 0x0555F4, 0x055603, 0x05560C, 0x055613, 0x055618, 0x0556DB, 0x0556F0,
+    0x055703, 0x05575C, 0x055780, 0x055793, 0x0557AC, 0x0557B8, 0x05580B, 0x055838, 0x05584B,
+    0x055878, 0x05588B, 0x0558B8, 0x055903, 0x055938, 0x055943, 0x055978, 0x055982, 0x055AD8,
+    0x055AE3, 0x055B02, 0x055B4B, 0x055B50, 0x055B82, 0x055E03, 0x055F1C, 0x055F58, 0x055F64,
+    0x055F70, 0x055F85, 0x055FD0, 0x056003, 0x06BD20, 0x06BD83, 0x06BE38, 0x06BE5B, 0x06BFE0,
+    0x07C803, 0x07D370, 0x07D383, 0x07D6D0, 0x07D802, 0x07D838, 0x07D89A, 0x07D8C0, 0x07D8EB,
+    0x07D8F4, 0x07D8FB, 0x07D948, 0x07D953, 0x07D9B8, 0x07D9C3, 0x07D9E8, 0x07D9F3, 0x07D9F8,
+    0x07DA03, 0x07DA10, 0x07DA1B, 0x07DA28, 0x07DA33, 0x07DD90, 0x07DE9B, 0x07E9F0, 0x07EA83,
+    0x07EC80, 0x07EC93, 0x07EE40, 0x07EF83, 0x07EFE0, 0x07F004, 0x07F080, 0x07F104, 0x07F180,
+    0x07F383, 0x07F3A8, 0x07F3B3, 0x07F7E8, 0x07F885, 0x07F8D0, 0x07F909, 0x07F9D8, 0x07FA0A,
+    0x07FAD8, 0x07FB33, 0x07FDF8, 0x07FE13, 0x07FE40, 0x07FE53, 0x07FE80, 0x07FE93, 0x07FEC0,
+    0x07FED3, 0x07FEE8, 0x080003, 0x080060, 0x08006B, 0x080138, 0x080143, 0x0801D8, 0x0801E3,
+    0x0801F0, 0x0801FB, 0x080270, 0x080283, 0x0802F0, 0x080403, 0x0807D8, 0x08083D, 0x0809A0,
+    0x080A05, 0x080BC8, 0x080C55, 0x080C60, 0x080FEC, 0x080FF0, 0x081403, 0x0814E8, 0x081503,
+    0x081688, 0x081704, 0x08170D, 0x0817E0, 0x081803, 0x081905, 0x081920, 0x08196B, 0x081A0D,
+    0x081A13, 0x081A55, 0x081A58, 0x081A83, 0x081BB4, 0x081BD8, 0x081C03, 0x081CF0, 0x081D03,
+    0x081E20, 0x081E43, 0x081E80, 0x081E8D, 0x081EB0, 0x082001, 0x082142, 0x082283, 0x0824F0,
+    0x082505, 0x082550, 0x082581, 0x0826A0, 0x0826C2, 0x0827E0, 0x082803, 0x082940, 0x082983,
+    0x082B20, 0x082B81, 0x082BD8, 0x082BE1, 0x082C58, 0x082C61, 0x082C98, 0x082CA1, 0x082CB0,
+    0x082CBA, 0x082D10, 0x082D1A, 0x082D90, 0x082D9A, 0x082DD0, 0x082DDA, 0x082DE8, 0x083003,
+    0x0839B8, 0x083A03, 0x083AB0, 0x083B03, 0x083B40, 0x083C03, 0x083C30, 0x083C3B, 0x083D88,
+    0x083D93, 0x083DD8, 0x084003, 0x084030, 0x084043, 0x084048, 0x084053, 0x0841B0, 0x0841BB,
+    0x0841C8, 0x0841E3, 0x0841E8, 0x0841FB, 0x0842B0, 0x0842C5, 0x084303, 0x0843B8, 0x0843CD,
+    0x084403, 0x0844F8, 0x08453D, 0x084580, 0x084703, 0x084798, 0x0847A3, 0x0847B0, 0x0847DD,
+    0x084803, 0x0848B5, 0x0848E0, 0x084903, 0x0849D0, 0x084C03, 0x084DC0, 0x084DE5, 0x084DF3,
+    0x084E05, 0x084E80, 0x084E95, 0x085003, 0x08500C, 0x085020, 0x08502C, 0x085038, 0x085064,
+    0x085083, 0x0850A0, 0x0850AB, 0x0850C0, 0x0850CB, 0x0851B0, 0x0851C4, 0x0851D8, 0x0851FC,
+    0x085205, 0x085248, 0x085303, 0x0853ED, 0x0853F8, 0x085403, 0x0854ED, 0x085500, 0x085603,
+    0x085640, 0x08564B, 0x08572C, 0x085738, 0x08575D, 0x085780, 0x085803, 0x0859B0, 0x085A03,
+    0x085AB0, 0x085AC5, 0x085B03, 0x085B98, 0x085BC5, 0x085C03, 0x085C90, 0x085D4D, 0x085D80,
+    0x086003, 0x086248, 0x086401, 0x086598, 0x086602, 0x086798, 0x0867D5, 0x086803, 0x086924,
+    0x086940, 0x086985, 0x0869D0, 0x087305, 0x0873F8, 0x087403, 0x087550, 0x08755C, 0x087568,
+    0x087583, 0x087590, 0x087803, 0x0878ED, 0x08793B, 0x087940, 0x087983, 0x087A34, 0x087A8D,
+    0x087AA8, 0x087B83, 0x087C14, 0x087C30, 0x087D83, 0x087E2D, 0x087E60, 0x087F03, 0x087FB8,
+    0x088004, 0x08801B, 0x0881C4, 0x088238, 0x088295, 0x088384, 0x08838B, 0x08839C, 0x0883AB,
+    0x0883B0, 0x0883FC, 0x08841B, 0x088584, 0x0885D8, 0x088614, 0x088618, 0x088683, 0x088748,
+    0x088785, 0x0887D0, 0x088804, 0x08881B, 0x08893C, 0x0889A8, 0x0889B5, 0x088A00, 0x088A23,
+    0x088A2C, 0x088A3B, 0x088A40, 0x088A83, 0x088B9C, 0x088BA0, 0x088BB3, 0x088BB8, 0x088C04,
+    0x088C1B, 0x088D9C, 0x088E0B, 0x088E28, 0x088E4C, 0x088E68, 0x088E74, 0x088E85, 0x088ED3,
+    0x088ED8, 0x088EE3, 0x088EE8, 0x088F0D, 0x088FA8, 0x089003, 0x089090, 0x08909B, 0x089164,
+    0x0891C0, 0x0891F4, 0x0891F8, 0x089403, 0x089438, 0x089443, 0x089448, 0x089453, 0x089470,
+    0x08947B, 0x0894F0, 0x0894FB, 0x089548, 0x089583, 0x0896FC, 0x089758, 0x089785, 0x0897D0,
+    0x089804, 0x089820, 0x08982B, 0x089868, 0x08987B, 0x089888, 0x08989B, 0x089948, 0x089953,
+    0x089988, 0x089993, 0x0899A0, 0x0899AB, 0x0899D0, 0x0899DC, 0x0899EB, 0x0899F4, 0x089A28,
+    0x089A3C, 0x089A48, 0x089A5C, 0x089A70, 0x089A83, 0x089A88, 0x089ABC, 0x089AC0, 0x089AEB,
+    0x089B14, 0x089B20, 0x089B34, 0x089B68, 0x089B84, 0x089BA8, 0x08A003, 0x08A1AC, 0x08A23B,
+    0x08A258, 0x08A285, 0x08A2D0, 0x08A2F4, 0x08A2FB, 0x08A310, 0x08A403, 0x08A584, 0x08A623,
+    0x08A630, 0x08A63B, 0x08A640, 0x08A685, 0x08A6D0, 0x08AC03, 0x08AD7C, 0x08ADB0, 0x08ADC4,
+    0x08AE08, 0x08AEC3, 0x08AEE4, 0x08AEF0, 0x08B003, 0x08B184, 0x08B208, 0x08B223, 0x08B228,
+    0x08B285, 0x08B2D0, 0x08B403, 0x08B55C, 0x08B5C3, 0x08B5C8, 0x08B605, 0x08B650, 0x08B803,
+    0x08B8D8, 0x08B8EC, 0x08B960, 0x08B985, 0x08B9E0, 0x08BA03, 0x08BA38, 0x08C003, 0x08C164,
+    0x08C1D8, 0x08C501, 0x08C602, 0x08C705, 0x08C798, 0x08C7FB, 0x08C838, 0x08C84B, 0x08C850,
+    0x08C863, 0x08C8A0, 0x08C8AB, 0x08C8B8, 0x08C8C3, 0x08C984, 0x08C9B0, 0x08C9BC, 0x08C9C8,
+    0x08C9DC, 0x08C9FB, 0x08CA04, 0x08CA0B, 0x08CA14, 0x08CA20, 0x08CA85, 0x08CAD0, 0x08CD03,
+    0x08CD40, 0x08CD53, 0x08CE8C, 0x08CEC0, 0x08CED4, 0x08CF0B, 0x08CF10, 0x08CF1B, 0x08CF24,
+    0x08CF28, 0x08D003, 0x08D00C, 0x08D05B, 0x08D19C, 0x08D1D3, 0x08D1DC, 0x08D1F8, 0x08D23C,
+    0x08D240, 0x08D283, 0x08D28C, 0x08D2E3, 0x08D454, 0x08D4D0, 0x08D4EB, 0x08D4F0, 0x08D583,
+    0x08D7C8, 0x08E003, 0x08E048, 0x08E053, 0x08E17C, 0x08E1B8, 0x08E1C4, 0x08E203, 0x08E208,
+    0x08E285, 0x08E368, 0x08E393, 0x08E480, 0x08E494, 0x08E540, 0x08E54C, 0x08E5B8, 0x08E803,
+    0x08E838, 0x08E843, 0x08E850, 0x08E85B, 0x08E98C, 0x08E9B8, 0x08E9D4, 0x08E9D8, 0x08E9E4,
+    0x08E9F0, 0x08E9FC, 0x08EA33, 0x08EA3C, 0x08EA40, 0x08EA85, 0x08EAD0, 0x08EB03, 0x08EB30,
+    0x08EB3B, 0x08EB48, 0x08EB53, 0x08EC54, 0x08EC78, 0x08EC84, 0x08EC90, 0x08EC9C, 0x08ECC3,
+    0x08ECC8, 0x08ED05, 0x08ED50, 0x08F703, 0x08F79C, 0x08F7B8, 0x08FD83, 0x08FD88, 0x08FE05,
+    0x08FEA8, 0x090003, 0x091CD0, 0x092005, 0x092378, 0x092403, 0x092A20, 0x097C83, 0x097F88,
+    0x098003, 0x09A178, 0x0A2003, 0x0A3238, 0x0B4003, 0x0B51C8, 0x0B5203, 0x0B52F8, 0x0B5305,
+    0x0B5350, 0x0B5383, 0x0B55F8, 0x0B5605, 0x0B5650, 0x0B5683, 0x0B5770, 0x0B5784, 0x0B57A8,
+    0x0B5803, 0x0B5984, 0x0B59B8, 0x0B5A03, 0x0B5A20, 0x0B5A85, 0x0B5AD0, 0x0B5ADD, 0x0B5B10,
+    0x0B5B1B, 0x0B5BC0, 0x0B5BEB, 0x0B5C80, 0x0B7201, 0x0B7302, 0x0B7405, 0x0B74B8, 0x0B7803,
+    0x0B7A58, 0x0B7A7C, 0x0B7A83, 0x0B7A8C, 0x0B7C40, 0x0B7C7C, 0x0B7C9B, 0x0B7D00, 0x0B7F03,
+    0x0B7F10, 0x0B7F1B, 0x0B7F24, 0x0B7F28, 0x0B7F84, 0x0B7F90, 0x0B8003, 0x0C3FC0, 0x0C4003,
+    0x0C66B0, 0x0C6803, 0x0C6848, 0x0D7F83, 0x0D7FA0, 0x0D7FAB, 0x0D7FE0, 0x0D7FEB, 0x0D7FF8,
+    0x0D8003, 0x0D8918, 0x0D8A83, 0x0D8A98, 0x0D8B23, 0x0D8B40, 0x0D8B83, 0x0D97E0, 0x0DE003,
+    0x0DE358, 0x0DE383, 0x0DE3E8, 0x0DE403, 0x0DE448, 0x0DE483, 0x0DE4D0, 0x0DE4EC, 0x0DE4F8,
+    0x0E7804, 0x0E7970, 0x0E7984, 0x0E7A38, 0x0E8B2C, 0x0E8B50, 0x0E8B6C, 0x0E8B98, 0x0E8BDC,
+    0x0E8C18, 0x0E8C2C, 0x0E8C60, 0x0E8D54, 0x0E8D70, 0x0E9214, 0x0E9228, 0x0E9705, 0x0E97A0,
+    0x0E9B05, 0x0E9BC8, 0x0EA001, 0x0EA0D2, 0x0EA1A1, 0x0EA272, 0x0EA2A8, 0x0EA2B2, 0x0EA341,
+    0x0EA412, 0x0EA4E1, 0x0EA4E8, 0x0EA4F1, 0x0EA500, 0x0EA511, 0x0EA518, 0x0EA529, 0x0EA538,
+    0x0EA549, 0x0EA568, 0x0EA571, 0x0EA5B2, 0x0EA5D0, 0x0EA5DA, 0x0EA5E0, 0x0EA5EA, 0x0EA620,
+    0x0EA62A, 0x0EA681, 0x0EA752, 0x0EA821, 0x0EA830, 0x0EA839, 0x0EA858, 0x0EA869, 0x0EA8A8,
+    0x0EA8B1, 0x0EA8E8, 0x0EA8F2, 0x0EA9C1, 0x0EA9D0, 0x0EA9D9, 0x0EA9F8, 0x0EAA01, 0x0EAA28,
+    0x0EAA31, 0x0EAA38, 0x0EAA51, 0x0EAA88, 0x0EAA92, 0x0EAB61, 0x0EAC32, 0x0EAD01, 0x0EADD2,
+    0x0EAEA1, 0x0EAF72, 0x0EB041, 0x0EB112, 0x0EB1E1, 0x0EB2B2, 0x0EB381, 0x0EB452, 0x0EB530,
+    0x0EB541, 0x0EB608, 0x0EB612, 0x0EB6D8, 0x0EB6E2, 0x0EB711, 0x0EB7D8, 0x0EB7E2, 0x0EB8A8,
+    0x0EB8B2, 0x0EB8E1, 0x0EB9A8, 0x0EB9B2, 0x0EBA78, 0x0EBA82, 0x0EBAB1, 0x0EBB78, 0x0EBB82,
+    0x0EBC48, 0x0EBC52, 0x0EBC81, 0x0EBD48, 0x0EBD52, 0x0EBE18, 0x0EBE22, 0x0EBE51, 0x0EBE5A,
+    0x0EBE60, 0x0EBE75, 0x0EC000, 0x0ED004, 0x0ED1B8, 0x0ED1DC, 0x0ED368, 0x0ED3AC, 0x0ED3B0,
+    0x0ED424, 0x0ED428, 0x0ED4DC, 0x0ED500, 0x0ED50C, 0x0ED580, 0x0EF802, 0x0EF853, 0x0EF85A,
+    0x0EF8F8, 0x0F0004, 0x0F0038, 0x0F0044, 0x0F00C8, 0x0F00DC, 0x0F0110, 0x0F011C, 0x0F0128,
+    0x0F0134, 0x0F0158, 0x0F0803, 0x0F0968, 0x0F0984, 0x0F09BB, 0x0F09F0, 0x0F0A05, 0x0F0A50,
+    0x0F0A73, 0x0F0A78, 0x0F1483, 0x0F1574, 0x0F1578, 0x0F1603, 0x0F1764, 0x0F1785, 0x0F17D0,
+    0x0F3F03, 0x0F3F38, 0x0F3F43, 0x0F3F60, 0x0F3F6B, 0x0F3F78, 0x0F3F83, 0x0F3FF8, 0x0F4003,
+    0x0F4628, 0x0F463D, 0x0F4684, 0x0F46B8, 0x0F4801, 0x0F4912, 0x0F4A24, 0x0F4A5B, 0x0F4A60,
+    0x0F4A85, 0x0F4AD0, 0x0F638D, 0x0F6560, 0x0F656D, 0x0F6580, 0x0F658D, 0x0F65A8, 0x0F680D,
+    0x0F6970, 0x0F697D, 0x0F69F0, 0x0F7003, 0x0F7020, 0x0F702B, 0x0F7100, 0x0F710B, 0x0F7118,
+    0x0F7123, 0x0F7128, 0x0F713B, 0x0F7140, 0x0F714B, 0x0F7198, 0x0F71A3, 0x0F71C0, 0x0F71CB,
+    0x0F71D0, 0x0F71DB, 0x0F71E0, 0x0F7213, 0x0F7218, 0x0F723B, 0x0F7240, 0x0F724B, 0x0F7250,
+    0x0F725B, 0x0F7260, 0x0F726B, 0x0F7280, 0x0F728B, 0x0F7298, 0x0F72A3, 0x0F72A8, 0x0F72BB,
+    0x0F72C0, 0x0F72CB, 0x0F72D0, 0x0F72DB, 0x0F72E0, 0x0F72EB, 0x0F72F0, 0x0F72FB, 0x0F7300,
+    0x0F730B, 0x0F7318, 0x0F7323, 0x0F7328, 0x0F733B, 0x0F7358, 0x0F7363, 0x0F7398, 0x0F73A3,
+    0x0F73C0, 0x0F73CB, 0x0F73E8, 0x0F73F3, 0x0F73F8, 0x0F7403, 0x0F7450, 0x0F745B, 0x0F74E0,
+    0x0F750B, 0x0F7520, 0x0F752B, 0x0F7550, 0x0F755B, 0x0F75E0, 0x0F8805, 0x0F8868, 0x0FDF85,
+    0x0FDFD0, 0x100003, 0x153700, 0x153803, 0x15B9C8, 0x15BA03, 0x15C0F0, 0x15C103, 0x167510,
+    0x167583, 0x175F08, 0x17C003, 0x17D0F0, 0x180003, 0x189A58, 0x700804, 0x700F80,
+};
+
+} // namespace
+
+UnicodeClass unicode_class(uint32_t cp) {
+    if (cp < 0x80) {
+        if ((cp | 0x20) >= 'a' && (cp | 0x20) <= 'z') {
+            return cp <= 'Z' ? UnicodeClass::UPPER : UnicodeClass::LOWER;
+        }
+        return cp >= '0' && cp <= '9' ? UnicodeClass::NUMBER : UnicodeClass::OTHER;
+    }
+
+    const uint32_t key = (cp << 3) | 7;
+    const auto it = std::upper_bound(std::begin(UNICODE_RANGES), std::end(UNICODE_RANGES), key);
+    if (it == std::begin(UNICODE_RANGES)) return UnicodeClass::OTHER;
+    return static_cast<UnicodeClass>(*std::prev(it) & 7);
+}
+
+} // namespace engine
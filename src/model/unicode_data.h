@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine {
+
+// Classe geral do Unicode reduzida ao que a pré-tokenização distingue
+enum class UnicodeClass : uint8_t {
+    OTHER = 0,
+    UPPER = 1,     // Lu, Lt
+    LOWER = 2,     // Ll
+    LETTER = 3,    // Lm, Lo (sem caixa)
+    MARK = 4,      // Mn, Mc, Me
+    NUMBER = 5     // Nd, Nl, No
+};
+
+// Busca binária numa tabela de intervalos (Unicode 14.0)
+UnicodeClass unicode_class(uint32_t cp);
+
+// Propriedade White_Space
+inline bool unicode_is_space(uint32_t cp) {
+    if (cp < 0x80) return cp == ' ' || (cp >= 0x09 && cp <= 0x0D);
+    return cp == 0x85 || cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A) ||
+           cp == 0x2028 || cp == 0x2029 || cp == 0x202F || cp == 0x205F || cp == 0x3000;
+}
+
+} // namespace engine
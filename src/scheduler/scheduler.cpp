@@ -2,50 +2,184 @@
 #include "core/execution_plan.h"
 #include "core/engine.h"
 #include "model/quantization_utils.h"
+#include "metrics/metrics_registry.h"
+#include "core/logger.h"
 
-#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <exception>
 #include <vector>
 
 namespace engine {
 
+namespace {
+
+struct SchedulerMetrics {
+    Counter& submitted;
+    Counter& rejected;
+    Counter& finished;
+    Gauge& queue_depth;
+    Gauge& kv_reserved;
+    Gauge& kv_budget;
+    Histogram& batch_size;
+    Histogram& job_seconds;
+};
+
+SchedulerMetrics& scheduler_metrics() {
+    auto& r = MetricsRegistry::global();
+    static SchedulerMetrics m{
+        r.counter("engine_scheduler_jobs_submitted", "Jobs accepted into the queue"),
+        r.counter("engine_scheduler_jobs_rejected", "Jobs refused by admission control"),
+        r.counter("engine_scheduler_jobs_finished", "Jobs run to completion"),
+        r.gauge("engine_scheduler_queue_depth", "Jobs waiting in the queue"),
+        r.gauge("engine_scheduler_kv_reserved_bytes", "KV cache bytes reserved by dispatched jobs"),
+        r.gauge("engine_scheduler_kv_budget_bytes", "KV cache bytes available to admission control"),
+        r.histogram("engine_scheduler_batch_size", "Jobs per compatible batch",
+                    {1, 2, 4, 8, 16, 32, 64}),
+        r.histogram("engine_scheduler_job_seconds", "Wall time per job",
+                    MetricsRegistry::latency_buckets()),
+    };
+    return m;
+}
+
+} // namespace
+
 Scheduler::Scheduler() = default;
 
-uint64_t Scheduler::submit(const core::ExecutionPlan& plan, int priority) {
+Scheduler::Scheduler(SchedulerConfig config) : config_(std::move(config)) {
+    init_admission();
+}
+
+void Scheduler::init_admission() {
+    if (config_.memory_budget_bytes == 0 && config_.kv_budget_bytes == 0) return;
+
+    try {
+        estimate_ = GgufInspector::estimate(config_.model_path, GgufEstimateOptions{});
+    } catch (const std::exception& e) {
+        ENGINE_LOG_WARN("scheduler", "no memory estimate for " << config_.model_path
+                        << ": " << e.what() << " (admission control off)");
+        return;
+    }
+
+    const GgufEstimate& e = *estimate_;
+    const uint64_t fixed = e.weights_bytes + e.dequant_bytes + e.scratch_bytes;
+
+    kv_per_token_ = e.kv_bytes / e.context;
+    kv_budget_ = config_.kv_budget_bytes;
+    if (kv_budget_ == 0) {
+        kv_budget_ = config_.memory_budget_bytes > fixed ? config_.memory_budget_bytes - fixed : 0;
+    }
+    admission_ = true;
+
+    scheduler_metrics().kv_budget.set(static_cast<double>(kv_budget_));
+
+    ENGINE_LOG_INFO("scheduler", "admission: KV budget " << kv_budget_ << " bytes ("
+                    << kv_per_token_ << " bytes/token, model fixed " << fixed << " bytes)");
+}
+
+bool Scheduler::fits(const Job& job) const {
+    return !admission_ || kv_reserved_ + job.kv_bytes <= kv_budget_;
+}
+
+void Scheduler::reserve(const Job& job) {
+    kv_queued_ -= job.kv_bytes;
+    kv_reserved_ += job.kv_bytes;
+    scheduler_metrics().kv_reserved.set(static_cast<double>(kv_reserved_));
+}
+
+void Scheduler::release(const Job& job, double seconds) {
+    kv_reserved_ -= job.kv_bytes;
+    scheduler_metrics().kv_reserved.set(static_cast<double>(kv_reserved_));
+
+    job_seconds_ema_ = job_seconds_ema_ > 0.0 ? 0.8 * job_seconds_ema_ + 0.2 * seconds : seconds;
+}
+
+Admission Scheduler::try_submit(const core::ExecutionPlan& plan, int priority) {
     Job job;
     job.id = next_id_++;
     job.plan = plan;
     job.priority = priority;
     job.status = JobStatus::Pending;
 
+    Admission a;
+
+    if (admission_) {
+        const uint64_t tokens = std::min<uint64_t>(
+            uint64_t(plan.prompt_tokens) + plan.max_tokens, estimate_->context
+        );
+        job.kv_bytes = tokens * kv_per_token_;
+
+        if (job.kv_bytes > kv_budget_) {
+            a.reason = "KV footprint " + std::to_string(job.kv_bytes)
+                     + " bytes exceeds the budget even on an idle node";
+        } else if (config_.policy == AdmissionPolicy::REJECT &&
+                   kv_reserved_ + kv_queued_ + job.kv_bytes > kv_budget_) {
+            // Jobs rodam em sequência: espera ~ a fila atual drenar
+            const double per_job = job_seconds_ema_ > 0.0 ? job_seconds_ema_ : 1.0;
+            a.retry_after_s = per_job * double(queue_.size() + 1);
+            a.reason = "KV budget full";
+        }
+
+        if (!a.reason.empty()) {
+            scheduler_metrics().rejected.inc();
+            ENGINE_LOG_WARN("scheduler", "job rejected id=" << job.id << ": " << a.reason
+                            << (a.retry_after_s > 0.0
+                                    ? " (retry after " + std::to_string(a.retry_after_s) + " s)"
+                                    : std::string()));
+            return a;
+        }
+    }
+
+    kv_queued_ += job.kv_bytes;
     queue_.push(job);
 
-    std::cerr
-        << "[scheduler] job submitted id=" << job.id
-        << " priority=" << job.priority << "\n";
+    scheduler_metrics().submitted.inc();
+    scheduler_metrics().queue_depth.set(static_cast<double>(queue_.size()));
 
-    return job.id;
-}
+    ENGINE_LOG_INFO("scheduler", "job submitted id=" << job.id
+                    << " priority=" << job.priority
+                    << " kv_bytes=" << job.kv_bytes);
 
-bool Scheduler::run_next() {
-    if (queue_.empty()) {
-        return false;
-    }
+    a.id = job.id;
+    a.accepted = true;
+    return a;
+}
 
-    Job job = queue_.top();
-    queue_.pop();
+uint64_t Scheduler::submit(const core::ExecutionPlan& plan, int priority) {
+    return try_submit(plan, priority).id;
+}
 
+double Scheduler::run_job(Job& job) {
     job.status = JobStatus::Running;
 
-    std::cerr
-        << "[scheduler] running job id=" << job.id
-        << " priority=" << job.priority << "\n";
+    ENGINE_LOG_INFO("scheduler", "running job id=" << job.id
+                    << " priority=" << job.priority);
 
+    const auto t0 = std::chrono::steady_clock::now();
     Engine engine;
-    engine.run("model.gguf", job.plan);
+    engine.run(config_.model_path, job.plan);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
 
     job.status = JobStatus::Finished;
-    std::cerr << "[scheduler] job finished id=" << job.id << "\n";
 
+    scheduler_metrics().finished.inc();
+    scheduler_metrics().job_seconds.observe(seconds);
+    ENGINE_LOG_INFO("scheduler", "job finished id=" << job.id);
+    return seconds;
+}
+
+bool Scheduler::run_next() {
+    if (queue_.empty() || !fits(queue_.top())) {
+        return false;
+    }
+
+    Job job = queue_.top();
+    queue_.pop();
+    reserve(job);
+
+    scheduler_metrics().queue_depth.set(static_cast<double>(queue_.size()));
+
+    release(job, run_job(job));
     return true;
 }
 
@@ -54,42 +188,44 @@ bool Scheduler::compatible(const Job& a, const Job& b) const {
 }
 
 size_t Scheduler::run_batch() {
-    if (queue_.empty()) {
+    if (queue_.empty() || !fits(queue_.top())) {
         return 0;
     }
 
     Job first = queue_.top();
     queue_.pop();
+    reserve(first);
 
     std::vector<Job> batch;
     batch.push_back(first);
 
+    // Sequências concorrentes: cada uma precisa caber no KV que sobrou
     while (!queue_.empty()) {
         const Job& next = queue_.top();
-        if (!compatible(first, next)) {
+        if (!compatible(first, next) || !fits(next)) {
             break;
         }
+        reserve(next);
         batch.push_back(next);
         queue_.pop();
     }
 
-    std::cerr
-        << "[scheduler] running batch size=" << batch.size()
-        << " quant=" << quant_to_string(first.plan.quantization)
-        << "\n";
-
-    for (auto& job : batch) {
-        job.status = JobStatus::Running;
-
-        std::cerr
-            << "[scheduler] running job id=" << job.id
-            << " priority=" << job.priority << "\n";
+    scheduler_metrics().queue_depth.set(static_cast<double>(queue_.size()));
+    scheduler_metrics().batch_size.observe(static_cast<double>(batch.size()));
 
-        Engine engine;
-        engine.run("model.gguf", job.plan);
+    ENGINE_LOG_INFO("scheduler", "running batch size=" << batch.size()
+                    << " quant=" << quant_to_string(first.plan.quantization)
+                    << " kv_reserved=" << kv_reserved_);
 
-        job.status = JobStatus::Finished;
-        std::cerr << "[scheduler] job finished id=" << job.id << "\n";
+    // As reservas do lote valem até o fim do lote inteiro, como se as
+    // sequências rodassem juntas (hoje rodam uma após a outra)
+    std::vector<double> seconds;
+    seconds.reserve(batch.size());
+    for (auto& job : batch) {
+        seconds.push_back(run_job(job));
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        release(batch[i], seconds[i]);
     }
 
     return batch.size();
@@ -3,8 +3,11 @@
 #include <queue>
 #include <vector>
 #include <atomic>
+#include <optional>
+#include <string>
 
 #include "core/execution_plan.h"
+#include "model/gguf_inspector.h"
 
 namespace core {
     struct ExecutionPlan;
@@ -25,6 +28,7 @@ struct Job {
     core::ExecutionPlan plan;
     JobStatus status = JobStatus::Pending;
     int exit_code = -1;
+    uint64_t kv_bytes = 0;  // reserva de KV: (prompt + max_tokens) × bytes/token
 };
 
 struct JobCompare {
@@ -36,12 +40,58 @@ struct JobCompare {
     }
 };
 
+enum class AdmissionPolicy {
+    QUEUE,   // sem espaço agora: fica na fila até reservas serem liberadas
+    REJECT   // sem espaço agora: recusa com retry_after_s
+};
+
+/**
+ * Admissão por memória de KV.
+ *
+ * Cada job reserva (prompt_tokens + max_tokens) × bytes de KV por token,
+ * com bytes/token e o custo fixo do modelo estimados do cabeçalho GGUF
+ * (GgufInspector). A reserva é feita ao despachar e liberada quando o job
+ * (run_next) ou o lote inteiro (run_batch) termina; o despacho para no
+ * primeiro job que não cabe (sem furar a fila). prompt_tokens vem do plano
+ * (no CLI: --prompt tokenizado ou --prompt-tokens).
+ *
+ * Os lotes ainda rodam de forma síncrona: entre duas chamadas de run_batch
+ * todas as reservas já foram liberadas, então QUEUE só limita o tamanho de
+ * cada lote (o resto fica para o próximo) e nunca faz um job esperar por
+ * memória. A espera de fato só aparece quando jobs rodarem em paralelo.
+ *
+ * Orçamento de KV: kv_budget_bytes, ou memory_budget_bytes menos o custo
+ * fixo (pesos, dequant, scratch). Ambos 0 = sem controle de admissão.
+ * Job que não cabe nem com o nó vazio é sempre rejeitado.
+ */
+struct SchedulerConfig {
+    std::string model_path = "model.gguf";
+
+    uint64_t memory_budget_bytes = 0;
+    uint64_t kv_budget_bytes = 0;
+    AdmissionPolicy policy = AdmissionPolicy::QUEUE;
+};
+
+struct Admission {
+    uint64_t id = 0;             // 0 = rejeitado
+    bool accepted = false;
+    double retry_after_s = 0.0;  // dica para o cliente (0 = não adianta repetir)
+    std::string reason;
+};
+
 class Scheduler {
 public:
     Scheduler();
+    explicit Scheduler(SchedulerConfig config);
+
+    Admission try_submit(const core::ExecutionPlan& plan, int priority = 0);
 
+    // Retorna o id do job, ou 0 se a admissão o rejeitar
     uint64_t submit(const core::ExecutionPlan& plan, int priority = 0);
 
+    uint64_t kv_reserved_bytes() const { return kv_reserved_; }
+    uint64_t kv_budget_bytes() const { return kv_budget_; }
+
     bool run_next();
     size_t run_batch();
     bool empty() const;
@@ -50,6 +100,23 @@ private:
     std::priority_queue<Job, std::vector<Job>, JobCompare> queue_;
     std::atomic<uint64_t> next_id_{1};
 
+    SchedulerConfig config_;
+    std::optional<GgufEstimate> estimate_;  // do modelo (cabeçalho), na construção
+
+    // Admissão (bytes de KV)
+    bool admission_ = false;
+    uint64_t kv_budget_ = 0;
+    uint64_t kv_per_token_ = 0;
+    uint64_t kv_reserved_ = 0;     // jobs despachados e ainda rodando
+    uint64_t kv_queued_ = 0;       // jobs na fila
+    double job_seconds_ema_ = 0.0;
+
+    void init_admission();
+    bool fits(const Job& job) const;
+    void reserve(const Job& job);
+    void release(const Job& job, double seconds);
+    double run_job(Job& job);  // segundos de parede
+
     bool compatible(const Job& a, const Job& b) const;
 };
 
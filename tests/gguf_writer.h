@@ -0,0 +1,70 @@
+#pragma once
+
+// GGUF v3 só com metadados (nenhum tensor), para montar vocabulários de
+// teste sem arquivo de modelo.
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace engine::test {
+
+class GgufWriter {
+public:
+    void str(const std::string& key, const std::string& v) {
+        header(key, 8);
+        string(v);
+    }
+    void u32(const std::string& key, uint32_t v) {
+        header(key, 4);
+        pod(v);
+    }
+    void strings(const std::string& key, const std::vector<std::string>& v) {
+        array(key, 8, v.size());
+        for (const auto& s : v) string(s);
+    }
+    void floats(const std::string& key, const std::vector<float>& v) {
+        array(key, 6, v.size());
+        for (float f : v) pod(f);
+    }
+    void ints(const std::string& key, const std::vector<int32_t>& v) {
+        array(key, 5, v.size());
+        for (int32_t i : v) pod(i);
+    }
+
+    void save(const std::filesystem::path& p) const {
+        std::ofstream f(p, std::ios::binary | std::ios::trunc);
+        const uint32_t version = 3;
+        const uint64_t n_tensors = 0;
+        f.write("GGUF", 4);
+        f.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        f.write(reinterpret_cast<const char*>(&n_tensors), sizeof(n_tensors));
+        f.write(reinterpret_cast<const char*>(&n_kv_), sizeof(n_kv_));
+        f.write(kv_.data(), static_cast<std::streamsize>(kv_.size()));
+    }
+
+private:
+    std::string kv_;
+    uint64_t n_kv_ = 0;
+
+    template <typename T>
+    void pod(T v) { kv_.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+    void string(const std::string& s) {
+        pod(static_cast<uint64_t>(s.size()));
+        kv_ += s;
+    }
+    void header(const std::string& key, uint32_t type) {
+        ++n_kv_;
+        string(key);
+        pod(type);
+    }
+    void array(const std::string& key, uint32_t elem_type, size_t n) {
+        header(key, 9);
+        pod(elem_type);
+        pod(static_cast<uint64_t>(n));
+    }
+};
+
+} // namespace engine::test
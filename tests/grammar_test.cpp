@@ -0,0 +1,149 @@
+// GrammarMatcher num vocabulário pequeno: máscara de tokens por estado,
+// accept() e EOS só quando a gramática está completa.
+
+#include "model/grammar.h"
+#include "model/tokenizer.h"
+#include "gguf_writer.h"
+#include "test_util.h"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using engine::Grammar;
+using engine::GrammarMatcher;
+using engine::SimpleTokenizer;
+using engine::VocabTrie;
+using engine::test::GgufWriter;
+using engine::test::check;
+using engine::test::finish;
+
+namespace {
+
+// <unk> <s> </s> e peças de texto; "▁a" produz " a"
+enum Token : int32_t {
+    UNK, BOS, EOS, OPEN, CLOSE, PAIR, A, B, AB, BA, X, SPACE_A, N_VOCAB
+};
+
+const std::vector<std::string> PIECES = {
+    "<unk>", "<s>", "</s>", "(", ")", "()", "a", "b", "ab", "ba", "x", "▁a"
+};
+
+fs::path write_vocab(const fs::path& dir) {
+    std::vector<int32_t> types(PIECES.size(), 1);
+    types[UNK] = 2;
+    types[BOS] = 3;
+    types[EOS] = 3;
+
+    GgufWriter w;
+    w.str("tokenizer.ggml.model", "llama");
+    w.strings("tokenizer.ggml.tokens", PIECES);
+    w.floats("tokenizer.ggml.scores", std::vector<float>(PIECES.size(), 0.0f));
+    w.ints("tokenizer.ggml.token_type", types);
+    w.u32("tokenizer.ggml.bos_token_id", BOS);
+    w.u32("tokenizer.ggml.eos_token_id", EOS);
+    w.u32("tokenizer.ggml.unknown_token_id", UNK);
+
+    const fs::path p = dir / "vocab.gguf";
+    w.save(p);
+    return p;
+}
+
+// Tokens que apply() deixa finitos; confere também a contagem devolvida
+std::set<int32_t> allowed(GrammarMatcher& m, int n = N_VOCAB) {
+    std::vector<float> logits(n, 1.0f);
+    const int count = m.apply(logits.data(), n);
+
+    std::set<int32_t> out;
+    for (int i = 0; i < n; ++i) {
+        if (std::isfinite(logits[i])) out.insert(i);
+    }
+    check(count == static_cast<int>(out.size()), "apply() conta os permitidos");
+    return out;
+}
+
+void test_matcher(const std::shared_ptr<const VocabTrie>& trie) {
+    GrammarMatcher m(Grammar::parse("root ::= \"(\" [ab]* \")\""), trie, EOS);
+
+    // Início: só o que começa com "("; EOS não (incompleta)
+    check(allowed(m) == std::set<int32_t>{OPEN, PAIR}, "máscara inicial");
+    check(!m.complete(), "vazia não é sentença");
+    check(!m.accept(EOS), "EOS recusado antes de completar");
+    check(!m.accept(X), "token fora da gramática recusado");
+    check(!m.accept(BOS), "especial sem texto recusado");
+    check(allowed(m) == std::set<int32_t>{OPEN, PAIR}, "recusa não muda o estado");
+
+    // Dentro dos parênteses: letras (também em token de 2 bytes) e ")"
+    check(m.accept(OPEN), "accept (");
+    check(allowed(m) == std::set<int32_t>{CLOSE, A, B, AB, BA}, "máscara após (");
+    check(m.accept(AB) && m.accept(BA) && m.accept(A), "accept ab ba a");
+    check(!m.accept(SPACE_A), "espaço recusado");
+    check(!m.complete(), "incompleta antes de )");
+
+    // Completa: só EOS
+    check(m.accept(CLOSE), "accept )");
+    check(m.complete(), "completa após )");
+    check(allowed(m) == std::set<int32_t>{EOS}, "só EOS quando completa");
+    check(m.accept(EOS), "EOS aceito quando completa");
+
+    // Token que atravessa estados: "()" de uma vez
+    m.reset();
+    check(m.accept(PAIR) && m.complete(), "() completa num token");
+
+    // reset() mantém o cache: o estado inicial já tem máscara
+    m.reset();
+    const uint64_t hits = m.cache_hits();
+    allowed(m);
+    check(m.cache_hits() == hits + 1, "máscara do estado inicial vem do cache");
+
+    // Logits além do vocabulário da trie ficam -inf
+    check(allowed(m, N_VOCAB + 4) == std::set<int32_t>{OPEN, PAIR}, "fora do vocabulário é proibido");
+}
+
+void test_alternatives(const std::shared_ptr<const VocabTrie>& trie) {
+    // EOS convive com continuações quando a sentença pode terminar ou seguir
+    GrammarMatcher m(Grammar::parse("root ::= \"a\" | \"ab\" \"x\"?"), trie, EOS);
+
+    check(allowed(m) == std::set<int32_t>{A, AB}, "alternativas no início");
+    check(m.accept(AB), "accept ab");
+    check(m.complete(), "ab já é sentença");
+    check(allowed(m) == std::set<int32_t>{X, EOS}, "x opcional ou EOS");
+    check(m.accept(X) && m.complete() && allowed(m) == std::set<int32_t>{EOS}, "abx");
+}
+
+} // namespace
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() /
+                         ("grammar_test_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+
+    SimpleTokenizer tok;
+    check(tok.load_from_gguf(write_vocab(dir).string()), "load vocab");
+    check(tok.token_piece(SPACE_A) == " a", "token_piece de ▁a");
+
+    const auto trie = std::make_shared<const VocabTrie>(tok, static_cast<uint32_t>(tok.vocab_size()));
+    test_matcher(trie);
+    test_alternatives(trie);
+
+    for (const char* bad : {"root ::= undefined", "root ::= root \"a\"", "root ::= \"a"}) {
+        bool threw = false;
+        try {
+            Grammar::parse(bad);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        check(threw, std::string("gramática inválida: ") + bad);
+    }
+
+    fs::remove_all(dir);
+
+    return finish("grammar_test");
+}
@@ -0,0 +1,121 @@
+// Teste do PowerLinux contra uma árvore sysfs falsa (roda sem RAPL no CI).
+
+#include "metrics/power_linux.h"
+#include "test_util.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using engine::PowerLinux;
+using engine::test::check;
+using engine::test::finish;
+
+namespace {
+
+bool near(double a, double b) {
+    return std::abs(a - b) < 1e-9;
+}
+
+void write_file(const fs::path& p, const std::string& content) {
+    std::ofstream f(p, std::ios::trunc);
+    f << content << "\n";
+}
+
+void make_zone(const fs::path& root, const std::string& zone, const std::string& name,
+               uint64_t energy_uj, uint64_t max_range_uj) {
+    const fs::path dir = root / zone;
+    fs::create_directories(dir);
+    write_file(dir / "name", name);
+    write_file(dir / "energy_uj", std::to_string(energy_uj));
+    write_file(dir / "max_energy_range_uj", std::to_string(max_range_uj));
+}
+
+void set_energy(const fs::path& root, const std::string& zone, uint64_t energy_uj) {
+    write_file(root / zone / "energy_uj", std::to_string(energy_uj));
+}
+
+const PowerLinux::DomainReading* find(const std::vector<PowerLinux::DomainReading>& rs,
+                                      const std::string& zone) {
+    for (const auto& r : rs) {
+        if (r.domain->zone == zone) return &r;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+int main() {
+    const fs::path root = fs::temp_directory_path() /
+        ("engine_powercap_" + std::to_string(::getpid()));
+    fs::remove_all(root);
+
+    constexpr uint64_t RANGE = 1'000'000;  // 1 J, para forçar wraparound
+
+    // Dois sockets, cada um com core/uncore/dram; mais psys e uma zona MMIO
+    make_zone(root, "intel-rapl:0",   "package-0", 100, RANGE);
+    make_zone(root, "intel-rapl:0:0", "core",      50,  RANGE);
+    make_zone(root, "intel-rapl:0:1", "uncore",    10,  RANGE);
+    make_zone(root, "intel-rapl:0:2", "dram",      900'000, RANGE);
+    make_zone(root, "intel-rapl:1",   "package-1", 200, RANGE);
+    make_zone(root, "intel-rapl:1:0", "dram",      300, RANGE);
+    make_zone(root, "intel-rapl:2",   "psys",      0,   RANGE);
+    make_zone(root, "intel-rapl-mmio:0", "package-0", 0, RANGE);
+    fs::create_directories(root / "powercap");  // entrada sem ':' (ignorada)
+
+    PowerLinux power;
+    check(power.init(root.string()), "init on fake tree");
+    check(power.domains().size() == 7, "7 domains (mmio ignored)");
+
+    const auto& ds = power.domains();
+    check(ds[0].zone == "intel-rapl:0" && ds[0].kind == PowerLinux::DomainKind::PACKAGE,
+          "package-0 classified");
+    check(ds[3].kind == PowerLinux::DomainKind::DRAM && ds[3].package == 0, "dram socket 0");
+    check(ds[5].kind == PowerLinux::DomainKind::DRAM && ds[5].package == 1, "dram socket 1");
+    check(ds[6].kind == PowerLinux::DomainKind::PSYS, "psys classified");
+    check(power.energy_path() == "package-0+dram-0+package-1+dram-1", "total = packages + dram");
+
+    // Acumulado começa em zero no init()
+    check(near(*power.read_joules(), 0.0), "total starts at zero");
+
+    // Package 0: +0.5 J; core: +0.2 J (não entra no total);
+    // DRAM 0 dá a volta: 900000 → 1000000 → 50000 = +0.15 J
+    set_energy(root, "intel-rapl:0", 500'100);
+    set_energy(root, "intel-rapl:0:0", 200'050);
+    set_energy(root, "intel-rapl:0:2", 50'000);
+    set_energy(root, "intel-rapl:1", 100'200);
+
+    const auto total = power.read_joules();
+    check(total.has_value(), "read_joules after update");
+    check(near(*total, 0.5 + 0.15 + 0.1), "total with dram wraparound");
+
+    const auto rs = power.read_domains();
+    check(near(find(rs, "intel-rapl:0:0")->joules, 0.2), "core delta");
+    check(near(find(rs, "intel-rapl:0:2")->joules, 0.15), "dram wraparound delta");
+    check(near(find(rs, "intel-rapl:1:0")->joules, 0.0), "dram-1 unchanged");
+
+    // Segunda volta do package 1: 100200 → 1000000 → 100 = +0.8999 J
+    set_energy(root, "intel-rapl:1", 100);
+    check(near(*power.read_joules(), 0.5 + 0.15 + 0.1 + 0.8999), "package-1 wraparound");
+
+    // Sem package nem dram: cai para psys
+    const fs::path root2 = root.string() + "_psys";
+    fs::remove_all(root2);
+    make_zone(root2, "intel-rapl:0", "psys", 0, RANGE);
+    PowerLinux psys;
+    check(psys.init(root2.string()), "init psys-only tree");
+    check(psys.energy_path() == "psys", "psys fallback");
+
+    // Raiz inexistente
+    PowerLinux none;
+    check(!none.init((root / "missing").string()), "missing root");
+    check(!none.read_joules().has_value(), "no reading without domains");
+
+    fs::remove_all(root);
+    fs::remove_all(root2);
+
+    return finish("power_linux_test");
+}
@@ -0,0 +1,129 @@
+// PreTokenizer contra os cortes das expressões regulares de referência
+// (gpt2, llama3, qwen2, tekken) em textos fixos.
+
+#include "model/pretokenizer.h"
+#include "test_util.h"
+
+#include <string>
+#include <vector>
+
+using engine::PreTokenizer;
+using engine::PreTokenizerType;
+using engine::test::check;
+using engine::test::finish;
+
+namespace {
+
+struct Golden {
+    std::string text;
+    std::vector<std::string> pieces;
+};
+
+std::vector<std::string> split(const PreTokenizer& pre, const std::string& text) {
+    std::vector<std::string> out;
+    for (size_t pos = 0; pos < text.size();) {
+        const size_t end = pre.next(text, pos);
+        if (end <= pos || end > text.size()) {
+            out.push_back("<parou em " + std::to_string(pos) + ">");
+            break;
+        }
+        out.push_back(text.substr(pos, end - pos));
+        pos = end;
+    }
+    return out;
+}
+
+std::string show(const std::vector<std::string>& pieces) {
+    std::string s;
+    for (const auto& p : pieces) s += (s.empty() ? "[" : "|") + p;
+    return s + "]";
+}
+
+void check_goldens(PreTokenizerType type, const std::vector<Golden>& goldens) {
+    const PreTokenizer pre(type);
+    const std::string name = engine::pre_tokenizer_name(type);
+    for (const auto& g : goldens) {
+        const std::vector<std::string> pieces = split(pre, g.text);
+        check(pieces == g.pieces, name + " \"" + g.text + "\": " + show(pieces) +
+                                  " != " + show(g.pieces));
+    }
+}
+
+} // namespace
+
+int main() {
+    // Contrações só em minúscula; o último espaço antes de \S vai para o pedaço seguinte
+    check_goldens(PreTokenizerType::GPT2, {
+        {"Hello world", {"Hello", " world"}},
+        {"I'm here, they'LL see", {"I", "'m", " here", ",", " they", "'", "LL", " see"}},
+        {"12345 abc", {"12345", " abc"}},
+        {"  leading\n\n  trailing  ", {" ", " leading", "\n\n ", " trailing", "  "}},
+        {"a\r\nb", {"a", "\r", "\n", "b"}},
+        {"HelloWORLDFoo bar", {"HelloWORLDFoo", " bar"}},
+        {"path/to\n/file", {"path", "/", "to", "\n", "/", "file"}},
+        {"café naïve 日本語", {"café", " naïve", " 日本語"}},
+        {"x = y+1;\t// ok!?", {"x", " =", " y", "+", "1", ";", "\t", "//", " ok", "!?"}},
+        {"ÀBÇdé Ǆa", {"ÀBÇdé", " Ǆa"}},
+        {"ok.//\n\nx", {"ok", ".//", "\n", "\n", "x"}},
+        {"e\u0301te\u0301", {"e", "\u0301", "te", "\u0301"}},
+        {"  ", {"  "}},
+    });
+
+    // Contrações sem caixa, até 3 dígitos, \r\n juntos, pontuação leva o prefixo
+    check_goldens(PreTokenizerType::LLAMA3, {
+        {"Hello world", {"Hello", " world"}},
+        {"I'm here, they'LL see", {"I", "'m", " here", ",", " they", "'LL", " see"}},
+        {"12345 abc", {"123", "45", " abc"}},
+        {"  leading\n\n  trailing  ", {" ", " leading", "\n\n", " ", " trailing", "  "}},
+        {"a\r\nb", {"a", "\r\n", "b"}},
+        {"HelloWORLDFoo bar", {"HelloWORLDFoo", " bar"}},
+        {"path/to\n/file", {"path", "/to", "\n", "/file"}},
+        {"café naïve 日本語", {"café", " naïve", " 日本語"}},
+        {"x = y+1;\t// ok!?", {"x", " =", " y", "+", "1", ";", "\t", "//", " ok", "!?"}},
+        {"ÀBÇdé Ǆa", {"ÀBÇdé", " Ǆa"}},
+        {"ok.//\n\nx", {"ok", ".//\n\n", "x"}},
+        {"e\u0301te\u0301", {"e", "\u0301te", "\u0301"}},
+        {"  ", {"  "}},
+    });
+
+    // Como llama3, um dígito por pedaço
+    check_goldens(PreTokenizerType::QWEN2, {
+        {"Hello world", {"Hello", " world"}},
+        {"I'm here, they'LL see", {"I", "'m", " here", ",", " they", "'LL", " see"}},
+        {"12345 abc", {"1", "2", "3", "4", "5", " abc"}},
+        {"  leading\n\n  trailing  ", {" ", " leading", "\n\n", " ", " trailing", "  "}},
+        {"a\r\nb", {"a", "\r\n", "b"}},
+        {"HelloWORLDFoo bar", {"HelloWORLDFoo", " bar"}},
+        {"path/to\n/file", {"path", "/to", "\n", "/file"}},
+        {"café naïve 日本語", {"café", " naïve", " 日本語"}},
+        {"x = y+1;\t// ok!?", {"x", " =", " y", "+", "1", ";", "\t", "//", " ok", "!?"}},
+        {"ÀBÇdé Ǆa", {"ÀBÇdé", " Ǆa"}},
+        {"ok.//\n\nx", {"ok", ".//\n\n", "x"}},
+        {"e\u0301te\u0301", {"e", "\u0301te", "\u0301"}},
+        {"  ", {"  "}},
+    });
+
+    // Letras agrupadas por caixa; marcas combinantes contam como letra
+    check_goldens(PreTokenizerType::TEKKEN, {
+        {"Hello world", {"Hello", " world"}},
+        {"I'm here, they'LL see", {"I", "'m", " here", ",", " they", "'LL", " see"}},
+        {"12345 abc", {"1", "2", "3", "4", "5", " abc"}},
+        {"  leading\n\n  trailing  ", {" ", " leading", "\n\n", " ", " trailing", "  "}},
+        {"a\r\nb", {"a", "\r\n", "b"}},
+        {"HelloWORLDFoo bar", {"Hello", "WORLDFoo", " bar"}},
+        {"path/to\n/file", {"path", "/to", "\n", "/file"}},
+        {"café naïve 日本語", {"café", " naïve", " 日本語"}},
+        {"x = y+1;\t// ok!?", {"x", " =", " y", "+", "1", ";", "\t", "//", " ok", "!?"}},
+        {"ÀBÇdé Ǆa", {"ÀBÇdé", " Ǆa"}},
+        {"ok.//\n\nx", {"ok", ".//\n\n", "x"}},
+        {"e\u0301te\u0301", {"e\u0301te\u0301"}},
+        {"  ", {"  "}},
+    });
+
+    check(engine::pre_tokenizer_from_name("llama-bpe") == PreTokenizerType::LLAMA3, "llama-bpe");
+    check(engine::pre_tokenizer_from_name("deepseek-r1-qwen") == PreTokenizerType::QWEN2, "deepseek-r1-qwen");
+    check(engine::pre_tokenizer_from_name("default") == PreTokenizerType::GPT2, "default");
+    check(!engine::pre_tokenizer_from_name("bogus").has_value(), "nome desconhecido");
+
+    return finish("pretokenizer_test");
+}
@@ -0,0 +1,122 @@
+// StopStringMatcher: ocorrência atravessando chamadas de feed(), padrões
+// sobrepostos (termina primeiro; em empate, o mais longo) e held() no fim.
+
+#include "model/stop_strings.h"
+#include "test_util.h"
+
+#include <string>
+#include <vector>
+
+using engine::StopStringMatcher;
+using engine::test::check;
+using engine::test::finish;
+
+namespace {
+
+// Resultado de alimentar os pedaços em ordem: texto liberado, se parou e
+// o que ficou retido
+struct Run {
+    std::string out;
+    bool stopped = false;
+    std::string held;
+};
+
+Run feed_all(StopStringMatcher& m, const std::vector<std::string>& chunks) {
+    Run r;
+    for (const auto& c : chunks) {
+        if (m.feed(c, r.out)) {
+            r.stopped = true;
+            break;
+        }
+    }
+    r.held = m.held();
+    return r;
+}
+
+void test_split_across_feeds() {
+    StopStringMatcher m({"</end>"});
+
+    std::string out;
+    check(!m.feed("hello </e", out), "prefixo parcial não para");
+    check(out == "hello ", "libera só o que não pode iniciar o padrão");
+    check(m.held() == "</e", "retém o prefixo parcial");
+
+    check(m.feed("nd> tail", out), "ocorrência completada no feed seguinte");
+    check(out == "hello ", "nada do padrão nem do que vem depois sai");
+    check(m.held().empty(), "retido descartado após o match");
+
+    // Um byte por feed
+    m.reset();
+    const Run r = feed_all(m, {"a", "<", "/", "e", "n", "d", ">", "b"});
+    check(r.stopped && r.out == "a", "padrão byte a byte");
+}
+
+void test_false_prefix_is_released() {
+    StopStringMatcher m({"</end>"});
+
+    const Run r = feed_all(m, {"a</e", "x b"});
+    check(!r.stopped, "prefixo que diverge não para");
+    check(r.out == "a</ex b" && r.held.empty(), "prefixo que diverge é liberado");
+
+    // Prefixo que diverge mas recomeça o padrão: "<</end>"
+    StopStringMatcher m2({"</end>"});
+    const Run r2 = feed_all(m2, {"<<", "/end>"});
+    check(r2.stopped && r2.out == "<", "recomeço dentro do retido");
+}
+
+void test_overlapping_patterns() {
+    // O que termina primeiro vence, mesmo sendo mais curto e começando depois
+    {
+        StopStringMatcher m({"abcd", "bc"});
+        const Run r = feed_all(m, {"xab", "cd"});
+        check(r.stopped && r.out == "xa", "termina primeiro: bc antes de abcd");
+    }
+    // Mesmo fim: o mais longo (corta mais cedo)
+    {
+        StopStringMatcher m({"bc", "abc"});
+        const Run r = feed_all(m, {"xa", "bc"});
+        check(r.stopped && r.out == "x", "empate no fim: o mais longo");
+    }
+    // Padrão dentro de outro, achado pelo link de falha
+    {
+        StopStringMatcher m({"hello world", "lo w"});
+        const Run r = feed_all(m, {"say hel", "lo wor"});
+        check(r.stopped && r.out == "say hel", "padrão interno via falha");
+    }
+}
+
+void test_held_flush_at_end() {
+    StopStringMatcher m({"STOP", "<|im_end|>"});
+
+    const Run r = feed_all(m, {"foo ", "<|im", "_e"});
+    check(!r.stopped, "sem match");
+    check(r.out == "foo ", "retido não é liberado antes da hora");
+    check(r.held == "<|im_e", "held() tem o prefixo pendente");
+    check(r.out + r.held == "foo <|im_e", "out + held() = texto inteiro");
+
+    m.reset();
+    check(m.held().empty(), "reset() descarta o retido");
+
+    std::string out;
+    check(!m.feed("ST", out) && out.empty() && m.held() == "ST", "novo texto após reset");
+}
+
+void test_no_patterns() {
+    StopStringMatcher m({"", ""});
+    check(m.empty(), "padrões vazios são ignorados");
+
+    std::string out;
+    check(!m.feed("abc", out) && out == "abc" && m.held().empty(), "sem padrões repassa");
+}
+
+} // namespace
+
+int main() {
+    test_split_across_feeds();
+    test_false_prefix_is_released();
+    test_overlapping_patterns();
+    test_held_flush_at_end();
+    test_no_patterns();
+
+    return finish("stop_strings_test");
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// Apoio dos testes: cada teste é um executável que conta as falhas de
+// check() e devolve EXIT_FAILURE se houve alguma (sem framework).
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace engine::test {
+
+inline int g_failures = 0;
+
+inline void check(bool cond, const std::string& what) {
+    if (!cond) {
+        std::cerr << "FAIL: " << what << "\n";
+        ++g_failures;
+    }
+}
+
+// Código de saída do main (imprime "<name>: OK" se nada falhou)
+inline int finish(const char* name) {
+    if (g_failures == 0) std::cout << name << ": OK\n";
+    return g_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace engine::test
@@ -0,0 +1,181 @@
+// SimpleTokenizer contra ids de referência (implementação Python do SPM e
+// do BPE byte-level) num vocabulário pequeno, gravado como GGUF temporário.
+
+#include "model/tokenizer.h"
+#include "gguf_writer.h"
+#include "test_util.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using engine::SimpleTokenizer;
+using engine::test::GgufWriter;
+using engine::test::check;
+using engine::test::finish;
+
+namespace {
+
+struct Golden {
+    std::string text;
+    std::vector<int32_t> ids;
+};
+
+std::string show(const std::vector<int32_t>& ids) {
+    std::string s;
+    for (int32_t id : ids) s += (s.empty() ? "" : " ") + std::to_string(id);
+    return "[" + s + "]";
+}
+
+void check_goldens(const SimpleTokenizer& tok, const std::string& name,
+                   const std::vector<Golden>& goldens) {
+    for (const auto& g : goldens) {
+        const std::vector<int32_t> ids = tok.encode(g.text);
+        check(ids == g.ids, name + " encode \"" + g.text + "\": " + show(ids) +
+                            " != " + show(g.ids));
+    }
+}
+
+// SentencePiece (llama): <unk>, <s>, </s>, 256 bytes de fallback e peças
+// com score decrescente
+void test_spm(const fs::path& dir) {
+    const std::vector<std::string> pieces = {
+        "▁", "h", "e", "l", "o", "w", "r", "d", "▁h", "he", "ll", "llo",
+        "hello", "▁hello", "or", "▁w", "▁wor", "ld", "▁world", "▁d"
+    };
+
+    std::vector<std::string> tokens = {"<unk>", "<s>", "</s>"};
+    std::vector<int32_t> types = {2, 3, 3};
+    for (int b = 0; b < 256; ++b) {
+        char hex[8];
+        std::snprintf(hex, sizeof(hex), "<0x%02X>", b);
+        tokens.push_back(hex);
+        types.push_back(6);
+    }
+    std::vector<float> scores(tokens.size(), 0.0f);
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        tokens.push_back(pieces[i]);
+        types.push_back(1);
+        scores.push_back(-static_cast<float>(i));
+    }
+
+    GgufWriter w;
+    w.str("tokenizer.ggml.model", "llama");
+    w.strings("tokenizer.ggml.tokens", tokens);
+    w.floats("tokenizer.ggml.scores", scores);
+    w.ints("tokenizer.ggml.token_type", types);
+    w.u32("tokenizer.ggml.bos_token_id", 1);
+    w.u32("tokenizer.ggml.eos_token_id", 2);
+    w.u32("tokenizer.ggml.unknown_token_id", 0);
+    w.save(dir / "spm.gguf");
+
+    SimpleTokenizer tok;
+    check(tok.load_from_gguf((dir / "spm.gguf").string()), "load spm");
+    check(tok.vocab_size() == tokens.size(), "spm vocab size");
+
+    check_goldens(tok, "spm", {
+        {"hello world",     {1, 267, 261, 270, 277}},
+        {"hello",           {1, 267, 261, 270}},
+        {"held",            {1, 267, 261, 276}},
+        {"héllo wörld",     {1, 267, 198, 172, 270, 274, 198, 185, 265, 276}},
+        {"  hello  world ", {1, 259, 259, 267, 261, 270, 259, 277, 259}},
+        {"world hello",     {1, 277, 267, 261, 270}},
+    });
+
+    check(tok.decode(tok.encode("héllo wörld")).find("héllo wörld") != std::string::npos,
+          "spm round trip");
+}
+
+// Alfabeto bytes → unicode do GPT-2
+std::vector<std::string> byte_tokens() {
+    std::vector<int> bytes, cps;
+    for (int b = 0; b < 256; ++b) {
+        if ((b >= 33 && b <= 126) || (b >= 161 && b <= 172) || (b >= 174 && b <= 255)) {
+            bytes.push_back(b);
+            cps.push_back(b);
+        }
+    }
+    int extra = 0;
+    for (int b = 0; b < 256; ++b) {
+        if (std::find(bytes.begin(), bytes.end(), b) == bytes.end()) {
+            bytes.push_back(b);
+            cps.push_back(256 + extra++);
+        }
+    }
+
+    std::vector<std::string> out(256);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        const int cp = cps[i];
+        out[bytes[i]] = cp < 0x80 ? std::string(1, static_cast<char>(cp))
+                                  : std::string{static_cast<char>(0xC0 | (cp >> 6)),
+                                                static_cast<char>(0x80 | (cp & 0x3F))};
+    }
+    return out;
+}
+
+// BPE byte-level (gpt2, pré-tokenização do GPT-2): ids 0..255 = bytes e
+// depois o resultado de cada merge, na ordem. ", " nunca se junta: vírgula e
+// espaço caem em pedaços diferentes.
+void test_gpt2(const fs::path& dir) {
+    const std::vector<std::string> merges = {
+        "Ġ w", "o r", "Ġw or", "l d", "Ġwor ld", "h e", "l l", "he ll", "hell o",
+        "Ġ t", "Ġt he", "Ġ h", "Ġh ello", "Ġ 1", "1 2", "Ġ1 2", "e llo", ", Ġ", "' s"
+    };
+
+    std::vector<std::string> tokens = byte_tokens();
+    for (const auto& m : merges) {
+        const std::string t = m.substr(0, m.find(' ')) + m.substr(m.find(' ') + 1);
+        if (std::find(tokens.begin(), tokens.end(), t) == tokens.end()) tokens.push_back(t);
+    }
+    tokens.push_back("<|endoftext|>");
+
+    std::vector<int32_t> types(tokens.size(), 1);
+    types.back() = 3;
+    const uint32_t eot = static_cast<uint32_t>(tokens.size() - 1);
+
+    GgufWriter w;
+    w.str("tokenizer.ggml.model", "gpt2");
+    w.str("tokenizer.ggml.pre", "gpt2");
+    w.strings("tokenizer.ggml.tokens", tokens);
+    w.ints("tokenizer.ggml.token_type", types);
+    w.strings("tokenizer.ggml.merges", merges);
+    w.u32("tokenizer.ggml.bos_token_id", eot);
+    w.u32("tokenizer.ggml.eos_token_id", eot);
+    w.save(dir / "gpt2.gguf");
+
+    SimpleTokenizer tok;
+    check(tok.load_from_gguf((dir / "gpt2.gguf").string()), "load gpt2");
+    check(tok.vocab_size() == tokens.size(), "gpt2 vocab size");
+
+    check_goldens(tok, "gpt2", {
+        {"hello world",        {264, 260}},
+        {"Hello, world!",      {72, 101, 262, 111, 44, 260, 33}},
+        {"the hello's 123 12", {116, 261, 32, 264, 274, 271, 51, 271}},
+        {"héllo\n\n world",    {104, 195, 169, 262, 111, 10, 10, 260}},
+        {"hello  world ",      {264, 32, 260, 32}},
+        {"",                   {}},
+    });
+
+    const std::string text = "Hello, héllo's world!\n";
+    check(tok.decode(tok.encode(text)) == text, "gpt2 round trip");
+}
+
+} // namespace
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() /
+                         ("tokenizer_test_" + std::to_string(::getpid()));
+    fs::create_directories(dir);
+
+    test_spm(dir);
+    test_gpt2(dir);
+
+    fs::remove_all(dir);
+
+    return finish("tokenizer_test");
+}